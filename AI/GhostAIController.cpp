@@ -13,14 +13,25 @@
 #include "Kismet/KismetMathLibrary.h"
 #include "Math/UnitConversion.h"
 #include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
+#include "NetworkingPrototype/DebugMessages.h"
 #include "NetworkingPrototype/GameStates/QueriesUnlimitedGameState.h"
 #include "Perception/AISenseConfig_Sight.h"
 #include "NetworkingPrototype/Managers/SoundManager.h"
+#include "GhostDirectorSubsystem.h"
+#include "GhostAISense_Sight.h"
+#include "GhostStats.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogGhostAI);
 
 AGhostAIController::AGhostAIController()
 {
 	BehaviorTreeComponent = CreateDefaultSubobject<UBehaviorTreeComponent>(TEXT("Behavior Tree Component"));
+	// The Ghost Director ticks our behavior tree under its budget. The tree turns its own tick back on
+	// whenever it schedules an update, so it must never get a tick function registered to turn on.
+	BehaviorTreeComponent->PrimaryComponentTick.bCanEverTick = false;
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("Blackboard Component"));
+	GhostBlackboard = FGhostBlackboard(BlackboardComponent.Get());
 
 
 	/** AI PERCEPTION */
@@ -30,24 +41,25 @@ AGhostAIController::AGhostAIController()
 	
 }
 
-void AGhostAIController::Distract(ACharacter* Distractor) const
+void AGhostAIController::Distract(ACharacter* Distractor)
 {
 	// Only works if the ghost is haunting
-	if (BlackboardComponent && BlackboardComponent->GetValueAsBool(isHaunting))
+	if (GhostBlackboard.GetBool(E_GhostBlackboardKey::IsHaunting))
 	{
-		BlackboardComponent->SetValueAsBool(Distracted, true);
-		BlackboardComponent->SetValueAsObject(TargetPlayer, Distractor);
-		OwnerGhost->Server_PlayAudio(DistractSoundCue.Get());
-		BlackboardComponent->SetValueAsBool(Distracted, false);
+		GhostBlackboard.SetBool(E_GhostBlackboardKey::Distracted, true);
+		GhostBlackboard.SetObject(E_GhostBlackboardKey::TargetPlayer, Distractor);
+		if (GhostDirector)
+		{
+			GhostDirector->ClaimTarget(this, Distractor);
+		}
+		OwnerGhost->RecordPresentationEvent(E_GhostPresentationEvent::Distract, Distractor);
+		GhostBlackboard.SetBool(E_GhostBlackboardKey::Distracted, false);
 	}
 }
 
 void AGhostAIController::Undistract() const
 {
-	if(BlackboardComponent)
-	{
-		BlackboardComponent->SetValueAsBool(Distracted, false);
-	}
+	GhostBlackboard.SetBool(E_GhostBlackboardKey::Distracted, false);
 }
 
 void AGhostAIController::Stun(const float CustomDuration)
@@ -58,16 +70,16 @@ void AGhostAIController::Stun(const float CustomDuration)
 		if (CustomDuration == 0)
 		{
 			
-			Duration = BlackboardComponent->GetValueAsFloat(StunDuration);
+			Duration = GhostBlackboard.GetFloat(E_GhostBlackboardKey::StunDuration);
 		}
 		else
 		{
 			Duration = CustomDuration;
-			BlackboardComponent->SetValueAsFloat(StunDuration, CustomDuration);
+			GhostBlackboard.SetFloat(E_GhostBlackboardKey::StunDuration, CustomDuration);
 		}
 
-		OwnerGhost->Server_PlayAudio(StunSoundCue.Get());
-		BlackboardComponent->SetValueAsBool(Stunned, true);
+		OwnerGhost->RecordPresentationEvent(E_GhostPresentationEvent::Stun);
+		GhostBlackboard.SetBool(E_GhostBlackboardKey::Stunned, true);
 		// Set timer to reset Stun
 		FTimerHandle StunTimeHandle;
 		GetWorldTimerManager().SetTimer(
@@ -82,21 +94,52 @@ void AGhostAIController::Stun(const float CustomDuration)
 
 void AGhostAIController::StunReset() const
 {
-	if (BlackboardComponent)
+	GhostBlackboard.SetBool(E_GhostBlackboardKey::Stunned, false);
+}
+
+void AGhostAIController::ProcessSoundEvent(const FSoundEvent& SoundEvent)
+{
+	// The Sound Manager calls our handlers directly, this is for anything that wants to pass us a sound by hand
+	switch (SoundEvent.SoundType)
 	{
-		BlackboardComponent->SetValueAsBool(Stunned, false);
+	case E_SoundEventType::Voice:
+		OnVoiceHeard(SoundEvent);
+		break;
+
+	// If they are sprinting
+	// case E_SoundEventType::Footstep:
+	// 	if (SoundEvent.Intensity >= 15.0f)
+	// 	{
+	// 		// Example: Make AI look at the sound
+	// 		APawn* ControlledPawn = GetPawn();
+	// 		if (ControlledPawn)
+	// 		{
+	// 			FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(ControlledPawn->GetActorLocation(), SoundEvent.Location);
+	// 			ControlledPawn->SetActorRotation(LookAtRotation);
+	// 		}
+	//
+	// 		// If this noise was created by a character, chase them
+	// 		if (SoundEvent.Character)
+	// 		{
+	// 			Distract(SoundEvent.Character, 3.0f);
+	// 		}
+	// 	}
+	// 	break;
+
+	default:
+		break;
 	}
 }
 
-void AGhostAIController::ProcessSoundEvent(const FSoundEvent& SoundEvent)
+void AGhostAIController::OnVoiceHeard(const FSoundEvent& SoundEvent)
 {
-	UE_LOG(LogTemp, Log, TEXT("AI heard a sound: Type=%s, Intensity=%f, Location=%s"),
-	*SoundEvent.SoundType, SoundEvent.Intensity, *SoundEvent.Location.ToString());
+	// Verbose so the string formatting is skipped unless someone turns it on,
+	// voice events can come in many times a second
+	UE_LOG(LogGhostAI, Verbose, TEXT("AI heard a voice: Intensity=%f, Location=%s"),
+	SoundEvent.Intensity, *SoundEvent.Location.ToString());
 	
-	// Add custom logic for AI to react to sound:
-	
-	// If they are speaking and VERY loudly
-	if ((SoundEvent.SoundType == "Voice") && (SoundEvent.Intensity > 0.4f))
+	// If they are speaking VERY loudly
+	if (SoundEvent.Intensity > 0.4f)
 	{
 		// Example: Make AI look at the sound
 		APawn* ControlledPawn = GetPawn();
@@ -105,32 +148,20 @@ void AGhostAIController::ProcessSoundEvent(const FSoundEvent& SoundEvent)
 			FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(ControlledPawn->GetActorLocation(), SoundEvent.Location);
 			ControlledPawn->SetActorRotation(LookAtRotation);
 
-			// DISABLED FOR NOW need to playtest Intensity variance and figure out a way
-			// to consistently define a "loud" sound no matter what mic/gain and in build
-			// // If this noise was created by a character, chase them
-			// if (SoundEvent.Character)
-			// {
-			// 	Distract(SoundEvent.Character, 3.0f);
-			// }
+			// Voice intensity is calibrated against each player's own mic before it's sent,
+			// so "loud" means the same thing no matter what mic/gain they use
+			// If this noise was created by a character, chase them. Only when it's someone new and not
+			// too often, every distract claims the target and plays a presentation event to everyone.
+			const double CurrentTime = GetWorld()->GetTimeSeconds();
+			const bool bOnCooldown = LastVoiceDistractTime >= 0.0 && CurrentTime - LastVoiceDistractTime < VoiceDistractCooldown;
+			if (SoundEvent.Character && !bOnCooldown && GhostBlackboard.GetBool(E_GhostBlackboardKey::IsHaunting)
+				&& GhostBlackboard.GetObject(E_GhostBlackboardKey::TargetPlayer) != SoundEvent.Character)
+			{
+				LastVoiceDistractTime = CurrentTime;
+				Distract(SoundEvent.Character);
+			}
 		}
 	}
-	// If they are sprinting
-	// else if ((SoundEvent.SoundType == "Footstep") && (SoundEvent.Intensity >= 15.0f))
-	// {
-	// 	// Example: Make AI look at the sound
-	// 	APawn* ControlledPawn = GetPawn();
-	// 	if (ControlledPawn)
-	// 	{
-	// 		FRotator LookAtRotation = UKismetMathLibrary::FindLookAtRotation(ControlledPawn->GetActorLocation(), SoundEvent.Location);
-	// 		ControlledPawn->SetActorRotation(LookAtRotation);
-	// 	}
-	//
-	// 	// If this noise was created by a character, chase them
-	// 	if (SoundEvent.Character)
-	// 	{
-	// 		Distract(SoundEvent.Character, 3.0f);
-	// 	}
-	// }
 }
 
 bool AGhostAIController::IsActorSeen(const AActor* Actor) const
@@ -145,6 +176,12 @@ bool AGhostAIController::IsActorSeen(const AActor* Actor) const
 
 void AGhostAIController::StartHauntTimer(const float Duration)
 {
+	SCOPE_CYCLE_COUNTER(STAT_GhostHauntLoop);
+	GHOST_LOOP_TIMING_SCOPE(HauntLoopSeconds);
+	CSV_EVENT(Ghost, TEXT("HauntStart %s"), *GetName());
+	CSV_CUSTOM_STAT(Ghost, HauntsStarted, 1, ECsvCustomStatOp::Accumulate);
+	HauntStartTime = GetWorld()->GetTimeSeconds();
+
 	// Manifest Ghost
 	OwnerGhost->Manifest();
 	
@@ -155,21 +192,23 @@ void AGhostAIController::StartHauntTimer(const float Duration)
 		&AGhostAIController::EndHauntTimer,
 		Duration,
 		false);
-
-	// Get Current Time
-	
 }
 
 void AGhostAIController::EndHauntTimer()
 {
-	if (GetBlackboardComponent()->GetValueAsBool(isHaunting))
+	if (GhostBlackboard.GetBool(E_GhostBlackboardKey::IsHaunting))
 	{
-		GetBlackboardComponent()->SetValueAsBool(isHaunting, false);
-		GetBlackboardComponent()->SetValueAsObject(TargetPlayer, nullptr);
+		SCOPE_CYCLE_COUNTER(STAT_GhostHauntLoop);
+		GHOST_LOOP_TIMING_SCOPE(HauntLoopSeconds);
+		CSV_EVENT(Ghost, TEXT("HauntEnd %s"), *GetName());
+		CSV_CUSTOM_STAT(Ghost, HauntsEnded, 1, ECsvCustomStatOp::Accumulate);
+		CSV_CUSTOM_STAT(Ghost, HauntSeconds, static_cast<float>(GetWorld()->GetTimeSeconds() - HauntStartTime), ECsvCustomStatOp::Max);
+
+		GhostBlackboard.SetBool(E_GhostBlackboardKey::IsHaunting, false);
 		GetWorld()->GetTimerManager().ClearTimer(HauntingTimerHandle);
 
 		// Set TargetedPlayer to null
-		GetBlackboardComponent()->SetValueAsObject(TargetPlayer, nullptr);
+		SetTargetPlayer(nullptr);
 	
 		// Play Audio Cue
 		PlayCalmingSound();
@@ -178,47 +217,88 @@ void AGhostAIController::EndHauntTimer()
 		// Set the CurrentGhostState to Patrolling
 		OwnerGhost->SetGhostState(E_GhostState::Patrolling);
 
-		GetBlackboardComponent()->SetValueAsBool(CanTeleport, true);
+		GhostBlackboard.SetBool(E_GhostBlackboardKey::CanTeleport, true);
 	}
 }
 
 void AGhostAIController::ActivateGhost()
 {
-	BlackboardComponent->SetValueAsBool(GhostActive, true);
+	GhostBlackboard.SetBool(E_GhostBlackboardKey::GhostActive, true);
 }
 
 FVector AGhostAIController::GetRoomLocationFromDG() const
 {
-	if (DungeonGenerator)
+	if (ADungeonGenerator* DungeonGenerator = GhostDirector ? GhostDirector->GetDungeonGenerator() : nullptr)
 	{
 		return DungeonGenerator->GetRandomLocation();
 	}
 	return FVector::ZeroVector;
 }
 
-void AGhostAIController::SetTargetPlayer(ANetworkingPrototypeCharacter* Player)
+void AGhostAIController::SetTargetPlayer(AActor* Player)
 {
-	GetBlackboardComponent()->SetValueAsObject(TargetPlayer, Player);
+	GhostBlackboard.SetObject(E_GhostBlackboardKey::TargetPlayer, Player);
+
+	// Let the director know who we're after so other ghosts leave them alone
+	if (GhostDirector)
+	{
+		GhostDirector->ClaimTarget(this, Player);
+	}
+}
+
+bool AGhostAIController::TrySetTargetPlayer(ANetworkingPrototypeCharacter* Player)
+{
+	if (GhostDirector && !GhostDirector->CanClaimTarget(this, Player))
+	{
+		return false;
+	}
+
+	SetTargetPlayer(Player);
+	return true;
+}
+
+void AGhostAIController::RegisterWithSoundManager(ASoundManager* SoundManager)
+{
+	if (!SoundManager)
+	{
+		return;
+	}
+
+	// Only listen for the sounds we react to
+	SoundManager->RegisterSoundHandler(this, E_SoundEventType::Voice,
+		FSoundEventHandler::CreateUObject(this, &AGhostAIController::OnVoiceHeard));
 }
 
 void AGhostAIController::KillingAPlayer()
-{	
-	OwnerGhost->Multicast_PlayKillAnim(this);
+{
+	SCOPE_CYCLE_COUNTER(STAT_GhostHauntLoop);
+	GHOST_LOOP_TIMING_SCOPE(HauntLoopSeconds);
+	CSV_EVENT(Ghost, TEXT("KillStart %s"), *GetName());
+
+	OwnerGhost->RecordPresentationEvent(E_GhostPresentationEvent::Kill,
+		GhostBlackboard.GetObject<AActor>(E_GhostBlackboardKey::TargetPlayer));
 }
 
 void AGhostAIController::PostKillAnim(UAnimMontage* Montage, bool bInterrupted)
 {
-	if (GetBlackboardComponent()->GetValueAsObject(TargetPlayer))
+	if (GhostBlackboard.GetObject(E_GhostBlackboardKey::TargetPlayer))
 	{
 		ANetworkingPrototypeCharacter* TargetCharacter =
-			Cast<ANetworkingPrototypeCharacter>(GetBlackboardComponent()->GetValueAsObject(TargetPlayer));
+			GhostBlackboard.GetObject<ANetworkingPrototypeCharacter>(E_GhostBlackboardKey::TargetPlayer);
 		
 		if (TargetCharacter)
 		{
-			TargetCharacter->KillPlayer();
+			{
+				SCOPE_CYCLE_COUNTER(STAT_GhostHauntLoop);
+				// EndHauntTimer times itself, keep it out of this scope so it isn't counted twice
+				GHOST_LOOP_TIMING_SCOPE(HauntLoopSeconds);
+				CSV_CUSTOM_STAT(Ghost, Kills, 1, ECsvCustomStatOp::Accumulate);
+
+				TargetCharacter->KillPlayer();
 			
-			SetTargetPlayer(nullptr);
-			GetBlackboardComponent()->SetValueAsBool(KillingPlayer, false);
+				SetTargetPlayer(nullptr);
+				GhostBlackboard.SetBool(E_GhostBlackboardKey::KillingPlayer, false);
+			}
 
 			EndHauntTimer();
 		}
@@ -247,18 +327,18 @@ void AGhostAIController::BeginPlay()
 		// Check if perception is registered
 		if (UAIPerceptionSystem::GetCurrent(GetWorld()))
 		{
-			UE_LOG(LogTemp, Warning, TEXT("✅ AI Perception System Exists!"));
+			UE_LOG(LogGhostAI, Log, TEXT("✅ AI Perception System Exists!"));
 			// Force registers component with AI Perception if not registered
 			UAIPerceptionSystem::GetCurrent(GetWorld())->UpdateListener(*GhostPerceptionComponent);
 		}
 		else
 		{
-			UE_LOG(LogTemp, Error, TEXT("❌ AI Perception System is MISSING!"));
+			UE_LOG(LogGhostAI, Error, TEXT("❌ AI Perception System is MISSING!"));
 		}
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("❌ AI Perception Component is NULL!"));
+		UE_LOG(LogGhostAI, Error, TEXT("❌ AI Perception Component is NULL!"));
 	}
 }
 
@@ -279,30 +359,37 @@ void AGhostAIController::OnPossess(APawn* InPawn)
 	{
 		Blackboard->InitializeBlackboard(*BehaviorTree.Get()->BlackboardAsset.Get());
 
+		// Resolve our keys now so any missing from the asset get reported at startup
+		FGhostBlackboard::ResolveKeys(Blackboard->GetBlackboardAsset());
+
 		// Set Defaults
-		Blackboard->SetValueAsFloat(AggroTimerName, AggroTimer);
-		Blackboard->SetValueAsFloat(AggroRate, AggroIncreaseRate);
-		Blackboard->SetValueAsFloat(AggroRateMultiplier, AggroMultiplier);
-		Blackboard->SetValueAsFloat(HauntDurationName, HauntDuration);
+		GhostBlackboard.SetFloat(E_GhostBlackboardKey::AggroMeter, AggroTimer);
+		GhostBlackboard.SetFloat(E_GhostBlackboardKey::HauntingRate, AggroIncreaseRate);
+		GhostBlackboard.SetFloat(E_GhostBlackboardKey::HauntingMultiplier, AggroMultiplier);
+		GhostBlackboard.SetFloat(E_GhostBlackboardKey::HauntingDuration, HauntDuration);
 	}
 
-	// Try to find a Dungeon Generator
-	if (AActor* DungeonGenActor = UGameplayStatics::GetActorOfClass(GetWorld(), ADungeonGenerator::StaticClass()))
-	{
-		DungeonGenerator = Cast<ADungeonGenerator>(DungeonGenActor);
+	// Set Ghost's GhostAIController
+	//OwnerGhost->SetGhostAIController(this);
 
-		if (DungeonGenerator)
-		{
-			UE_LOG(LogTemp, Warning, TEXT("Dungeon Generator Found By GHOST!!"));
-		}
+	// Hand ourselves over to the Ghost Director, it shares the Dungeon Generator and Sound Manager
+	// between every ghost and ticks our behavior tree
+	GhostDirector = GetWorld()->GetSubsystem<UGhostDirectorSubsystem>();
+	if (GhostDirector)
+	{
+		GhostDirector->RegisterGhost(this);
 	}
+}
 
-	// Set Ghost's GhostAIController
-	//OwnerGhost->SetGhostAIController(this);
+void AGhostAIController::OnUnPossess()
+{
+	if (GhostDirector)
+	{
+		GhostDirector->UnregisterGhost(this);
+		GhostDirector = nullptr;
+	}
 
-	// Start timer to register self to Sound Manager 
-	GetWorld()->GetTimerManager().SetTimer(SoundManagerTimerHandle, this,
-	&AGhostAIController::RegisterSelfToSoundManager,1.0f, false);
+	Super::OnUnPossess();
 }
 
 void AGhostAIController::SetupPerceptionSystem() const
@@ -324,6 +411,9 @@ void AGhostAIController::SetupPerceptionSystem() const
 		
 		//GhostPerceptionComponent->OnPerceptionUpdated.AddUniqueDynamic(this, &AGhostAIController::OnPerceptionUpdated);
 
+		// Use our sight sense so the Ghost Director can budget its traces
+		GhostSightConfig->Implementation = UGhostAISense_Sight::StaticClass();
+
 		// Set Sight Config
 		GhostPerceptionComponent->SetDominantSense(*GhostSightConfig->GetSenseImplementation());
 		GhostPerceptionComponent->ConfigureSense(*GhostSightConfig);	
@@ -339,14 +429,15 @@ void AGhostAIController::SenseSight(AActor* Actor, const FAIStimulus Stimulus)
 		SeesPlayer = Stimulus.WasSuccessfullySensed();
 		if (SeesPlayer && Stimulus.IsActive())
 		{
-			GetBlackboardComponent()->SetValueAsBool(CanSeePlayer, SeesPlayer);
-			GetBlackboardComponent()->SetValueAsObject(TargetPlayer, Player);
-			GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Magenta, FString::Printf(TEXT("I SEE YOU!! ")));
+			GhostBlackboard.SetBool(E_GhostBlackboardKey::CanSeePlayer, SeesPlayer);
+			// Don't go after a player another ghost is already after
+			TrySetTargetPlayer(Player);
+			QU_DEBUG_MESSAGE(2.0f, FColor::Magenta, TEXT("I SEE YOU!! "));
 		}
 		else
 		{
-			GetBlackboardComponent()->SetValueAsBool(CanSeePlayer, false);
-			GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Magenta, FString::Printf(TEXT("Target Lost!")));
+			GhostBlackboard.SetBool(E_GhostBlackboardKey::CanSeePlayer, false);
+			QU_DEBUG_MESSAGE(2.0f, FColor::Magenta, TEXT("Target Lost!"));
 		}
 	}
 }
@@ -357,26 +448,13 @@ void AGhostAIController::OnPerceptionUpdated(const TArray<AActor*>& UpdatedActor
 	{
 		if (Actor)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("AI detected: %s"), *Actor->GetName());
+			UE_LOG(LogGhostAI, Verbose, TEXT("AI detected: %s"), *Actor->GetName());
 		}
 	}
 }
 
-void AGhostAIController::RegisterSelfToSoundManager()
-{
-	// Get our Game State to retrieve the stored SoundManager and register ourselves
-	// as one of it's stored AIActors
-	if (AQueriesUnlimitedGameState* QUGameState = GetWorld()->GetGameState<AQueriesUnlimitedGameState>())
-	{
-		QUGameState->SoundManager->RegisterAIActors(this);
-	}
-}
-
 void AGhostAIController::PlayCalmingSound() const
 {
-	if (CalmingSoundCue != nullptr)
-	{
-		OwnerGhost->Server_PlayAudio(CalmingSoundCue.Get());
-	}
+	OwnerGhost->RecordPresentationEvent(E_GhostPresentationEvent::Calming);
 }
 
@@ -8,10 +8,20 @@
 #include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
 #include "NetworkingPrototype/DungeonGeneration/DungeonGenerator.h"
 #include "Perception/AIPerceptionTypes.h"
+#include "GhostBlackboard.h"
 #include "GhostAIController.generated.h"
 
 class UBehaviorTreeComponent;
 class AGhost;
+class ASoundManager;
+
+// Declare the log category
+// Only warnings and errors are compiled into Shipping and Test builds
+#if UE_BUILD_SHIPPING || UE_BUILD_TEST
+DECLARE_LOG_CATEGORY_EXTERN(LogGhostAI, Warning, Warning);
+#else
+DECLARE_LOG_CATEGORY_EXTERN(LogGhostAI, Log, All);
+#endif
 
 
 /**
@@ -28,7 +38,7 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	UAIPerceptionComponent* GhostPerceptionComponent;
 
-	void Distract(ACharacter* Distractor) const;
+	void Distract(ACharacter* Distractor);
 	void Undistract() const;
 
 	void Stun(const float CustomDuration = 0);
@@ -58,7 +68,23 @@ public:
 
 	FVector GetRoomLocationFromDG() const;
 
-	void SetTargetPlayer(ANetworkingPrototypeCharacter* Player);
+	// Sets who we're after, usually a player but anything a haunt gets forced onto works
+	void SetTargetPlayer(AActor* Player);
+
+	// Sets the target player from our own perception, does nothing if another ghost already has them
+	// Returns whether the player is our target now
+	bool TrySetTargetPlayer(ANetworkingPrototypeCharacter* Player);
+
+	// Registers our sound handlers, called by the Ghost Director once the Sound Manager exists
+	void RegisterWithSoundManager(ASoundManager* SoundManager);
+
+	UBehaviorTreeComponent* GetBehaviorTreeComponent() const { return BehaviorTreeComponent.Get(); }
+
+	// Behavior tree we run, nullptr if none was assigned
+	UBehaviorTree* GetBehaviorTree() const { return BehaviorTree.Get(); }
+
+	// Typed access to our blackboard with cached key IDs, use this instead of key names
+	const FGhostBlackboard& GetGhostBlackboard() const { return GhostBlackboard; }
 
 	// Small function that runs when killing a player,
 	// used for kill animations and starting the EndHauntTimer
@@ -71,6 +97,7 @@ protected:
 	virtual void BeginPlay() override;
 	void Tick(float deltaTime);
 	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
 	
 private:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
@@ -98,30 +125,29 @@ private:
 	UFUNCTION()
 	void OnPerceptionUpdated(const TArray<AActor*>& UpdatedActors);
 
-	UFUNCTION()
-	void RegisterSelfToSoundManager();
-
-	FName Distracted = TEXT("Distracted");
-	FName Stunned = TEXT("Stunned");
-	FName TargetPlayer = TEXT("TargettedPlayer");
-	FName KillingPlayer = TEXT("KillingPlayer");
-	FName CanSeePlayer = TEXT("CanSeePlayer");
-	const FName& StunDuration = TEXT("StunDuration");
-	FName isHaunting = TEXT("isHaunting");
-	FName CanTeleport = TEXT("CanTeleport");
-	FName GhostActive = TEXT("GhostActive");
+	// Sound Manager handler for voice sound events
+	void OnVoiceHeard(const FSoundEvent& SoundEvent);
+
+	// Typed view over BlackboardComponent
+	FGhostBlackboard GhostBlackboard;
 
 	// Internal Check if the Ghost can see someone
 	bool SeesPlayer = false;
 
 	/** Haunting Timer */
 	FTimerHandle HauntingTimerHandle;
-	/* Timer to register self with Sound Manager */
-	FTimerHandle SoundManagerTimerHandle;
+
+	// World time the current haunt started, used to profile how long haunts last
+	double HauntStartTime = 0.0;
+
+	// World time a voice last distracted us, voice reports come in several times a second
+	double LastVoiceDistractTime = -1.0;
 
 	void PlayCalmingSound() const;
 
-	ADungeonGenerator* DungeonGenerator = nullptr;
+	// Ghost Director that owns us, set on possess
+	UPROPERTY()
+	class UGhostDirectorSubsystem* GhostDirector = nullptr;
 	
 	/* Public Variables to adjust Ghost's Aggro defaults */
 
@@ -129,31 +155,24 @@ public:
 	// How long the ghost remains docile before haunting a player (without seeing any players)
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
 	float AggroTimer = 30.0f;
-	FName AggroTimerName = TEXT("AggroMeter");
 
 	// Rate at which the ghost's haunting increases normaly
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
 	float AggroIncreaseRate = 0.5f;
-	FName AggroRate = TEXT("HauntingRate");
 
 	// Rate Multiplier when the ghost can see a player
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
 	float AggroMultiplier = 4.0f;
-	FName AggroRateMultiplier = TEXT("HauntingMultiplier");
 
 	// Duration of Haunting without killing a player before calming down again
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
 	float HauntDuration = 30.0f;
-	FName HauntDurationName = TEXT("HauntingDuration");
 
-	float DebugTimerVerify = 0;
+	// How long after a loud voice distracts the ghost before another one can
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true, ClampMin = "0.0"))
+	float VoiceDistractCooldown = 3.0f;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
-	TObjectPtr<USoundBase> CalmingSoundCue;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
-	TObjectPtr<USoundBase> StunSoundCue;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "AI", meta = (AllowPrivateAccess = true))
-	TObjectPtr<USoundBase> DistractSoundCue; 
+	float DebugTimerVerify = 0;
 
 	
 };
@@ -0,0 +1,15 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GhostAISense_Sight.h"
+
+#include "GhostStats.h"
+
+float UGhostAISense_Sight::Update()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GhostSight);
+	CSV_SCOPED_TIMING_STAT(Ghost, Sight);
+	GHOST_LOOP_TIMING_SCOPE(SightSeconds);
+
+	return Super::Update();
+}
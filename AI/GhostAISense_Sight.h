@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Perception/AISense_Sight.h"
+#include "GhostAISense_Sight.generated.h"
+
+/**
+ * Sight sense used by the ghosts.
+ * Same as the engine's sight sense, but lets the Ghost Director change how many
+ * line of sight traces it does per frame at runtime instead of only through config.
+ */
+UCLASS(ClassGroup = AI)
+class NETWORKINGPROTOTYPE_API UGhostAISense_Sight : public UAISense_Sight
+{
+	GENERATED_BODY()
+
+public:
+	// Max line of sight traces per frame, shared across every listener
+	void SetMaxTracesPerTick(const int32 InMaxTracesPerTick) { MaxTracesPerTick = FMath::Max(1, InMaxTracesPerTick); }
+	int32 GetMaxTracesPerTick() const { return MaxTracesPerTick; }
+
+protected:
+	// Same update as the engine's sight sense, wrapped in the ghost profiling stats
+	virtual float Update() override;
+};
@@ -6,6 +6,7 @@
 #include "AIController.h"
 #include "GhostAIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "NetworkingPrototype/DebugMessages.h"
 
 UGhostBTTask_FollowPlayerWithNav::UGhostBTTask_FollowPlayerWithNav(const FObjectInitializer& ObjectInitializer)
 {
@@ -19,33 +20,42 @@ EBTNodeResult::Type UGhostBTTask_FollowPlayerWithNav::ExecuteTask(UBehaviorTreeC
 
 void UGhostBTTask_FollowPlayerWithNav::UpdateLastKnownLocation(UBehaviorTreeComponent& OwnerComp) const
 {
-	AActor* TargetPlayerActor = Cast<AActor>(OwnerComp.GetBlackboardComponent()->GetValueAsObject(TargetPlayer));
+	const AGhostAIController* GhostAIController = Cast<AGhostAIController>(OwnerComp.GetAIOwner());
+	if (!GhostAIController)
+	{
+		return;
+	}
+
+	const FGhostBlackboard& GhostBlackboard = GhostAIController->GetGhostBlackboard();
+	AActor* TargetPlayerActor = GhostBlackboard.GetObject<AActor>(E_GhostBlackboardKey::TargetPlayer);
 	if (TargetPlayerActor != nullptr)
 	{
 		const FVector PlayerLastSeenLocation = TargetPlayerActor->GetActorLocation();
-		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Cyan, TEXT("PlayerLastSeenLocation: ") + PlayerLastSeenLocation.ToString());
-		OwnerComp.GetBlackboardComponent()->SetValueAsVector(TargetLocation, PlayerLastSeenLocation);
+		QU_DEBUG_MESSAGE(2.0f, FColor::Cyan, FString::Printf(TEXT("PlayerLastSeenLocation: %s"), *PlayerLastSeenLocation.ToString()));
+		GhostBlackboard.SetVector(E_GhostBlackboardKey::TargetLocation, PlayerLastSeenLocation);
 	}
 }
 
 void UGhostBTTask_FollowPlayerWithNav::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory,
 	EBTNodeResult::Type TaskResult)
 {
-	if (TaskResult == EBTNodeResult::Succeeded)
+	AGhostAIController* GhostAIController = Cast<AGhostAIController>(OwnerComp.GetAIOwner());
+	if (TaskResult == EBTNodeResult::Succeeded && GhostAIController)
 	{
+		// Use the controller's blackboard, its key IDs are already cached
+		const FGhostBlackboard& GhostBlackboard = GhostAIController->GetGhostBlackboard();
 		
-		if (ANetworkingPrototypeCharacter* CaughtPlayer = Cast<ANetworkingPrototypeCharacter>(
-			OwnerComp.GetBlackboardComponent()->GetValueAsObject(TargetPlayer)))
+		if (ANetworkingPrototypeCharacter* CaughtPlayer =
+			GhostBlackboard.GetObject<ANetworkingPrototypeCharacter>(E_GhostBlackboardKey::TargetPlayer))
 		{
-			AGhostAIController* GhostAIController = Cast<AGhostAIController>(OwnerComp.GetOwner());
 			APawn* GhostPawn = GhostAIController->GetPawn();
 
 			APlayerController* CaughtPlayerController = Cast<APlayerController>(CaughtPlayer->GetController());
 			
-			if (GhostAIController && GhostPawn && CaughtPlayerController)
+			if (GhostPawn && CaughtPlayerController)
 			{
 				// Set KillingPlayer to true
-				OwnerComp.GetBlackboardComponent()->SetValueAsBool(KillingPlayer, true);
+				GhostBlackboard.SetBool(E_GhostBlackboardKey::KillingPlayer, true);
 
 				// Tell the caught player to face towards the ghost
 				CaughtPlayer->Client_CameraLookAtLocation_Wrapper(GhostPawn->GetActorLocation(), CaughtPlayerController);
@@ -78,14 +88,11 @@ void UGhostBTTask_FollowPlayerWithNav::OnTaskFinished(UBehaviorTreeComponent& Ow
 				// CaughtPlayer->Client_CameraLookAtLocation_Wrapper(CameraTargetVector, false);
 
 				// Kill the caught player and End Haunt Timer
-				if (AGhostAIController* GhostAI = Cast<AGhostAIController>(OwnerComp.GetAIOwner()))
-				{
-					GhostAI->KillingAPlayer();
-				}
+				GhostAIController->KillingAPlayer();
 			}
 		}
 	}
-	else
+	else if (TaskResult != EBTNodeResult::Succeeded)
 	{
 		UpdateLastKnownLocation(OwnerComp);
 	}
@@ -22,12 +22,6 @@ public:
 
 private:
 
-	// Simplified method to be able to reach Blackboard variables
-	FName TargetPlayer = TEXT("TargettedPlayer");
-	FName KillingPlayer = TEXT("KillingPlayer");
-	FName CanSeePlayer = TEXT("CanSeePlayer");
-	FName TargetLocation = TEXT("TargetLocation");
-
 	UPROPERTY(EditAnywhere)
 	FBlackboardKeySelector SelfActor;
 
@@ -0,0 +1,191 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GhostBlackboard.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogGhostBlackboard);
+
+namespace GhostBlackboard
+{
+	// Name and type of every ghost key, in E_GhostBlackboardKey order
+	struct FKeyInfo
+	{
+		const TCHAR* Name;
+		UClass* (*GetKeyType)();
+	};
+
+	static const FKeyInfo KeyInfos[] =
+	{
+		{ TEXT("Distracted"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("Stunned"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("TargettedPlayer"), &UBlackboardKeyType_Object::StaticClass },
+		{ TEXT("KillingPlayer"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("CanSeePlayer"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("StunDuration"), &UBlackboardKeyType_Float::StaticClass },
+		{ TEXT("isHaunting"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("CanTeleport"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("GhostActive"), &UBlackboardKeyType_Bool::StaticClass },
+		{ TEXT("AggroMeter"), &UBlackboardKeyType_Float::StaticClass },
+		{ TEXT("HauntingRate"), &UBlackboardKeyType_Float::StaticClass },
+		{ TEXT("HauntingMultiplier"), &UBlackboardKeyType_Float::StaticClass },
+		{ TEXT("HauntingDuration"), &UBlackboardKeyType_Float::StaticClass },
+		{ TEXT("PassiveMultiplier"), &UBlackboardKeyType_Float::StaticClass },
+		{ TEXT("TargetLocation"), &UBlackboardKeyType_Vector::StaticClass },
+	};
+	static_assert(UE_ARRAY_COUNT(KeyInfos) == static_cast<int32>(E_GhostBlackboardKey::Count),
+		"Every E_GhostBlackboardKey needs an entry in KeyInfos");
+
+	// Key IDs for one blackboard asset
+	struct FResolvedKeys
+	{
+		FBlackboard::FKey Ids[static_cast<int32>(E_GhostBlackboardKey::Count)];
+	};
+
+	// Resolved key IDs per blackboard asset. Heap allocated so the pointers we hand out stay put when the map grows.
+	static TMap<TWeakObjectPtr<const UBlackboardData>, TUniquePtr<FResolvedKeys>> ResolvedKeysPerAsset;
+}
+
+bool FGhostBlackboard::GetBool(const E_GhostBlackboardKey Key) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	return KeyId != FBlackboard::InvalidKey && BlackboardComponent->GetValue<UBlackboardKeyType_Bool>(KeyId);
+}
+
+void FGhostBlackboard::SetBool(const E_GhostBlackboardKey Key, const bool bValue) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	if (KeyId != FBlackboard::InvalidKey)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(KeyId, bValue);
+	}
+}
+
+float FGhostBlackboard::GetFloat(const E_GhostBlackboardKey Key) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	return KeyId != FBlackboard::InvalidKey ? BlackboardComponent->GetValue<UBlackboardKeyType_Float>(KeyId) : 0.0f;
+}
+
+void FGhostBlackboard::SetFloat(const E_GhostBlackboardKey Key, const float Value) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	if (KeyId != FBlackboard::InvalidKey)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Float>(KeyId, Value);
+	}
+}
+
+UObject* FGhostBlackboard::GetObject(const E_GhostBlackboardKey Key) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	return KeyId != FBlackboard::InvalidKey ? BlackboardComponent->GetValue<UBlackboardKeyType_Object>(KeyId) : nullptr;
+}
+
+void FGhostBlackboard::SetObject(const E_GhostBlackboardKey Key, UObject* Value) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	if (KeyId != FBlackboard::InvalidKey)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Object>(KeyId, Value);
+	}
+}
+
+FVector FGhostBlackboard::GetVector(const E_GhostBlackboardKey Key) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	return KeyId != FBlackboard::InvalidKey ? BlackboardComponent->GetValue<UBlackboardKeyType_Vector>(KeyId) : FVector::ZeroVector;
+}
+
+void FGhostBlackboard::SetVector(const E_GhostBlackboardKey Key, const FVector& Value) const
+{
+	const FBlackboard::FKey KeyId = GetKeyId(Key);
+	if (KeyId != FBlackboard::InvalidKey)
+	{
+		BlackboardComponent->SetValue<UBlackboardKeyType_Vector>(KeyId, Value);
+	}
+}
+
+const FBlackboard::FKey* FGhostBlackboard::ResolveKeys(const UBlackboardData* BlackboardAsset)
+{
+	if (!BlackboardAsset)
+	{
+		return nullptr;
+	}
+
+	if (const TUniquePtr<GhostBlackboard::FResolvedKeys>* CachedKeys = GhostBlackboard::ResolvedKeysPerAsset.Find(BlackboardAsset))
+	{
+		return (*CachedKeys)->Ids;
+	}
+
+	// Forget assets that have been unloaded before adding a new one
+	for (auto It = GhostBlackboard::ResolvedKeysPerAsset.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	TUniquePtr<GhostBlackboard::FResolvedKeys> NewKeys = MakeUnique<GhostBlackboard::FResolvedKeys>();
+	for (int32 KeyIdx = 0; KeyIdx < static_cast<int32>(E_GhostBlackboardKey::Count); KeyIdx++)
+	{
+		const GhostBlackboard::FKeyInfo& KeyInfo = GhostBlackboard::KeyInfos[KeyIdx];
+		FBlackboard::FKey KeyId = BlackboardAsset->GetKeyID(KeyInfo.Name);
+
+		if (KeyId == FBlackboard::InvalidKey)
+		{
+			UE_LOG(LogGhostBlackboard, Error, TEXT("Blackboard %s is missing ghost key %s!"),
+				*BlackboardAsset->GetName(), KeyInfo.Name);
+		}
+		else if (BlackboardAsset->GetKeyType(KeyId) != KeyInfo.GetKeyType())
+		{
+			UE_LOG(LogGhostBlackboard, Error, TEXT("Blackboard %s key %s should be a %s!"),
+				*BlackboardAsset->GetName(), KeyInfo.Name, *KeyInfo.GetKeyType()->GetName());
+
+			// Treat it as missing so we never read it as the wrong type
+			KeyId = FBlackboard::InvalidKey;
+		}
+
+		NewKeys->Ids[KeyIdx] = KeyId;
+	}
+
+	const FBlackboard::FKey* KeyIds = NewKeys->Ids;
+	GhostBlackboard::ResolvedKeysPerAsset.Add(BlackboardAsset, MoveTemp(NewKeys));
+	return KeyIds;
+}
+
+FName FGhostBlackboard::GetKeyName(const E_GhostBlackboardKey Key)
+{
+	return GhostBlackboard::KeyInfos[static_cast<int32>(Key)].Name;
+}
+
+UClass* FGhostBlackboard::GetKeyType(const E_GhostBlackboardKey Key)
+{
+	return GhostBlackboard::KeyInfos[static_cast<int32>(Key)].GetKeyType();
+}
+
+FBlackboard::FKey FGhostBlackboard::GetKeyId(const E_GhostBlackboardKey Key) const
+{
+	if (!BlackboardComponent)
+	{
+		return FBlackboard::InvalidKey;
+	}
+
+	// Only resolve again when the component has been given a different asset
+	const UBlackboardData* BlackboardAsset = BlackboardComponent->GetBlackboardAsset();
+	if (BlackboardAsset != ResolvedAsset)
+	{
+		ResolvedAsset = BlackboardAsset;
+		ResolvedKeys = ResolveKeys(BlackboardAsset);
+	}
+
+	return ResolvedKeys ? ResolvedKeys[static_cast<int32>(Key)] : FBlackboard::InvalidKey;
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+
+class UBlackboardComponent;
+class UBlackboardData;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogGhostBlackboard, Log, All);
+
+// Every ghost blackboard key read or written from C++
+enum class E_GhostBlackboardKey : uint8
+{
+	Distracted,
+	Stunned,
+	TargetPlayer,
+	KillingPlayer,
+	CanSeePlayer,
+	StunDuration,
+	IsHaunting,
+	CanTeleport,
+	GhostActive,
+	AggroMeter,
+	HauntingRate,
+	HauntingMultiplier,
+	HauntingDuration,
+	PassiveMultiplier,
+	TargetLocation,
+	// Number of keys, keep last
+	Count
+};
+
+/**
+ * Typed view over a ghost's blackboard component.
+ * Key IDs are resolved once per blackboard asset and shared by every ghost using it,
+ * so reads and writes never look up key names. Keys missing from the asset, or with the wrong type,
+ * are logged as errors the first time the asset is resolved.
+ * Copying the view is cheap, and setters are const since they only write through to the component.
+ */
+class NETWORKINGPROTOTYPE_API FGhostBlackboard
+{
+public:
+	FGhostBlackboard() = default;
+	explicit FGhostBlackboard(UBlackboardComponent* InBlackboardComponent)
+		: BlackboardComponent(InBlackboardComponent) {}
+
+	// Typed getters and setters, getters return the type's default if the key isn't available
+	bool GetBool(const E_GhostBlackboardKey Key) const;
+	void SetBool(const E_GhostBlackboardKey Key, const bool bValue) const;
+
+	float GetFloat(const E_GhostBlackboardKey Key) const;
+	void SetFloat(const E_GhostBlackboardKey Key, const float Value) const;
+
+	UObject* GetObject(const E_GhostBlackboardKey Key) const;
+	void SetObject(const E_GhostBlackboardKey Key, UObject* Value) const;
+
+	template <typename ObjectType>
+	ObjectType* GetObject(const E_GhostBlackboardKey Key) const
+	{
+		return Cast<ObjectType>(GetObject(Key));
+	}
+
+	FVector GetVector(const E_GhostBlackboardKey Key) const;
+	void SetVector(const E_GhostBlackboardKey Key, const FVector& Value) const;
+
+	// Resolves every ghost key against a blackboard asset and logs an error for any that don't match.
+	// Returns the key IDs indexed by E_GhostBlackboardKey, cached per asset.
+	static const FBlackboard::FKey* ResolveKeys(const UBlackboardData* BlackboardAsset);
+
+	// The blackboard key name for a ghost key
+	static FName GetKeyName(const E_GhostBlackboardKey Key);
+
+	// The blackboard key type a ghost key needs, EX: UBlackboardKeyType_Bool
+	static UClass* GetKeyType(const E_GhostBlackboardKey Key);
+
+private:
+	// Gets the key ID for a ghost key, resolving the component's asset if it changed
+	FBlackboard::FKey GetKeyId(const E_GhostBlackboardKey Key) const;
+
+	// Component we read from and write to
+	UBlackboardComponent* BlackboardComponent = nullptr;
+
+	// Asset the cached key IDs were resolved against
+	mutable const UBlackboardData* ResolvedAsset = nullptr;
+	mutable const FBlackboard::FKey* ResolvedKeys = nullptr;
+};
@@ -0,0 +1,397 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GhostDirectorSubsystem.h"
+
+#include "GhostAIController.h"
+#include "Ghost.h"
+#include "GhostAISense_Sight.h"
+#include "GhostStats.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerState.h"
+#include "Perception/AIPerceptionComponent.h"
+#include "Perception/AIPerceptionSystem.h"
+#include "Perception/AISenseConfig_Sight.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Kismet/GameplayStatics.h"
+#include "NetworkingPrototype/DungeonGeneration/DungeonGenerator.h"
+#include "NetworkingPrototype/GameStates/QueriesUnlimitedGameState.h"
+#include "NetworkingPrototype/Managers/SoundManager.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogGhostDirector);
+
+void UGhostDirectorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Config can say anything, keep the tunables to something that still runs
+	BehaviorTreeBudgetMs = FMath::Max(0.0f, BehaviorTreeBudgetMs);
+	MaxBehaviorTreeTickDelay = FMath::Max(0.0f, MaxBehaviorTreeTickDelay);
+	PerceptionLODUpdateInterval = FMath::Max(0.05f, PerceptionLODUpdateInterval);
+	PerceptionWakeRadius = FMath::Max(0.0f, PerceptionWakeRadius);
+	NormalSightTracesPerGhost = FMath::Max(0, NormalSightTracesPerGhost);
+	ChasingSightTracesPerGhost = FMath::Max(0, ChasingSightTracesPerGhost);
+	MaxSightTracesPerFrame = FMath::Max(1, MaxSightTracesPerFrame);
+}
+
+void UGhostDirectorSubsystem::Deinitialize()
+{
+	Ghosts.Empty();
+	DungeonGenerator = nullptr;
+
+	Super::Deinitialize();
+}
+
+void UGhostDirectorSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Ghosts.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GhostDirectorTick);
+	CSV_SCOPED_TIMING_STAT(Ghost, DirectorTick);
+	GHOST_LOOP_TIMING_SCOPE(DirectorSeconds);
+
+	// Drop ghosts that were destroyed without unregistering
+	Ghosts.RemoveAllSwap([](const FDirectedGhost& Ghost) { return !Ghost.Controller.IsValid(); });
+
+	if (bHasGhostsWaitingOnSoundManager)
+	{
+		RegisterGhostsWithSoundManager();
+	}
+
+	TimeUntilPerceptionLODUpdate -= DeltaTime;
+	if (TimeUntilPerceptionLODUpdate <= 0.0f)
+	{
+		TimeUntilPerceptionLODUpdate = PerceptionLODUpdateInterval;
+		UpdatePerceptionLOD();
+	}
+
+	TickBehaviorTrees(DeltaTime);
+}
+
+TStatId UGhostDirectorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UGhostDirectorSubsystem, STATGROUP_Tickables);
+}
+
+void UGhostDirectorSubsystem::RegisterGhost(AGhostAIController* GhostController)
+{
+	if (!GhostController || FindGhost(GhostController))
+	{
+		return;
+	}
+
+	FDirectedGhost& Ghost = Ghosts.AddDefaulted_GetRef();
+	Ghost.Controller = GhostController;
+	Ghost.BehaviorTreeComponent = GhostController->GetBehaviorTreeComponent();
+
+	// We're the only thing that ticks the behavior tree, it can't tick itself
+	if (const UBehaviorTreeComponent* BehaviorTreeComponent = Ghost.BehaviorTreeComponent.Get())
+	{
+		if (BehaviorTreeComponent->PrimaryComponentTick.bCanEverTick)
+		{
+			UE_LOG(LogGhostDirector, Warning, TEXT("Behavior tree of %s can tick on its own, it will tick twice and skip the budget!"),
+				*GhostController->GetName());
+		}
+	}
+
+	// Dormant ghosts don't look at all, so a player they could see must always wake them first
+	const UAIPerceptionComponent* PerceptionComponent = GhostController->GhostPerceptionComponent;
+	const UAISenseConfig_Sight* SightConfig = PerceptionComponent ? Cast<UAISenseConfig_Sight>(
+		PerceptionComponent->GetSenseConfig(UAISense::GetSenseID<UGhostAISense_Sight>())) : nullptr;
+	if (SightConfig && SightConfig->LoseSightRadius > PerceptionWakeRadius)
+	{
+		UE_LOG(LogGhostDirector, Warning, TEXT("%s can see %.0f units but only wakes up for players within %.0f, raise PerceptionWakeRadius!"),
+			*GhostController->GetName(), SightConfig->LoseSightRadius, PerceptionWakeRadius);
+	}
+
+	// Try to hook up to the Sound Manager now, otherwise keep trying every tick until it exists
+	bHasGhostsWaitingOnSoundManager = true;
+	RegisterGhostsWithSoundManager();
+
+	UE_LOG(LogGhostDirector, Log, TEXT("Registered ghost %s, %d ghosts in the world."), *GhostController->GetName(), Ghosts.Num());
+}
+
+void UGhostDirectorSubsystem::UnregisterGhost(AGhostAIController* GhostController)
+{
+	const int32 GhostIdx = Ghosts.IndexOfByPredicate([GhostController](const FDirectedGhost& Ghost)
+	{
+		return Ghost.Controller == GhostController;
+	});
+
+	if (GhostIdx == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Make sure we don't leave the ghost blind
+	ApplyPerceptionLOD(Ghosts[GhostIdx], E_GhostPerceptionLOD::Normal);
+
+	// Stop listening for sounds
+	if (const AQueriesUnlimitedGameState* QUGameState = GetWorld()->GetGameState<AQueriesUnlimitedGameState>())
+	{
+		if (QUGameState->SoundManager)
+		{
+			QUGameState->SoundManager->UnregisterSoundHandlers(GhostController);
+		}
+	}
+
+	Ghosts.RemoveAtSwap(GhostIdx);
+}
+
+void UGhostDirectorSubsystem::ClaimTarget(AGhostAIController* GhostController, AActor* Target)
+{
+	FDirectedGhost* Ghost = FindGhost(GhostController);
+	if (!Ghost)
+	{
+		return;
+	}
+
+	Ghost->ClaimedTarget = Target;
+}
+
+bool UGhostDirectorSubsystem::CanClaimTarget(const AGhostAIController* GhostController, const AActor* Target) const
+{
+	const AGhostAIController* TargetingGhost = GetGhostTargeting(Target);
+	return !TargetingGhost || TargetingGhost == GhostController;
+}
+
+AGhostAIController* UGhostDirectorSubsystem::GetGhostTargeting(const AActor* Target) const
+{
+	if (!Target)
+	{
+		return nullptr;
+	}
+
+	for (const FDirectedGhost& Ghost : Ghosts)
+	{
+		if (Ghost.ClaimedTarget == Target)
+		{
+			return Ghost.Controller.Get();
+		}
+	}
+
+	return nullptr;
+}
+
+ADungeonGenerator* UGhostDirectorSubsystem::GetDungeonGenerator()
+{
+	// Only look once, every ghost shares the result
+	if (!bSearchedForDungeonGenerator)
+	{
+		bSearchedForDungeonGenerator = true;
+		DungeonGenerator = Cast<ADungeonGenerator>(UGameplayStatics::GetActorOfClass(GetWorld(), ADungeonGenerator::StaticClass()));
+
+		if (DungeonGenerator.IsValid())
+		{
+			UE_LOG(LogGhostDirector, Log, TEXT("Dungeon Generator found by the Ghost Director."));
+		}
+	}
+
+	return DungeonGenerator.Get();
+}
+
+E_GhostPerceptionLOD UGhostDirectorSubsystem::GetPerceptionLOD(const AGhostAIController* GhostController) const
+{
+	const FDirectedGhost* Ghost = FindGhost(GhostController);
+	return Ghost ? Ghost->PerceptionLOD : E_GhostPerceptionLOD::Normal;
+}
+
+void UGhostDirectorSubsystem::UpdatePerceptionLOD()
+{
+	SCOPE_CYCLE_COUNTER(STAT_GhostPerceptionLOD);
+	CSV_SCOPED_TIMING_STAT(Ghost, PerceptionLOD);
+	GHOST_LOOP_TIMING_SCOPE(PerceptionLODSeconds);
+
+	// Gather every living player's location once for all ghosts
+	TArray<FVector, TInlineAllocator<8>> PlayerLocations;
+	if (const AGameStateBase* GameState = GetWorld()->GetGameState())
+	{
+		for (const APlayerState* PlayerState : GameState->PlayerArray)
+		{
+			if (const APawn* PlayerPawn = PlayerState ? PlayerState->GetPawn() : nullptr)
+			{
+				PlayerLocations.Add(PlayerPawn->GetActorLocation());
+			}
+		}
+	}
+
+	const float WakeRadiusSquared = PerceptionWakeRadius * PerceptionWakeRadius;
+	int32 NumNormal = 0;
+	int32 NumChasing = 0;
+
+	for (FDirectedGhost& Ghost : Ghosts)
+	{
+		const AGhostAIController* GhostController = Ghost.Controller.Get();
+		const AGhost* GhostPawn = GhostController ? Cast<AGhost>(GhostController->GetPawn()) : nullptr;
+		if (!GhostPawn)
+		{
+			continue;
+		}
+
+		E_GhostPerceptionLOD NewLOD = E_GhostPerceptionLOD::Dormant;
+		if (GhostPawn->GetGhostState() == E_GhostState::Chasing)
+		{
+			NewLOD = E_GhostPerceptionLOD::Chasing;
+		}
+		else
+		{
+			const FVector GhostLocation = GhostPawn->GetActorLocation();
+			for (const FVector& PlayerLocation : PlayerLocations)
+			{
+				if (FVector::DistSquared(GhostLocation, PlayerLocation) <= WakeRadiusSquared)
+				{
+					NewLOD = E_GhostPerceptionLOD::Normal;
+					break;
+				}
+			}
+		}
+
+		ApplyPerceptionLOD(Ghost, NewLOD);
+
+		NumNormal += NewLOD == E_GhostPerceptionLOD::Normal ? 1 : 0;
+		NumChasing += NewLOD == E_GhostPerceptionLOD::Chasing ? 1 : 0;
+	}
+
+	// Size the shared sight budget to the ghosts that actually need it
+	if (UAIPerceptionSystem* PerceptionSystem = UAIPerceptionSystem::GetCurrent(GetWorld()))
+	{
+		UGhostAISense_Sight* GhostSight = Cast<UGhostAISense_Sight>(
+			PerceptionSystem->GetSenseInstance(UAISense::GetSenseID<UGhostAISense_Sight>()));
+		if (GhostSight)
+		{
+			const int32 SightTraces = NumNormal * NormalSightTracesPerGhost + NumChasing * ChasingSightTracesPerGhost;
+			GhostSight->SetMaxTracesPerTick(FMath::Clamp(SightTraces, 1, MaxSightTracesPerFrame));
+			CSV_CUSTOM_STAT(Ghost, SightTraceBudget, GhostSight->GetMaxTracesPerTick(), ECsvCustomStatOp::Set);
+		}
+	}
+
+	CSV_CUSTOM_STAT(Ghost, NumGhostsNormal, NumNormal, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ghost, NumGhostsChasing, NumChasing, ECsvCustomStatOp::Set);
+}
+
+void UGhostDirectorSubsystem::ApplyPerceptionLOD(FDirectedGhost& Ghost, const E_GhostPerceptionLOD NewLOD) const
+{
+	const bool bWasDormant = Ghost.PerceptionLOD == E_GhostPerceptionLOD::Dormant;
+	const bool bIsDormant = NewLOD == E_GhostPerceptionLOD::Dormant;
+	Ghost.PerceptionLOD = NewLOD;
+
+	// Only touch the perception component when sight actually turns on or off
+	if (bWasDormant == bIsDormant)
+	{
+		return;
+	}
+
+	if (const AGhostAIController* GhostController = Ghost.Controller.Get())
+	{
+		if (GhostController->GhostPerceptionComponent)
+		{
+			GhostController->GhostPerceptionComponent->SetSenseEnabled(UGhostAISense_Sight::StaticClass(), !bIsDormant);
+		}
+
+		UE_LOG(LogGhostDirector, Verbose, TEXT("Ghost %s sight %s."), *GhostController->GetName(),
+			bIsDormant ? TEXT("dormant") : TEXT("awake"));
+	}
+}
+
+void UGhostDirectorSubsystem::TickBehaviorTrees(const float DeltaTime)
+{
+	const int32 NumGhosts = Ghosts.Num();
+	if (NumGhosts == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_GhostBehaviorTreeTick);
+	CSV_SCOPED_TIMING_STAT(Ghost, BehaviorTreeTick);
+	GHOST_LOOP_TIMING_SCOPE(BehaviorTreeSeconds);
+
+	for (FDirectedGhost& Ghost : Ghosts)
+	{
+		Ghost.PendingBehaviorTreeDeltaTime += DeltaTime;
+	}
+
+	const double BudgetEndTime = FPlatformTime::Seconds() + BehaviorTreeBudgetMs / 1000.0;
+	NextBehaviorTreeIdx %= NumGhosts;
+
+	// Go round robin from where we left off last frame. Always tick at least one tree,
+	// then keep going while we have budget left or a tree has waited too long.
+	int32 NumTicked = 0;
+	for (int32 Step = 0; Step < NumGhosts; Step++)
+	{
+		const int32 GhostIdx = (NextBehaviorTreeIdx + Step) % NumGhosts;
+		FDirectedGhost& Ghost = Ghosts[GhostIdx];
+
+		const bool bOverBudget = Step > 0 && FPlatformTime::Seconds() >= BudgetEndTime;
+		if (bOverBudget && Ghost.PendingBehaviorTreeDeltaTime < MaxBehaviorTreeTickDelay)
+		{
+			continue;
+		}
+
+		UBehaviorTreeComponent* BehaviorTreeComponent = Ghost.BehaviorTreeComponent.Get();
+		if (BehaviorTreeComponent && BehaviorTreeComponent->IsRegistered())
+		{
+			// Tick with all the time that passed since this tree's last tick so timers and waits stay correct
+			BehaviorTreeComponent->TickComponent(Ghost.PendingBehaviorTreeDeltaTime, LEVELTICK_All, nullptr);
+			NumTicked++;
+		}
+		Ghost.PendingBehaviorTreeDeltaTime = 0.0f;
+
+		// Whoever comes after the last tree we ticked goes first next frame
+		if (!bOverBudget)
+		{
+			NextBehaviorTreeIdx = (GhostIdx + 1) % NumGhosts;
+		}
+	}
+
+	CSV_CUSTOM_STAT(Ghost, NumGhosts, NumGhosts, ECsvCustomStatOp::Set);
+	CSV_CUSTOM_STAT(Ghost, BehaviorTreesTicked, NumTicked, ECsvCustomStatOp::Set);
+}
+
+void UGhostDirectorSubsystem::RegisterGhostsWithSoundManager()
+{
+	// The Sound Manager is stored on the Game State, which might not be around yet
+	const AQueriesUnlimitedGameState* QUGameState = GetWorld()->GetGameState<AQueriesUnlimitedGameState>();
+	ASoundManager* SoundManager = QUGameState ? QUGameState->SoundManager : nullptr;
+	if (!SoundManager)
+	{
+		return;
+	}
+
+	for (FDirectedGhost& Ghost : Ghosts)
+	{
+		if (Ghost.bRegisteredWithSoundManager)
+		{
+			continue;
+		}
+
+		if (AGhostAIController* GhostController = Ghost.Controller.Get())
+		{
+			GhostController->RegisterWithSoundManager(SoundManager);
+			Ghost.bRegisteredWithSoundManager = true;
+		}
+	}
+
+	bHasGhostsWaitingOnSoundManager = false;
+}
+
+UGhostDirectorSubsystem::FDirectedGhost* UGhostDirectorSubsystem::FindGhost(const AGhostAIController* GhostController)
+{
+	return Ghosts.FindByPredicate([GhostController](const FDirectedGhost& Ghost)
+	{
+		return Ghost.Controller == GhostController;
+	});
+}
+
+const UGhostDirectorSubsystem::FDirectedGhost* UGhostDirectorSubsystem::FindGhost(const AGhostAIController* GhostController) const
+{
+	return Ghosts.FindByPredicate([GhostController](const FDirectedGhost& Ghost)
+	{
+		return Ghost.Controller == GhostController;
+	});
+}
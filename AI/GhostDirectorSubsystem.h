@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "GhostDirectorSubsystem.generated.h"
+
+class AGhostAIController;
+class ADungeonGenerator;
+class ASoundManager;
+class UBehaviorTreeComponent;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogGhostDirector, Log, All);
+
+// How much sight work a ghost gets
+enum class E_GhostPerceptionLOD : uint8
+{
+	// No player is close enough to be seen, sight is turned off
+	Dormant,
+	// A player is nearby, sight runs at the normal rate
+	Normal,
+	// The ghost is chasing, sight gets a bigger share of the trace budget
+	Chasing
+};
+
+/**
+ * Server side director that owns every ghost in the world.
+ * Ghosts register on possess and unregister on unpossess. The director finds the world's
+ * shared actors (Dungeon Generator, Sound Manager) once for all of them, keeps track of which
+ * ghost has claimed which player so ghosts don't pile onto the same target, and ticks every ghost's
+ * behavior tree itself, spreading them across frames under a per-frame time budget.
+ * It also picks a perception LOD for every ghost based on how close the nearest player is,
+ * and sets the shared sight trace budget from how many ghosts are awake or chasing.
+ * The budgets and LOD tunables are set under [/Script/NetworkingPrototype.GhostDirectorSubsystem] in DefaultGame.ini.
+ */
+UCLASS(Config = Game)
+class NETWORKINGPROTOTYPE_API UGhostDirectorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject implementation
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Adds a ghost to the director and takes over ticking its behavior tree
+	void RegisterGhost(AGhostAIController* GhostController);
+
+	// Removes a ghost from the director, gives its behavior tree its own tick back and releases its target
+	void UnregisterGhost(AGhostAIController* GhostController);
+
+	// Marks Target as this ghost's target, pass nullptr to release the ghost's current target
+	void ClaimTarget(AGhostAIController* GhostController, AActor* Target);
+
+	// Can this ghost go after Target without stealing it from another ghost
+	bool CanClaimTarget(const AGhostAIController* GhostController, const AActor* Target) const;
+
+	// The ghost currently going after Target, if any
+	AGhostAIController* GetGhostTargeting(const AActor* Target) const;
+
+	// The world's Dungeon Generator, found once and shared by every ghost
+	ADungeonGenerator* GetDungeonGenerator();
+
+	// Number of ghosts registered with the director
+	int32 GetNumGhosts() const { return Ghosts.Num(); }
+
+	// The perception LOD the director last picked for this ghost
+	E_GhostPerceptionLOD GetPerceptionLOD(const AGhostAIController* GhostController) const;
+
+	// How many milliseconds per frame can be spent ticking behavior trees
+	UFUNCTION(BlueprintCallable, Category = "AI")
+	void SetBehaviorTreeBudget(const float BudgetMs) { BehaviorTreeBudgetMs = FMath::Max(0.0f, BudgetMs); }
+
+private:
+	// A ghost and everything the director tracks for it
+	struct FDirectedGhost
+	{
+		TWeakObjectPtr<AGhostAIController> Controller;
+		TWeakObjectPtr<UBehaviorTreeComponent> BehaviorTreeComponent;
+		TWeakObjectPtr<AActor> ClaimedTarget;
+
+		// Time since this ghost's behavior tree last ticked
+		float PendingBehaviorTreeDeltaTime = 0.0f;
+
+		// Has this ghost been hooked up to the Sound Manager yet
+		bool bRegisteredWithSoundManager = false;
+
+		// Current perception LOD, new ghosts start awake until the first LOD update
+		E_GhostPerceptionLOD PerceptionLOD = E_GhostPerceptionLOD::Normal;
+	};
+
+	// Picks every ghost's perception LOD and updates the sight trace budget to match
+	void UpdatePerceptionLOD();
+
+	// Turns a ghost's sight on or off to match its LOD
+	void ApplyPerceptionLOD(FDirectedGhost& Ghost, const E_GhostPerceptionLOD NewLOD) const;
+
+	// Ticks as many behavior trees as fit in the budget, picking up where last frame left off
+	void TickBehaviorTrees(const float DeltaTime);
+
+	// Hooks up any ghosts that aren't registered with the Sound Manager yet
+	void RegisterGhostsWithSoundManager();
+
+	// Finds the entry for a ghost
+	FDirectedGhost* FindGhost(const AGhostAIController* GhostController);
+	const FDirectedGhost* FindGhost(const AGhostAIController* GhostController) const;
+
+	// Every registered ghost
+	TArray<FDirectedGhost> Ghosts;
+
+	// Ghost whose behavior tree gets the first tick next frame
+	int32 NextBehaviorTreeIdx = 0;
+
+	// Are there ghosts waiting on the Sound Manager
+	bool bHasGhostsWaitingOnSoundManager = false;
+
+	// Cached world actors shared by every ghost
+	TWeakObjectPtr<ADungeonGenerator> DungeonGenerator;
+	bool bSearchedForDungeonGenerator = false;
+
+	// Time until the next perception LOD update
+	float TimeUntilPerceptionLODUpdate = 0.0f;
+
+	// How many milliseconds per frame can be spent ticking behavior trees
+	UPROPERTY(Config)
+	float BehaviorTreeBudgetMs = 1.0f;
+
+	// A behavior tree that has waited this long gets ticked even if the budget is spent,
+	// so no ghost ever stalls no matter how many there are
+	UPROPERTY(Config)
+	float MaxBehaviorTreeTickDelay = 0.25f;
+
+	// How often perception LODs are picked, in seconds
+	UPROPERTY(Config)
+	float PerceptionLODUpdateInterval = 0.5f;
+
+	// A ghost with no player within this distance goes dormant, keep it past the ghosts' sight radius
+	UPROPERTY(Config)
+	float PerceptionWakeRadius = 3000.0f;
+
+	// Sight traces per frame each awake or chasing ghost adds to the shared budget
+	UPROPERTY(Config)
+	int32 NormalSightTracesPerGhost = 2;
+	UPROPERTY(Config)
+	int32 ChasingSightTracesPerGhost = 6;
+
+	// The shared sight budget never goes past this many traces per frame
+	UPROPERTY(Config)
+	int32 MaxSightTracesPerFrame = 32;
+};
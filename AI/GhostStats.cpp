@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GhostStats.h"
+
+DEFINE_STAT(STAT_GhostDirectorTick);
+DEFINE_STAT(STAT_GhostBehaviorTreeTick);
+DEFINE_STAT(STAT_GhostPerceptionLOD);
+DEFINE_STAT(STAT_GhostSight);
+DEFINE_STAT(STAT_GhostHauntLoop);
+
+// Captured by default so a plain "csvprofile start" picks the ghost stats up
+CSV_DEFINE_CATEGORY_MODULE(NETWORKINGPROTOTYPE_API, Ghost, true);
+
+#if !UE_BUILD_SHIPPING
+FGhostLoopTimings& FGhostLoopTimings::Get()
+{
+	static FGhostLoopTimings Timings;
+	return Timings;
+}
+#endif
@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+/**
+ * Profiling stats for the ghost haunt and kill loop.
+ * Cycle stats show up under "stat Ghost" in game. The CSV stats go into the "Ghost" category of a
+ * CSV profiler capture ("csvprofile start" / "csvprofile stop", or -csvCaptureFrames on a -nullrhi server),
+ * next to the engine's own frame time and networking columns, so captures from two builds can be diffed.
+ */
+
+DECLARE_STATS_GROUP(TEXT("Ghost"), STATGROUP_Ghost, STATCAT_Advanced);
+
+// Time spent in the Ghost Director's tick, behavior trees included
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ghost Director Tick"), STAT_GhostDirectorTick, STATGROUP_Ghost, NETWORKINGPROTOTYPE_API);
+
+// Time spent ticking ghost behavior trees
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ghost Behavior Trees"), STAT_GhostBehaviorTreeTick, STATGROUP_Ghost, NETWORKINGPROTOTYPE_API);
+
+// Time spent picking perception LODs
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ghost Perception LOD"), STAT_GhostPerceptionLOD, STATGROUP_Ghost, NETWORKINGPROTOTYPE_API);
+
+// Time spent in the ghost sight sense, traces included
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ghost Sight"), STAT_GhostSight, STATGROUP_Ghost, NETWORKINGPROTOTYPE_API);
+
+// Time spent running the haunt and kill steps on the ghost controller
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Ghost Haunt Loop"), STAT_GhostHauntLoop, STATGROUP_Ghost, NETWORKINGPROTOTYPE_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(NETWORKINGPROTOTYPE_API, Ghost);
+
+// Running totals of the same scopes in seconds, for the haunt loop benchmark to read back and write out.
+// Stats and CSV captures only exist while a capture is running, these are always there outside of Shipping.
+#if !UE_BUILD_SHIPPING
+struct NETWORKINGPROTOTYPE_API FGhostLoopTimings
+{
+	double DirectorSeconds = 0.0;
+	double BehaviorTreeSeconds = 0.0;
+	double PerceptionLODSeconds = 0.0;
+	double SightSeconds = 0.0;
+	double HauntLoopSeconds = 0.0;
+
+	// The one set of totals, game thread only
+	static FGhostLoopTimings& Get();
+
+	void Reset() { *this = FGhostLoopTimings(); }
+};
+
+// Adds the time spent in the rest of the scope to one of the totals above
+#define GHOST_LOOP_TIMING_SCOPE(Total) FScopedDurationTimer ANONYMOUS_VARIABLE(GhostLoopTiming)(FGhostLoopTimings::Get().Total)
+#else
+#define GHOST_LOOP_TIMING_SCOPE(Total)
+#endif
@@ -5,6 +5,7 @@
 
 #include "HiddenActor_Footprint.h"
 #include "Kismet/GameplayStatics.h"
+#include "NetworkingPrototype/Managers/FootprintPoolSubsystem.h"
 #include "NetworkingPrototype/GameStates/QueriesUnlimitedGameState.h"
 
 // Sets default values for this component's properties
@@ -23,8 +24,12 @@ void UFootprintComponent::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// ...
-	
+	// Make sure the world's footprint pool is built before our first step
+	if (UFootprintPoolSubsystem* FootprintPool = GetWorld()->GetSubsystem<UFootprintPoolSubsystem>())
+	{
+		FootprintPool->ConfigurePool(FootprintBP, FootprintStorageMode, FootprintPoolCapacity, FootprintLifetime,
+			MaxRevealedFootprints);
+	}
 }
 
 
@@ -78,32 +83,23 @@ bool UFootprintComponent::Server_SpawnFootprint_Validate(USkeletalMeshComponent*
 
 void UFootprintComponent::Multicast_SpawnFootprint_Implementation(USkeletalMeshComponent* MeshComp, E_FootEmum FootSelection, int PlayerIdx)
 {
-	// Setup variables for our foot selection
-	AHiddenActor_Footprint* RightFootprintActor = nullptr;
-	AHiddenActor_Footprint* LeftFootprintActor = nullptr;
-	const FName RightFootSocketName = FName("foot_r_Socket");
-	const FName LeftFootSocketName = FName("foot_l_Socket");
-	const FTransform LeftFootSocketTransform = MeshComp->GetSocketTransform(LeftFootSocketName);
-	const FTransform RightFootSocketTransform = MeshComp->GetSocketTransform(RightFootSocketName);
-	
-	switch (FootSelection)
+	if (!MeshComp)
 	{
-	case E_FootEmum::LeftFoot:
-		// Spawn the footprint actor
-			LeftFootprintActor = MeshComp->GetWorld()->SpawnActor<AHiddenActor_Footprint>(FootprintBP,
-				LeftFootSocketTransform.GetLocation(), LeftFootSocketTransform.GetRotation().Rotator());
-
-		// Change the footprint decal's color and material depending on the foot placed and player idx
-		LeftFootprintActor->ChangeFootprintColor(PlayerIdx, E_FootEmum::LeftFoot);
-		break;
-		
-	case E_FootEmum::RightFoot:
-		// Spawn the footprint actor
-			RightFootprintActor = MeshComp->GetWorld()->SpawnActor<AHiddenActor_Footprint>(FootprintBP,
-				RightFootSocketTransform.GetLocation(), RightFootSocketTransform.GetRotation().Rotator());
-
-		// Change the footprint decal's color and material depending on the foot placed and player idx
-		RightFootprintActor->ChangeFootprintColor(PlayerIdx, E_FootEmum::RightFoot);
-		break;
+		return;
 	}
-}
\ No newline at end of file
+
+	UFootprintPoolSubsystem* FootprintPool = MeshComp->GetWorld()->GetSubsystem<UFootprintPoolSubsystem>();
+	if (!FootprintPool)
+	{
+		return;
+	}
+
+	// Only look up the socket of the foot that was placed
+	const FName FootSocketName = (FootSelection == E_FootEmum::LeftFoot) ? FName("foot_l_Socket") : FName("foot_r_Socket");
+	const FTransform FootSocketTransform = MeshComp->GetSocketTransform(FootSocketName);
+
+	// Take the next footprint from the pool, this recycles the oldest one if the pool is full.
+	// The pool also changes the footprint decal's color and material depending on the foot placed and player idx
+	FootprintPool->PlaceFootprint(FTransform(FootSocketTransform.GetRotation(), FootSocketTransform.GetLocation()),
+		PlayerIdx, FootSelection);
+}
@@ -16,6 +16,15 @@ enum class E_FootEmum : uint8
 	RightFoot  UMETA(DisplayName = "Right Foot")
 };
 
+UENUM(BlueprintType)
+enum class E_FootprintStorageMode : uint8
+{
+	// Every footprint is a pooled footprint actor the magnifying glass sweeps against
+	Actors UMETA(DisplayName = "Actors"),
+	// Footprints are plain records, only the ones being revealed get drawn with a decal
+	Records UMETA(DisplayName = "Records")
+};
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class NETWORKINGPROTOTYPE_API UFootprintComponent : public UActorComponent
 {
@@ -33,6 +42,27 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Spawn");
 	TSubclassOf<AHiddenActor_Footprint> FootprintBP;
 
+	// Max number of footprints alive in the world at once, shared by every player.
+	// Once reached, the oldest footprint gets recycled for the new step.
+	// Only the first footprint component to begin play sizes the pool.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Pool", meta = (ClampMin = "1"))
+	int32 FootprintPoolCapacity = 512;
+
+	// How long a footprint stays in the world before it ages out, in seconds.
+	// 0 keeps footprints until they get recycled. Every player shares the pool, so it uses the longest lifetime any of them has.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Pool", meta = (ClampMin = "0.0"))
+	float FootprintLifetime = 120.0f;
+
+	// How the pool stores footprints. Records skips the per footprint actor,
+	// components and physics bodies entirely.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Pool")
+	E_FootprintStorageMode FootprintStorageMode = E_FootprintStorageMode::Actors;
+
+	// Max number of footprints a magnifying glass can reveal at once in Records mode.
+	// This is the number of decal components the pool keeps around per magnifying glass to draw them.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Pool", meta = (ClampMin = "1", EditCondition = "FootprintStorageMode == E_FootprintStorageMode::Records"))
+	int32 MaxRevealedFootprints = 64;
+
 public:	
 	// Called every frame
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
@@ -0,0 +1,224 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetworkingPrototype/Components/HoldInteractionComponent.h"
+
+#include "Curves/CurveFloat.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "Net/UnrealNetwork.h"
+#include "NetworkingPrototype/Managers/HoldInteractionSubsystem.h"
+
+// Sets default values for this component's properties
+UHoldInteractionComponent::UHoldInteractionComponent()
+{
+	// Active holds are ticked by the Hold Interaction Subsystem, never on their own
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicatedByDefault(true);
+}
+
+void UHoldInteractionComponent::StartHold(AActor* Interactor)
+{
+	if (!GetOwner()->HasAuthority() || !Interactor || InteractingPlayers.Contains(Interactor))
+	{
+		return;
+	}
+
+	const bool bWasActive = IsHoldActive();
+	InteractingPlayers.Add(Interactor);
+	UpdateHoldRate();
+
+	// Let the subsystem tick us while anyone is holding
+	if (!bWasActive)
+	{
+		if (UHoldInteractionSubsystem* HoldInteractions = GetWorld()->GetSubsystem<UHoldInteractionSubsystem>())
+		{
+			HoldInteractions->RegisterActiveHold(this);
+		}
+	}
+}
+
+void UHoldInteractionComponent::StopHold(AActor* Interactor)
+{
+	if (!GetOwner()->HasAuthority() || !InteractingPlayers.Contains(Interactor))
+	{
+		return;
+	}
+
+	InteractingPlayers.Remove(Interactor);
+
+	if (InteractingPlayers.Num() == 0) // No more players interacting
+	{
+		CancelHold();
+	}
+	else
+	{
+		// Slow the hold down to the players that are left
+		UpdateHoldRate();
+	}
+}
+
+void UHoldInteractionComponent::CancelHold()
+{
+	if (!GetOwner()->HasAuthority())
+	{
+		return;
+	}
+
+	ResetHold();
+	OnHoldCanceled.Broadcast();
+}
+
+float UHoldInteractionComponent::GetProgress() const
+{
+	return HoldProgress.GetProgressAt(GetServerTime());
+}
+
+float UHoldInteractionComponent::GetTotalHoldTime() const
+{
+	return HoldProgress.Rate > 0.0f ? 1.0f / HoldProgress.Rate : HoldTime;
+}
+
+void UHoldInteractionComponent::TickHold(const float ServerTime, const bool bCheckFocus)
+{
+	// Players who left or died never send a stop, so they're dropped every tick whatever the focus test is
+	const bool bRunFocusTest = bCheckFocus && FocusTest != E_HoldFocusTest::None;
+
+	// Go backwards so players can be dropped as we go
+	bool bDroppedPlayers = false;
+	for (int32 PlayerIdx = InteractingPlayers.Num() - 1; PlayerIdx >= 0; PlayerIdx--)
+	{
+		const AActor* Interactor = InteractingPlayers[PlayerIdx];
+		if (!IsInteractorValid(Interactor) || (bRunFocusTest && !PassesFocusTest(Interactor)))
+		{
+			InteractingPlayers.RemoveAt(PlayerIdx);
+			bDroppedPlayers = true;
+		}
+	}
+
+	if (bDroppedPlayers)
+	{
+		if (InteractingPlayers.Num() == 0)
+		{
+			CancelHold();
+			return;
+		}
+
+		UpdateHoldRate();
+	}
+
+	if (HoldProgress.GetProgressAt(ServerTime) >= 1.0f)
+	{
+		ResetHold();
+		OnHoldCompleted.Broadcast();
+	}
+}
+
+void UHoldInteractionComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Make sure the subsystem never ticks a destroyed component
+	if (UWorld* World = GetWorld())
+	{
+		if (UHoldInteractionSubsystem* HoldInteractions = World->GetSubsystem<UHoldInteractionSubsystem>())
+		{
+			HoldInteractions->UnregisterActiveHold(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UHoldInteractionComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(UHoldInteractionComponent, InteractingPlayers);
+	DOREPLIFETIME(UHoldInteractionComponent, HoldProgress);
+}
+
+void UHoldInteractionComponent::OnRep_InteractingPlayers()
+{
+	OnHoldStateChanged.Broadcast();
+}
+
+void UHoldInteractionComponent::OnRep_HoldProgress()
+{
+	OnHoldStateChanged.Broadcast();
+}
+
+void UHoldInteractionComponent::UpdateHoldRate()
+{
+	// Close off the current progress segment and start a new one at the new rate
+	const float ServerTime = GetServerTime();
+	const float Progress = HoldProgress.GetProgressAt(ServerTime);
+
+	const int32 PlayerCount = InteractingPlayers.Num();
+	const float SpeedMultiplier = RateCurve ? RateCurve->GetFloatValue(PlayerCount) : static_cast<float>(PlayerCount);
+
+	HoldProgress.ProgressAtStart = Progress;
+	HoldProgress.StartServerTime = ServerTime;
+	HoldProgress.Rate = (PlayerCount > 0 && HoldTime > 0.0f) ? FMath::Max(0.0f, SpeedMultiplier) / HoldTime : 0.0f;
+
+	OnHoldStateChanged.Broadcast();
+}
+
+void UHoldInteractionComponent::ResetHold()
+{
+	InteractingPlayers.Empty();
+	HoldProgress = FHoldInteractionProgress();
+
+	if (UHoldInteractionSubsystem* HoldInteractions = GetWorld()->GetSubsystem<UHoldInteractionSubsystem>())
+	{
+		HoldInteractions->UnregisterActiveHold(this);
+	}
+
+	OnHoldStateChanged.Broadcast();
+}
+
+bool UHoldInteractionComponent::IsInteractorValid(const AActor* Interactor)
+{
+	// Players without a controller can't be holding anything
+	const APawn* Pawn = Cast<APawn>(Interactor);
+	return IsValid(Pawn) && IsValid(Pawn->GetController());
+}
+
+bool UHoldInteractionComponent::PassesFocusTest(const AActor* Interactor) const
+{
+	const APawn* Pawn = Cast<APawn>(Interactor);
+	const AController* Controller = Pawn ? Pawn->GetController() : nullptr;
+	if (!Controller)
+	{
+		return false;
+	}
+
+	switch (FocusTest)
+	{
+		case E_HoldFocusTest::ViewDirection:
+		{
+			FVector PlayerViewLocation;
+			FRotator PlayerViewRotation;
+			Controller->GetPlayerViewPoint(PlayerViewLocation, PlayerViewRotation);
+
+			// Calculate if the object is within the player's view
+			const FVector DirectionToOwner = (GetOwner()->GetActorLocation() - PlayerViewLocation).GetSafeNormal();
+			return FVector::DotProduct(PlayerViewRotation.Vector(), DirectionToOwner) >= MinFocusDot;
+		}
+
+		case E_HoldFocusTest::None:
+		default:
+			return true;
+	}
+}
+
+float UHoldInteractionComponent::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return 0.0f;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
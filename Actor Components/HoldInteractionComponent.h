@@ -0,0 +1,161 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "HoldInteractionComponent.generated.h"
+
+class UCurveFloat;
+
+UENUM(BlueprintType)
+enum class E_HoldFocusTest : uint8
+{
+	// The server doesn't check focus, players let go when their interaction focus moves off the object
+	None UMETA(DisplayName = "None"),
+	// The server also checks that every holding player is still looking towards the object
+	ViewDirection UMETA(DisplayName = "View Direction")
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnHoldInteractionCompleted);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnHoldInteractionCanceled);
+
+// Hold progress stored as where it was when the interactor count last changed and how fast it's moving since,
+// so it only needs to replicate when someone starts or stops holding
+USTRUCT()
+struct FHoldInteractionProgress
+{
+	GENERATED_BODY()
+
+	// Progress (0 to 1) at StartServerTime
+	UPROPERTY()
+	float ProgressAtStart = 0.0f;
+
+	// Server world time this progress segment started at
+	UPROPERTY()
+	float StartServerTime = 0.0f;
+
+	// Progress gained per second, 0 when nobody is holding
+	UPROPERTY()
+	float Rate = 0.0f;
+
+	// Progress at the passed in server world time
+	float GetProgressAt(const float ServerTime) const
+	{
+		return FMath::Clamp(ProgressAtStart + Rate * FMath::Max(0.0f, ServerTime - StartServerTime), 0.0f, 1.0f);
+	}
+};
+
+/**
+ * Cooperative hold to interact, shared by anything players revive, repair or channel together.
+ * The owning actor implements IInteractableInterface and forwards its hold functions here.
+ * Every change goes through the server: starting, stopping, the focus test and completion.
+ * Progress replicates as a rate model, so clients work out the current progress themselves.
+ * Active holds are ticked together by the Hold Interaction Subsystem instead of each owning a timer.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class NETWORKINGPROTOTYPE_API UHoldInteractionComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UHoldInteractionComponent();
+
+	// Adds a player to the hold, server only
+	void StartHold(AActor* Interactor);
+
+	// Removes a player from the hold, cancels it if they were the last one, server only
+	void StopHold(AActor* Interactor);
+
+	// Drops every player and resets progress, server only
+	void CancelHold();
+
+	// Current progress (0 to 1), worked out locally from the replicated progress model
+	float GetProgress() const;
+
+	// How long the hold takes from empty at the current rate, in seconds
+	float GetTotalHoldTime() const;
+
+	// How much of the total hold time has been done, in seconds
+	float GetCurrentHeldTime() const { return GetProgress() * GetTotalHoldTime(); }
+
+	// Number of players currently holding
+	int32 GetNumInteractors() const { return InteractingPlayers.Num(); }
+
+	// Is anyone holding right now
+	bool IsHoldActive() const { return InteractingPlayers.Num() > 0; }
+
+	// How the server checks that holding players are still at it, set before anyone starts holding
+	void SetFocusTest(const E_HoldFocusTest NewFocusTest) { FocusTest = NewFocusTest; }
+
+	// Called by the Hold Interaction Subsystem while the hold is active, server only.
+	// Drops players whose pawn or controller went away, runs the focus test if bCheckFocus is set,
+	// and completes the hold once progress reaches the end.
+	void TickHold(const float ServerTime, const bool bCheckFocus);
+
+	// Broadcast on the server when the hold completes
+	UPROPERTY(BlueprintAssignable, Category = "Hold Interaction")
+	FOnHoldInteractionCompleted OnHoldCompleted;
+
+	// Broadcast on the server when everyone lets go before the hold completes
+	UPROPERTY(BlueprintAssignable, Category = "Hold Interaction")
+	FOnHoldInteractionCanceled OnHoldCanceled;
+
+	// Broadcast on the server and clients whenever the hold rate or interactor count changes.
+	// Progress in between is linear, so listeners can cache it and extrapolate instead of polling.
+	FSimpleMulticastDelegate OnHoldStateChanged;
+
+protected:
+	// Called when the game ends or the component is destroyed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Used to replicate properties
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	UFUNCTION()
+	void OnRep_InteractingPlayers();
+
+	UFUNCTION()
+	void OnRep_HoldProgress();
+
+	// Starts a new progress segment at the rate for the current interactor count
+	void UpdateHoldRate();
+
+	// Resets the hold back to empty with nobody holding
+	void ResetHold();
+
+	// Is this player still around to hold, their pawn and its controller both have to exist
+	static bool IsInteractorValid(const AActor* Interactor);
+
+	// Does this player still pass the focus test
+	bool PassesFocusTest(const AActor* Interactor) const;
+
+	// Current server world time, the same clock on the server and every client
+	float GetServerTime() const;
+
+	// How long one player takes to complete the hold, in seconds
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hold Interaction", meta = (ClampMin = "0.01"))
+	float HoldTime = 5.0f;
+
+	// Speed multiplier by number of players holding (X = players, Y = multiplier).
+	// Leave empty to go as many times faster as there are players.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hold Interaction")
+	UCurveFloat* RateCurve = nullptr;
+
+	// How the server checks that holding players are still at it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hold Interaction")
+	E_HoldFocusTest FocusTest = E_HoldFocusTest::None;
+
+	// For the View Direction focus test, how far off the object players can look before they let go
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Hold Interaction", meta = (ClampMin = "-1.0", ClampMax = "1.0"))
+	float MinFocusDot = 0.8f;
+
+	// Replicated Array of all currently Interacting Players
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, ReplicatedUsing = OnRep_InteractingPlayers, Category = "Hold Interaction")
+	TArray<AActor*> InteractingPlayers;
+
+	// Replicated progress model, only changes when the interactor count does
+	UPROPERTY(ReplicatedUsing = OnRep_HoldProgress)
+	FHoldInteractionProgress HoldProgress;
+};
@@ -0,0 +1,271 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetworkingPrototype/Components/QUCharacterMovementComponent.h"
+
+#include "GameFramework/Character.h"
+#include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
+
+// Sets default values for this component's properties
+UQUCharacterMovementComponent::UQUCharacterMovementComponent()
+{
+	Stamina = MaxStamina;
+
+	SetMoveResponseDataContainer(QUMoveResponseDataContainer);
+}
+
+void UQUCharacterMovementComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Start with a full sprint bar
+	Stamina = MaxStamina;
+}
+
+void UQUCharacterMovementComponent::UpdateCharacterStateBeforeMovement(float DeltaSeconds)
+{
+	Super::UpdateCharacterStateBeforeMovement(DeltaSeconds);
+
+	// New moves use what the player is pressing now, replayed moves keep what they were saved with
+	if (CharacterOwner && CharacterOwner->IsLocallyControlled() && !CharacterOwner->bClientUpdating)
+	{
+		bWantsToSprint = bSprintInput;
+	}
+}
+
+bool UQUCharacterMovementComponent::IsSprinting() const
+{
+	return bWantsToSprint && !bSprintExhausted && (bUnlimitedStamina || Stamina > 0.0f);
+}
+
+void UQUCharacterMovementComponent::SetUnlimitedStamina(const bool bNewUnlimitedStamina)
+{
+	if (GetOwnerRole() == ROLE_Authority && bUnlimitedStamina != bNewUnlimitedStamina)
+	{
+		bUnlimitedStamina = bNewUnlimitedStamina;
+		bForceStateCorrection = true;
+	}
+}
+
+void UQUCharacterMovementComponent::SetSpeedMultiplier(const float NewSpeedMultiplier)
+{
+	const float ClampedSpeedMultiplier = FMath::Max(0.0f, NewSpeedMultiplier);
+	if (GetOwnerRole() == ROLE_Authority && SpeedMultiplier != ClampedSpeedMultiplier)
+	{
+		SpeedMultiplier = ClampedSpeedMultiplier;
+		bForceStateCorrection = true;
+	}
+}
+
+float UQUCharacterMovementComponent::GetMaxSpeed() const
+{
+	float MaxSpeed = Super::GetMaxSpeed();
+
+	if (MovementMode == MOVE_Walking || MovementMode == MOVE_NavWalking)
+	{
+		if (IsSprinting())
+		{
+			MaxSpeed *= SprintSpeedMultiplier;
+		}
+
+		MaxSpeed *= SpeedMultiplier;
+	}
+
+	return MaxSpeed;
+}
+
+void UQUCharacterMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	bWantsToSprint = (Flags & FSavedMove_Character::FLAG_Custom_0) != 0;
+}
+
+FNetworkPredictionData_Client* UQUCharacterMovementComponent::GetPredictionData_Client() const
+{
+	if (ClientPredictionData == nullptr)
+	{
+		UQUCharacterMovementComponent* MutableThis = const_cast<UQUCharacterMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_QUCharacter(*this);
+	}
+
+	return ClientPredictionData;
+}
+
+bool UQUCharacterMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel,
+	const FVector& ClientLoc, const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName,
+	uint8 ClientMovementMode)
+{
+	// The client predicted this move with the old state, correct it so it replays with the new one
+	if (bForceStateCorrection)
+	{
+		bForceStateCorrection = false;
+		return true;
+	}
+
+	return Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase,
+		ClientBaseBoneName, ClientMovementMode);
+}
+
+void UQUCharacterMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	// The correction is the server's state at the corrected move, every move after it replays from there.
+	// Our container is the only one we ever register, so the cast is safe.
+	if (MoveResponse.IsCorrection())
+	{
+		const FQUCharacterMoveResponseDataContainer& QUMoveResponse = static_cast<const FQUCharacterMoveResponseDataContainer&>(MoveResponse);
+		Stamina = QUMoveResponse.Stamina;
+		bSprintExhausted = QUMoveResponse.bSprintExhausted;
+		bUnlimitedStamina = QUMoveResponse.bUnlimitedStamina;
+		SpeedMultiplier = QUMoveResponse.SpeedMultiplier;
+	}
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
+void UQUCharacterMovementComponent::OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity)
+{
+	Super::OnMovementUpdated(DeltaSeconds, OldLocation, OldVelocity);
+
+	// Simulated proxies just follow the server, only the owner and the server run stamina
+	if (CharacterOwner && CharacterOwner->GetLocalRole() > ROLE_SimulatedProxy)
+	{
+		UpdateStamina(DeltaSeconds);
+	}
+}
+
+void UQUCharacterMovementComponent::UpdateStamina(const float DeltaSeconds)
+{
+	// Letting go of sprint lets the player sprint again
+	if (!bWantsToSprint)
+	{
+		bSprintExhausted = false;
+	}
+
+	if (IsSprinting())
+	{
+		//Depleting
+		if (!bUnlimitedStamina)
+		{
+			Stamina = FMath::Max(0.0f, Stamina - StaminaDrainRate * DeltaSeconds);
+			if (Stamina <= 0.0f)
+			{
+				bSprintExhausted = true;
+			}
+		}
+	}
+	//Only Start Refilling Bar When Player Releases Sprint Button
+	else if (!bWantsToSprint && !bUnlimitedStamina)
+	{
+		Stamina = FMath::Min(MaxStamina, Stamina + StaminaRefillRate * DeltaSeconds);
+	}
+
+	// Tell the character when sprinting starts or stops, but not while replaying moves we already told it about
+	const bool bIsSprinting = IsSprinting();
+	if (bIsSprinting != bWasSprinting && !CharacterOwner->bClientUpdating)
+	{
+		bWasSprinting = bIsSprinting;
+
+		if (ANetworkingPrototypeCharacter* Character = Cast<ANetworkingPrototypeCharacter>(CharacterOwner))
+		{
+			if (bIsSprinting)
+			{
+				Character->OnStartSprint.Broadcast();
+			}
+			else
+			{
+				Character->OnStopSprint.Broadcast();
+			}
+		}
+	}
+}
+
+void FSavedMove_QUCharacter::Clear()
+{
+	Super::Clear();
+
+	bSavedWantsToSprint = false;
+}
+
+uint8 FSavedMove_QUCharacter::GetCompressedFlags() const
+{
+	uint8 Result = Super::GetCompressedFlags();
+
+	if (bSavedWantsToSprint)
+	{
+		Result |= FLAG_Custom_0;
+	}
+
+	return Result;
+}
+
+bool FSavedMove_QUCharacter::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	// Never merge the move that presses or releases sprint into another one
+	if (bSavedWantsToSprint != static_cast<FSavedMove_QUCharacter*>(NewMove.Get())->bSavedWantsToSprint)
+	{
+		return false;
+	}
+
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_QUCharacter::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel,
+	FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	if (const UQUCharacterMovementComponent* MovementComponent = Cast<UQUCharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		// Moves are saved before they're performed, so take the input the move is about to use
+		bSavedWantsToSprint = MovementComponent->bSprintInput;
+	}
+}
+
+void FSavedMove_QUCharacter::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// Only the input is put back, stamina carries on from the server's correction through the whole replay
+	if (UQUCharacterMovementComponent* MovementComponent = Cast<UQUCharacterMovementComponent>(C->GetCharacterMovement()))
+	{
+		MovementComponent->bWantsToSprint = bSavedWantsToSprint;
+	}
+}
+
+void FQUCharacterMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement,
+	const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	const UQUCharacterMovementComponent& MovementComponent = static_cast<const UQUCharacterMovementComponent&>(CharacterMovement);
+	Stamina = MovementComponent.Stamina;
+	bSprintExhausted = MovementComponent.bSprintExhausted;
+	bUnlimitedStamina = MovementComponent.bUnlimitedStamina;
+	SpeedMultiplier = MovementComponent.SpeedMultiplier;
+}
+
+bool FQUCharacterMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar,
+	UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+	{
+		return false;
+	}
+
+	// Good move acks stay as small as before, only corrections carry the sprint state
+	if (IsCorrection())
+	{
+		Ar << Stamina;
+		Ar << bSprintExhausted;
+		Ar << bUnlimitedStamina;
+		Ar << SpeedMultiplier;
+	}
+
+	return !Ar.IsError();
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_QUCharacter::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_QUCharacter());
+}
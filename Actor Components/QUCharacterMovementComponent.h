@@ -0,0 +1,162 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "QUCharacterMovementComponent.generated.h"
+
+// Move response that also carries the server's sprint state when it corrects the client
+struct FQUCharacterMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+	float Stamina = 0.0f;
+	bool bSprintExhausted = false;
+	bool bUnlimitedStamina = false;
+	float SpeedMultiplier = 1.0f;
+};
+
+/**
+ * Character movement with predicted sprinting.
+ * Whether the player wants to sprint rides along with every saved move as a compressed flag,
+ * and stamina is simulated from it on both the owning client and the server,
+ * so sprinting needs no RPCs and the client never gets pulled back when it starts or stops.
+ * Server corrections carry stamina, unlimited stamina and the speed multiplier, so the client
+ * replays its moves from the server's state instead of its own prediction.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UQUCharacterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+	friend class FSavedMove_QUCharacter;
+	friend struct FQUCharacterMoveResponseDataContainer;
+
+public:
+	// Sets default values for this component's properties
+	UQUCharacterMovementComponent();
+
+	// Sprint input, call on the locally controlled character
+	void SetWantsToSprint(const bool bNewWantsToSprint) { bSprintInput = bNewWantsToSprint; }
+
+	// Is the character sprinting right now
+	bool IsSprinting() const;
+
+	// Stamina left (0 to 1)
+	float GetStaminaPercentage() const { return MaxStamina > 0.0f ? Stamina / MaxStamina : 0.0f; }
+
+	// Sprint without using stamina, server only.
+	// Reaches the owning client with the next move correction, so both switch over on the same move.
+	void SetUnlimitedStamina(const bool bNewUnlimitedStamina);
+
+	// Scales walking and sprinting speed, EX: carrying a slate. Server only.
+	// Reaches the owning client with the next move correction, so both switch over on the same move.
+	void SetSpeedMultiplier(const float NewSpeedMultiplier);
+
+	// Sprinting speed before any speed multiplier
+	float GetBaseSprintSpeed() const { return MaxWalkSpeed * SprintSpeedMultiplier; }
+
+	// --- UCharacterMovementComponent overrides ---
+	virtual float GetMaxSpeed() const override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+	// --- UCharacterMovementComponent overrides END ---
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Picks up the latest sprint input before each new move
+	virtual void UpdateCharacterStateBeforeMovement(float DeltaSeconds) override;
+
+	// Sends a correction after the server changed unlimited stamina or the speed multiplier
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc,
+		const FVector& RelativeClientLoc, UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName,
+		uint8 ClientMovementMode) override;
+
+	// Takes the server's sprint state from a correction before the client replays its moves
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+
+	// Runs after every move, on the owning client, when replaying moves and on the server
+	virtual void OnMovementUpdated(float DeltaSeconds, const FVector& OldLocation, const FVector& OldVelocity) override;
+
+	// Steps stamina forward by one move
+	void UpdateStamina(const float DeltaSeconds);
+
+	// How much faster than walking sprinting is
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Sprint", meta = (ClampMin = "1.0"))
+	float SprintSpeedMultiplier = 2.0f;
+
+	// The maximum value the sprint bar can hold
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Sprint", meta = (ClampMin = "0.0"))
+	float MaxStamina = 100.0f;
+
+	// Stamina used per second while sprinting
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Sprint", meta = (ClampMin = "0.0"))
+	float StaminaDrainRate = 50.0f;
+
+	// Stamina regained per second once the player lets go of sprint
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Character Movement: Sprint", meta = (ClampMin = "0.0"))
+	float StaminaRefillRate = 50.0f;
+
+private:
+	// Is the sprint input held right now, local player only
+	bool bSprintInput = false;
+
+	// Is the sprint input held for the move being simulated
+	bool bWantsToSprint = false;
+
+	// Ran out of stamina, no sprinting until sprint is let go and pressed again
+	bool bSprintExhausted = false;
+
+	// Stamina left, simulated the same way on the owning client and the server
+	float Stamina = 0.0f;
+
+	// Last sprint state we told the character about
+	bool bWasSprinting = false;
+
+	// Set by the server while something gives unlimited sprint, the owning client gets it from corrections
+	bool bUnlimitedStamina = false;
+
+	// Set by the server while something slows the character down, the owning client gets it from corrections
+	float SpeedMultiplier = 1.0f;
+
+	// The server changed unlimited stamina or the speed multiplier and the owning client hasn't been corrected yet
+	bool bForceStateCorrection = false;
+
+	// Move response that carries the sprint state
+	FQUCharacterMoveResponseDataContainer QUMoveResponseDataContainer;
+};
+
+// A saved move that also remembers the sprint input for replaying
+class FSavedMove_QUCharacter : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	// --- FSavedMove_Character overrides ---
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+	// --- FSavedMove_Character overrides END ---
+
+private:
+	bool bSavedWantsToSprint = false;
+};
+
+// Hands out our saved moves instead of the default ones
+class FNetworkPredictionData_Client_QUCharacter : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_QUCharacter(const UCharacterMovementComponent& ClientMovement) : Super(ClientMovement) {}
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
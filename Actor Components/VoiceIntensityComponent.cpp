@@ -0,0 +1,235 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetworkingPrototype/Components/VoiceIntensityComponent.h"
+
+#include "GameFramework/Character.h"
+#include "NetworkingPrototype/GameStates/QueriesUnlimitedGameState.h"
+#include "NetworkingPrototype/Managers/SoundManager.h"
+
+DEFINE_LOG_CATEGORY(LogVoiceIntensity);
+
+namespace
+{
+	// 16 bit samples are converted in blocks this big so the float kernel can stay vectorized
+	constexpr int32 PCMBlockSize = 256;
+
+	// Mean of the squared samples, four at a time
+	float ComputeMeanSquare(const float* Samples, int32 NumSamples)
+	{
+		VectorRegister4Float SumSquares = VectorZeroFloat();
+		int32 SampleIdx = 0;
+		for (; SampleIdx + 4 <= NumSamples; SampleIdx += 4)
+		{
+			const VectorRegister4Float Sample = VectorLoad(&Samples[SampleIdx]);
+			SumSquares = VectorMultiplyAdd(Sample, Sample, SumSquares);
+		}
+
+		float Lanes[4];
+		VectorStore(SumSquares, Lanes);
+		float Sum = Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+
+		// Whatever didn't fill a full register
+		for (; SampleIdx < NumSamples; SampleIdx++)
+		{
+			Sum += Samples[SampleIdx] * Samples[SampleIdx];
+		}
+
+		return NumSamples > 0 ? Sum / NumSamples : 0.0f;
+	}
+}
+
+// Sets default values for this component's properties
+UVoiceIntensityComponent::UVoiceIntensityComponent()
+{
+	// Frames come in from the voice capture, ticking only closes report windows once the player goes quiet
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickInterval = 0.05f;
+
+	SetIsReplicatedByDefault(true);
+}
+
+// Called when the game starts
+void UVoiceIntensityComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Nobody talks into a dedicated server
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		SetComponentTickEnabled(false);
+	}
+}
+
+// Called when the component is being removed
+void UVoiceIntensityComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	FlushVoiceIntensity();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+// Called every frame
+void UVoiceIntensityComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Once frames stop coming in stop reporting the last one, and still close the report window on time
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	if (LastFrameTime >= 0.0 && CurrentTime - LastFrameTime >= ReportInterval)
+	{
+		CurrentIntensity = 0.0f;
+	}
+	if (WindowIntensity > 0.0f && CurrentTime - WindowStartTime >= ReportInterval)
+	{
+		SendWindowIntensity();
+	}
+}
+
+void UVoiceIntensityComponent::AnalyzeVoiceFrame(TArrayView<const float> Samples, int32 SampleRate)
+{
+	if (Samples.Num() == 0 || SampleRate <= 0)
+	{
+		return;
+	}
+
+	const float MeanSquare = ComputeMeanSquare(Samples.GetData(), Samples.Num());
+	AccumulateIntensity(CalibrateFrame(MeanSquare, static_cast<float>(Samples.Num()) / SampleRate));
+}
+
+void UVoiceIntensityComponent::AnalyzeVoiceFrame(TArrayView<const int16> Samples, int32 SampleRate)
+{
+	if (Samples.Num() == 0 || SampleRate <= 0)
+	{
+		return;
+	}
+
+	// Convert to -1 to 1 a block at a time and add up each block's squares
+	float Block[PCMBlockSize];
+	float SumSquares = 0.0f;
+	for (int32 BlockStart = 0; BlockStart < Samples.Num(); BlockStart += PCMBlockSize)
+	{
+		const int32 BlockNum = FMath::Min(PCMBlockSize, Samples.Num() - BlockStart);
+		for (int32 SampleIdx = 0; SampleIdx < BlockNum; SampleIdx++)
+		{
+			Block[SampleIdx] = Samples[BlockStart + SampleIdx] / 32768.0f;
+		}
+		SumSquares += ComputeMeanSquare(Block, BlockNum) * BlockNum;
+	}
+
+	const float MeanSquare = SumSquares / Samples.Num();
+	AccumulateIntensity(CalibrateFrame(MeanSquare, static_cast<float>(Samples.Num()) / SampleRate));
+}
+
+void UVoiceIntensityComponent::AnalyzeVoicePCM(const TArray<uint8>& PCMData, int32 SampleRate)
+{
+	AnalyzeVoiceFrame(TArrayView<const int16>(reinterpret_cast<const int16*>(PCMData.GetData()), PCMData.Num() / sizeof(int16)), SampleRate);
+}
+
+void UVoiceIntensityComponent::FlushVoiceIntensity()
+{
+	SendWindowIntensity();
+	CurrentIntensity = 0.0f;
+}
+
+float UVoiceIntensityComponent::CalibrateFrame(float MeanSquare, float FrameSeconds)
+{
+	LastFrameTime = GetWorld()->GetTimeSeconds();
+
+	// Loudness of the frame in dB below full scale
+	const float LevelDb = 10.0f * FMath::LogX(10.0f, FMath::Max(MeanSquare, 1.0e-10f));
+
+	// Every so often catch the noise floor up to the quietest frame since, in case the background
+	// got louder than the speech threshold and no frame gets rejected to move it up
+	NoiseWindowMinDb = FMath::Min(NoiseWindowMinDb, LevelDb);
+	NoiseWindowSeconds += FrameSeconds;
+	if (NoiseWindowSeconds >= NoiseFloorWindowSeconds)
+	{
+		if (NoiseWindowMinDb > NoiseFloorDb)
+		{
+			UE_LOG(LogVoiceIntensity, Verbose, TEXT("%s noise floor caught up from %.1f to %.1f dB."),
+				*GetNameSafe(GetOwner()), NoiseFloorDb, NoiseWindowMinDb);
+			NoiseFloorDb = NoiseWindowMinDb;
+		}
+		NoiseWindowMinDb = MAX_flt;
+		NoiseWindowSeconds = 0.0f;
+	}
+
+	// Noise floor drops to quieter frames right away
+	NoiseFloorDb = FMath::Min(NoiseFloorDb, LevelDb);
+
+	// Quiet enough to be background noise. Only these frames creep the noise floor up,
+	// speech never gets mistaken for background noise.
+	const float SpeechStartDb = NoiseFloorDb + VoiceActivityThresholdDb;
+	if (LevelDb < SpeechStartDb)
+	{
+		NoiseFloorDb = FMath::Min(LevelDb, NoiseFloorDb + NoiseFloorRiseRate * FrameSeconds);
+
+		CurrentIntensity = 0.0f;
+		return CurrentIntensity;
+	}
+
+	// Speech peak jumps to louder speech right away, and slowly falls back after
+	SpeechPeakDb = FMath::Max(LevelDb, SpeechPeakDb - PeakDecayRate * FrameSeconds);
+	SpeechPeakDb = FMath::Max(SpeechPeakDb, NoiseFloorDb + MinDynamicRangeDb);
+
+	// Where the frame sits between just barely speech and the loudest this player gets
+	CurrentIntensity = FMath::Clamp((LevelDb - SpeechStartDb) / FMath::Max(SpeechPeakDb - SpeechStartDb, 1.0f), 0.0f, 1.0f);
+	return CurrentIntensity;
+}
+
+void UVoiceIntensityComponent::AccumulateIntensity(float Intensity)
+{
+	WindowIntensity = FMath::Max(WindowIntensity, Intensity);
+
+	if (GetWorld()->GetTimeSeconds() - WindowStartTime >= ReportInterval)
+	{
+		SendWindowIntensity();
+	}
+}
+
+void UVoiceIntensityComponent::SendWindowIntensity()
+{
+	// Only the talking player's own machine reports their voice
+	const APawn* OwningPawn = Cast<APawn>(GetOwner());
+	if (WindowIntensity > 0.0f && OwningPawn && OwningPawn->IsLocallyControlled())
+	{
+		// Anything above zero still rounds to at least 1 so it isn't dropped
+		Server_ReportVoiceIntensity(static_cast<uint8>(FMath::Clamp(FMath::CeilToInt(WindowIntensity * 255.0f), 1, 255)));
+	}
+
+	WindowIntensity = 0.0f;
+	WindowStartTime = GetWorld()->GetTimeSeconds();
+}
+
+void UVoiceIntensityComponent::Server_ReportVoiceIntensity_Implementation(uint8 QuantizedIntensity)
+{
+	ACharacter* OwningCharacter = Cast<ACharacter>(GetOwner());
+	if (!OwningCharacter || QuantizedIntensity == 0)
+	{
+		return;
+	}
+
+	// Drop reports coming in faster than the client is supposed to send them
+	const double CurrentTime = GetWorld()->GetTimeSeconds();
+	if (LastServerReportTime >= 0.0 && CurrentTime - LastServerReportTime < ReportInterval * 0.5f)
+	{
+		return;
+	}
+	LastServerReportTime = CurrentTime;
+
+	// The Sound Manager is stored on the Game State
+	const AQueriesUnlimitedGameState* QUGameState = GetWorld()->GetGameState<AQueriesUnlimitedGameState>();
+	ASoundManager* SoundManager = QUGameState ? QUGameState->SoundManager : nullptr;
+	if (!SoundManager)
+	{
+		return;
+	}
+
+	FSoundEvent SoundEvent;
+	SoundEvent.Character = OwningCharacter;
+	SoundEvent.Location = OwningCharacter->GetActorLocation();
+	SoundEvent.Intensity = QuantizedIntensity / 255.0f;
+	SoundEvent.SoundType = E_SoundEventType::Voice;
+	SoundManager->RegisterSoundEvent(SoundEvent);
+}
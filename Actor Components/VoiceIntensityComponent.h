@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "VoiceIntensityComponent.generated.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(LogVoiceIntensity, Log, All);
+
+/**
+ * Measures how loud the owning player is talking and reports it to the Sound Manager.
+ * It doesn't open a mic of its own, OnsetVoip's capture on the locally controlled player hands it
+ * every frame it captures through AnalyzeVoiceFrame, so there's only ever one capture of the mic.
+ * Each frame's loudness is compared against a noise floor and speech peak learned from that player's own mic,
+ * so a 0-1 intensity means the same thing no matter what mic or gain they use.
+ * Only the loudest intensity of each report window is sent to the server, quantized to a byte.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class NETWORKINGPROTOTYPE_API UVoiceIntensityComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	// Sets default values for this component's properties
+	UVoiceIntensityComponent();
+
+	// Called every frame
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Analyze a captured voice frame, Samples are mono in the -1 to 1 range.
+	// This is the hook OnsetVoip's capture calls with every frame of the local player's mic, on the game thread.
+	// Frames should come in unfiltered, silence included, the noise floor is learned from the quiet ones.
+	void AnalyzeVoiceFrame(TArrayView<const float> Samples, int32 SampleRate);
+
+	// Same as above for 16 bit PCM, which is what the voice capture hands out
+	void AnalyzeVoiceFrame(TArrayView<const int16> Samples, int32 SampleRate);
+
+	// Same as above for captured 16 bit PCM still in bytes, for captures hooked up in Blueprint
+	UFUNCTION(BlueprintCallable, Category = "Voice")
+	void AnalyzeVoicePCM(const TArray<uint8>& PCMData, int32 SampleRate);
+
+	// Sends what's left of the current report window, call when the player stops talking
+	void FlushVoiceIntensity();
+
+	// Intensity of the last analyzed frame, 0 if it wasn't speech
+	UFUNCTION(BlueprintPure, Category = "Voice")
+	float GetVoiceIntensity() const { return CurrentIntensity; }
+
+protected:
+	// Called when the game starts
+	virtual void BeginPlay() override;
+
+	// Called when the component is being removed
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// How often intensity is sent to the server while talking, in seconds
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voice", meta = (ClampMin = "0.05"))
+	float ReportInterval = 0.2f;
+
+	// How far above the noise floor a frame has to be to count as speech, in dB
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voice|Calibration", meta = (ClampMin = "0.0"))
+	float VoiceActivityThresholdDb = 9.0f;
+
+	// Smallest gap kept between the noise floor and the speech peak, in dB.
+	// Stops a player who only ever whispers from having their whisper count as shouting.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voice|Calibration", meta = (ClampMin = "1.0"))
+	float MinDynamicRangeDb = 24.0f;
+
+	// How fast the noise floor creeps up to louder background noise, in dB per second.
+	// Only frames quiet enough not to be speech move it up. It drops right away when things get quieter.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voice|Calibration", meta = (ClampMin = "0.0"))
+	float NoiseFloorRiseRate = 1.5f;
+
+	// How often the noise floor catches up to the quietest frame heard since, in seconds.
+	// Speech always has pauses, so this follows background noise that got louder than the speech threshold.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voice|Calibration", meta = (ClampMin = "1.0"))
+	float NoiseFloorWindowSeconds = 5.0f;
+
+	// How fast the speech peak falls back after the player was loud, in dB per second.
+	// It jumps up right away when they get louder.
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Voice|Calibration", meta = (ClampMin = "0.0"))
+	float PeakDecayRate = 0.5f;
+
+	// Send a voice intensity to the Sound Manager
+	UFUNCTION(Server, Unreliable)
+	void Server_ReportVoiceIntensity(uint8 QuantizedIntensity);
+
+private:
+	// Updates the calibration with a frame's mean square and returns its 0-1 intensity
+	float CalibrateFrame(float MeanSquare, float FrameSeconds);
+
+	// Folds a frame into the report window and sends the window once ReportInterval has passed
+	void AccumulateIntensity(float Intensity);
+
+	// Sends the loudest intensity of the report window, if any of it was speech, and starts a new window
+	void SendWindowIntensity();
+
+	// Learned level of the player's background noise, in dBFS
+	float NoiseFloorDb = -60.0f;
+
+	// Learned level of the player's loud speech, in dBFS. Starts below anything so the first speech sets it.
+	float SpeechPeakDb = -200.0f;
+
+	// Quietest frame since the noise floor last caught up, in dBFS
+	float NoiseWindowMinDb = MAX_flt;
+
+	// Seconds of frames since the noise floor last caught up
+	float NoiseWindowSeconds = 0.0f;
+
+	// Intensity of the last analyzed frame
+	float CurrentIntensity = 0.0f;
+
+	// Loudest intensity heard since the last report
+	float WindowIntensity = 0.0f;
+
+	// When the current report window started
+	double WindowStartTime = 0.0;
+
+	// When the last frame was analyzed
+	double LastFrameTime = -1.0;
+
+	// When the server last accepted a report from us, stops clients from spamming it
+	double LastServerReportTime = -1.0;
+};
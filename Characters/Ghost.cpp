@@ -3,12 +3,18 @@
 
 #include "NetworkingPrototype/Ghost/Ghost.h"
 
+#include "NetworkingPrototype/Ghost/GhostStats.h"
+#include "NetworkingPrototype/RPCStats.h"
+#include "NetworkingPrototype/DebugMessages.h"
 #include "BasicDoor.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "Algo/Sort.h"
 #include "Components/AudioComponent.h"
 #include "Components/CapsuleComponent.h"
+#include "GameFramework/GameStateBase.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "Sound/SoundBase.h"
 #include "Slate/SGameLayerManager.h"
 
 // Sets default values
@@ -40,6 +46,8 @@ AGhost::AGhost()
 
 	GetMesh()->SetIsReplicated(true);
 
+	// Nobody hears a server build's ghost, dedicated servers run from the editor or a game build drop it in BeginPlay
+#if !UE_SERVER
 	// Default create an audio component
 	GhostAudioComponent = CreateDefaultSubobject<UAudioComponent>(TEXT("GhostAudioComp"));
 	// Set Audio Parent to the Ghost skeleton
@@ -47,6 +55,7 @@ AGhost::AGhost()
 	GhostAudioComponent->bAutoActivate = false;
 	// Allow 3D sound
 	GhostAudioComponent->bAllowSpatialization = true;
+#endif
 
 	// Replicate Actor to be able to transfer data to clients
 	bReplicates = true;
@@ -58,6 +67,7 @@ AGhost::AGhost()
  */
 void AGhost::TurnInvisible_Implementation() const
 {
+	QU_COUNT_RPC(TurnInvisible);
 	GetMesh()->SetVisibility(false);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECR_Ignore);
 }
@@ -68,6 +78,7 @@ void AGhost::TurnInvisible_Implementation() const
  */
 void AGhost::Manifest_Implementation() const
 {
+	QU_COUNT_RPC(Manifest);
 	GetMesh()->SetVisibility(true);
 	GetCapsuleComponent()->SetCollisionResponseToChannel(ECollisionChannel::ECC_Pawn, ECR_MAX);
 }
@@ -123,6 +134,7 @@ void AGhost::SetGhostState(E_GhostState NewGhostState)
 
 void AGhost::Server_SetGhostState_Implementation(E_GhostState NewGhostState)
 {
+	QU_COUNT_RPC(Server_SetGhostState);
 	SetGhostState(NewGhostState);
 }
 
@@ -132,6 +144,13 @@ void AGhost::BeginPlay()
 {
 	Super::BeginPlay();
 
+	// Nobody hears a dedicated server's ghost
+	if (IsNetMode(NM_DedicatedServer) && GhostAudioComponent)
+	{
+		GhostAudioComponent->DestroyComponent();
+		GhostAudioComponent = nullptr;
+	}
+
 	// Make Ghost invisible when Patrolling
 	TurnInvisible();
 
@@ -142,7 +161,7 @@ void AGhost::BeginPlay()
 	}
 	if (GhostAIController != nullptr)
 	{
-		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Turquoise, FString(TEXT("GhostAIController Setup Complete")));
+		QU_DEBUG_MESSAGE(2.0f, FColor::Turquoise, TEXT("GhostAIController Setup Complete"));
 	}
 	
 }
@@ -166,7 +185,7 @@ void AGhost::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimePr
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(AGhost, CurrentGhostState);
-	DOREPLIFETIME(AGhost, GhostAudioComponent);
+	DOREPLIFETIME(AGhost, PresentationEvents);
 }
 
 void AGhost::Distract(ACharacter* Distractor)
@@ -195,27 +214,136 @@ void AGhost::Stun(const float Duration)
 }
 
 
-void AGhost::Server_PlayAudio_Implementation(USoundBase* SoundCue)
+void AGhost::RecordPresentationEvent(E_GhostPresentationEvent EventType, AActor* Target)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// Count the events we send so profiling captures show the ghost's share of network traffic
+	CSV_CUSTOM_STAT(Ghost, PresentationEvents, 1, ECsvCustomStatOp::Accumulate);
+
+	// Overwrite the oldest slot
+	LastPresentationEventId++;
+	FGhostPresentationEvent& Event = PresentationEvents.Events[LastPresentationEventId % FGhostPresentationEventRing::Capacity];
+	Event.Id = LastPresentationEventId;
+	Event.Type = EventType;
+	Event.ServerTime = GetServerTime();
+	Event.Target = Target;
+
+	// OnRep doesn't run on the server, so play it here
+	PlayPresentationEvent(Event, 0.0f);
+}
+
+void AGhost::OnRep_PresentationEvents()
 {
-	Multicast_PlayAudio(SoundCue);
+	const float ServerTime = GetServerTime();
+
+	// Play every event we haven't seen yet, oldest first
+	const FGhostPresentationEvent* SortedEvents[FGhostPresentationEventRing::Capacity];
+	int32 NumNewEvents = 0;
+	for (const FGhostPresentationEvent& Event : PresentationEvents.Events)
+	{
+		if (Event.Id > LastPresentationEventId)
+		{
+			SortedEvents[NumNewEvents++] = &Event;
+		}
+	}
+
+	Algo::Sort(MakeArrayView(SortedEvents, NumNewEvents),
+		[](const FGhostPresentationEvent* A, const FGhostPresentationEvent* B) { return A->Id < B->Id; });
+
+	for (int32 EventIdx = 0; EventIdx < NumNewEvents; EventIdx++)
+	{
+		const FGhostPresentationEvent& Event = *SortedEvents[EventIdx];
+		LastPresentationEventId = Event.Id;
+
+		// Drop anything that's too old to still be happening
+		const float Age = FMath::Max(0.0f, ServerTime - Event.ServerTime);
+		if (Age <= PresentationEventLifetime)
+		{
+			PlayPresentationEvent(Event, Age);
+		}
+	}
 }
 
-void AGhost::Multicast_PlayAudio_Implementation(USoundBase* SoundCue)
+void AGhost::PlayPresentationEvent(const FGhostPresentationEvent& Event, const float Age)
 {
-	if (SoundCue != nullptr)
+	USoundBase* SoundCue = nullptr;
+	switch (Event.Type)
+	{
+		case E_GhostPresentationEvent::Kill:
+		{
+			SoundCue = KillPlayerSound;
+
+			if (HasAuthority() && GhostAIController)
+			{
+				// Play the kill player anim montage and bind the delegate
+				PlayKillAnimWithDelegate(GhostAIController);
+			}
+			else
+			{
+				// Every other client just plays the montage, from where the server is at
+				UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
+				if (AnimInstance && KillPlayerMontage && !AnimInstance->Montage_IsPlaying(KillPlayerMontage)
+					&& Age < KillPlayerMontage->GetPlayLength())
+				{
+					AnimInstance->Montage_Play(KillPlayerMontage, 1.0f, EMontagePlayReturnType::MontageLength, Age);
+				}
+			}
+			break;
+		}
+
+		case E_GhostPresentationEvent::Stun:
+			SoundCue = StunSoundCue;
+			break;
+
+		case E_GhostPresentationEvent::Distract:
+			SoundCue = DistractSoundCue;
+			break;
+
+		case E_GhostPresentationEvent::Calming:
+			SoundCue = CalmingSoundCue;
+			break;
+
+		case E_GhostPresentationEvent::None:
+		default:
+			return;
+	}
+
+	// Skip sounds that would already be over
+	if (GhostAudioComponent && SoundCue != nullptr && (SoundCue->GetDuration() > Age || SoundCue->IsLooping()))
 	{
 		GhostAudioComponent->SetSound(SoundCue);
-		GhostAudioComponent->Play();
+		GhostAudioComponent->Play(Age);
 	}
+
+	// Let any subscribers know, EX: camera shakes on the target
+	OnPresentationEvent.Broadcast(Event.Type, Event.Target);
+}
+
+float AGhost::GetServerTime() const
+{
+	const UWorld* World = GetWorld();
+	if (!World)
+	{
+		return 0.0f;
+	}
+
+	const AGameStateBase* GameState = World->GetGameState();
+	return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
 }
 
 void AGhost::Server_Teleport_Implementation(const FVector& TeleportLocation)
 {
+	QU_COUNT_RPC(Server_Teleport);
 	SetActorLocation(TeleportLocation);
 }
 
 void AGhost::Server_GetGhostAIController_Implementation(AGhostAIController* output)
 {
+	QU_COUNT_RPC(Server_GetGhostAIController);
 	output = GetGhostAIController();
 }
 
@@ -252,7 +380,7 @@ bool AGhost::IsHaunting()
 {
 	if (GhostAIController && HasAuthority())
 	{
-		return GhostAIController->GetBlackboardComponent()->GetValueAsBool(TEXT("isHaunting"));
+		return GhostAIController->GetGhostBlackboard().GetBool(E_GhostBlackboardKey::IsHaunting);
 	}
 
 	return false;
@@ -263,15 +391,16 @@ void AGhost::ForceHaunt(AActor* NewTarget)
 	if (GhostAIController && HasAuthority())
 	{
 		// Only force a haunt if the ghost is not stunned and is not haunting
-		if (!GhostAIController->GetBlackboardComponent()->GetValueAsBool(TEXT("Stunned"))
-			&& !GhostAIController->GetBlackboardComponent()->GetValueAsBool(TEXT("isHaunting")))
+		const FGhostBlackboard& GhostBlackboard = GhostAIController->GetGhostBlackboard();
+		if (!GhostBlackboard.GetBool(E_GhostBlackboardKey::Stunned)
+			&& !GhostBlackboard.GetBool(E_GhostBlackboardKey::IsHaunting))
 		{
-			GhostAIController->GetBlackboardComponent()->SetValueAsFloat(TEXT("AggroMeter"), 0.5f);
-			GhostAIController->GetBlackboardComponent()->SetValueAsBool(TEXT("CanTeleport"), true);
+			GhostBlackboard.SetFloat(E_GhostBlackboardKey::AggroMeter, 0.5f);
+			GhostBlackboard.SetBool(E_GhostBlackboardKey::CanTeleport, true);
 		
 			if (NewTarget != nullptr)
 			{
-				GhostAIController->GetBlackboardComponent()->SetValueAsObject(TEXT("TargettedPlayer"), NewTarget);
+				GhostAIController->SetTargetPlayer(NewTarget);
 			}
 		}
 	}
@@ -281,7 +410,7 @@ void AGhost::SetPassiveMultiplier(float NewMultiplier)
 {
 	if (GhostAIController && HasAuthority())
 	{
-		GhostAIController->GetBlackboardComponent()->SetValueAsFloat(TEXT("PassiveMultiplier"), NewMultiplier);
+		GhostAIController->GetGhostBlackboard().SetFloat(E_GhostBlackboardKey::PassiveMultiplier, NewMultiplier);
 	}
 }
 
@@ -289,7 +418,7 @@ void AGhost::OverridePassiveMultiplierForDuration(float NewMultiplier, float Dur
 {
 	if (GhostAIController && HasAuthority())
 	{
-		DefaultPassiveHauntingMultiplier = GhostAIController->GetBlackboardComponent()->GetValueAsFloat(TEXT("PassiveMultiplier"));
+		DefaultPassiveHauntingMultiplier = GhostAIController->GetGhostBlackboard().GetFloat(E_GhostBlackboardKey::PassiveMultiplier);
 
 		SetPassiveMultiplier(NewMultiplier);
 
@@ -311,27 +440,6 @@ void AGhost::ResetPassiveMultiplier()
 	}
 }
 
-void AGhost::Multicast_PlayKillAnim_Implementation(AGhostAIController* OwningController)
-{
-	// Only the server sets the blend out delegate
-	if (HasAuthority())
-	{
-		// Play the Kill player sound
-		Server_PlayAudio(KillPlayerSound);
-		// Play the kill player anim montage and bind the delegate
-		PlayKillAnimWithDelegate(OwningController);
-	}
-	else
-	{
-		// Every other client just plays the montage
-		UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
-		if (AnimInstance && KillPlayerMontage && !AnimInstance->Montage_IsPlaying(KillPlayerMontage))
-		{
-			AnimInstance->Montage_Play(KillPlayerMontage);
-		}
-	}
-}
-
 void AGhost::OnRep_CurrentGhostState()
 {
 	// Let any subscribers know about the new GhostState.
@@ -16,7 +16,53 @@ enum class E_GhostState : uint8
 	Distracted UMETA(DisplayName = "Distracted")
 };
 
+// Things the ghost does that every player should see and hear
+UENUM(BlueprintType)
+enum class E_GhostPresentationEvent : uint8
+{
+	None UMETA(Hidden),
+	Kill UMETA(DisplayName = "Kill"),
+	Stun UMETA(DisplayName = "Stun"),
+	Distract UMETA(DisplayName = "Distract"),
+	Calming UMETA(DisplayName = "Calming")
+};
+
+// One presentation event, stamped with the server time it happened at
+USTRUCT()
+struct FGhostPresentationEvent
+{
+	GENERATED_BODY()
+
+	// Goes up by one for every event, 0 means the slot has never been used
+	UPROPERTY()
+	uint32 Id = 0;
+
+	UPROPERTY()
+	E_GhostPresentationEvent Type = E_GhostPresentationEvent::None;
+
+	// Server world time the event happened at
+	UPROPERTY()
+	float ServerTime = 0.0f;
+
+	// Who the event was aimed at, if anyone
+	UPROPERTY()
+	AActor* Target = nullptr;
+};
+
+// The ghost's most recent presentation events, the oldest gets overwritten by the next one
+USTRUCT()
+struct FGhostPresentationEventRing
+{
+	GENERATED_BODY()
+
+	static constexpr int32 Capacity = 4;
+
+	UPROPERTY()
+	FGhostPresentationEvent Events[Capacity];
+};
+
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FBPGhostStateChanged, E_GhostState, NewGhostState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FBPGhostPresentationEvent, E_GhostPresentationEvent, EventType, AActor*, Target);
 
 UCLASS()
 class NETWORKINGPROTOTYPE_API AGhost : public ACharacter
@@ -41,6 +87,20 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound", meta = (AllowPrivateAccess = "true"))
 	USoundBase* KillPlayerSound;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound", meta = (AllowPrivateAccess = "true"))
+	USoundBase* CalmingSoundCue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound", meta = (AllowPrivateAccess = "true"))
+	USoundBase* StunSoundCue;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound", meta = (AllowPrivateAccess = "true"))
+	USoundBase* DistractSoundCue;
+
+	// How old a presentation event can be and still get played, in seconds.
+	// Players that join or come into relevancy later than this miss it.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Sound", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float PresentationEventLifetime = 3.0f;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -89,12 +149,14 @@ public:
 	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "Ghost Delegates")
 	FBPGhostStateChanged OnGhostStateChanged;
 
-	// Ghost Audio
-	UFUNCTION(Server, Reliable)
-	void Server_PlayAudio(USoundBase* SoundCue);
-	
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_PlayAudio(USoundBase* SoundCue);
+	// Ghost presentation events.
+	// Records the event in the replicated ring and plays it right away, server only.
+	// Clients play it when the ring replicates, skipping ahead by however late they are.
+	void RecordPresentationEvent(E_GhostPresentationEvent EventType, AActor* Target = nullptr);
+
+	// BP event delegate to trigger when a presentation event plays on this machine
+	UPROPERTY(BlueprintAssignable, BlueprintCallable, Category = "Ghost Delegates")
+	FBPGhostPresentationEvent OnPresentationEvent;
 
 	/** Ghost Teleportation */
 	UFUNCTION(Server, Reliable)
@@ -109,11 +171,6 @@ public:
 
 	void SetGhostAIController(AGhostAIController* NewGhostAIController);
 
-	// Multicast function to play the kill anim montage on all clients
-	// and tell the server to call PlayKillAnimWithDelegate()
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_PlayKillAnim(AGhostAIController* OwningController);
-
 	// Function to call when Ghost kills a player and this ghost
 	// has authority. Binds Blend Out of montage to PostKillAnim()
 	// on AIController
@@ -151,8 +208,24 @@ private:
 	UFUNCTION()
 	void OnRep_CurrentGhostState();
 
-	// Audio component to replicate sounds
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Audio, Replicated, meta = (AllowPrivateAccess = "true"))
+	// Recent presentation events. Replicated using OnRep_PresentationEvents
+	UPROPERTY(ReplicatedUsing=OnRep_PresentationEvents)
+	FGhostPresentationEventRing PresentationEvents;
+
+	// Id of the newest presentation event recorded or played on this machine
+	uint32 LastPresentationEventId = 0;
+
+	UFUNCTION()
+	void OnRep_PresentationEvents();
+
+	// Plays the sound and animation for a presentation event, starting Age seconds in
+	void PlayPresentationEvent(const FGhostPresentationEvent& Event, const float Age);
+
+	// Current server world time, the same clock on the server and every client
+	float GetServerTime() const;
+
+	// Audio component for the ghost's sounds, null on dedicated servers
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Audio, meta = (AllowPrivateAccess = "true"))
 	UAudioComponent* GhostAudioComponent;
 
 	// Holder for default value of PassiveMultiplier
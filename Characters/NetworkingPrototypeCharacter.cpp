@@ -22,6 +22,11 @@
 #include "Perception/AISense_Sight.h"
 #include "NetworkingPrototype/NetworkingPrototypeGameMode.h"
 #include "Perception/AIPerceptionComponent.h"
+#include "NetworkingPrototype/Managers/InteractionFocusSubsystem.h"
+#include "NetworkingPrototype/Components/QUCharacterMovementComponent.h"
+#include "NetworkingPrototype/Components/VoiceIntensityComponent.h"
+#include "NetworkingPrototype/DebugMessages.h"
+#include "NetworkingPrototype/RPCStats.h"
 
 class UAISense_Sight;
 DEFINE_LOG_CATEGORY(LogTemplateCharacter);
@@ -29,7 +34,8 @@ DEFINE_LOG_CATEGORY(LogTemplateCharacter);
 //////////////////////////////////////////////////////////////////////////
 // ANetworkingPrototypeCharacter
 
-ANetworkingPrototypeCharacter::ANetworkingPrototypeCharacter()
+ANetworkingPrototypeCharacter::ANetworkingPrototypeCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UQUCharacterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize(55.f, 96.0f);
@@ -49,17 +55,6 @@ ANetworkingPrototypeCharacter::ANetworkingPrototypeCharacter()
 	Mesh1P->CastShadow = false;
 	//Mesh1P->SetRelativeRotation(FRotator(0.9f, -19.19f, 5.2f));
 	Mesh1P->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
-	MaxSprintValue = 100.f;
-	SprintDrainRate = 5.f;
-	CurrentSprintValue = MaxSprintValue;
-	
-	NormalSpeed = GetCharacterMovement()->MaxWalkSpeed;
-	SprintingSpeed = NormalSpeed * 2;
-	RegularNormalSpeed = NormalSpeed;
-	RegularSprintingSpeed = SprintingSpeed;
-	SlateNormalSpeed = NormalSpeed / 2;
-	SlateSprintingSpeed = SprintingSpeed / 2;
-	UnlimitedSprint = false;
 
 	Popup = CreateDefaultSubobject<UWidgetComponent>(TEXT("InteractionPopup"));
 	Popup->SetWidgetSpace(EWidgetSpace::Screen);
@@ -72,6 +67,8 @@ ANetworkingPrototypeCharacter::ANetworkingPrototypeCharacter()
 	HoldPopup->SetOnlyOwnerSee(true);
 
 	FootprintComponent = CreateDefaultSubobject<UFootprintComponent>(TEXT("FootprintComponent"));
+
+	VoiceIntensityComponent = CreateDefaultSubobject<UVoiceIntensityComponent>(TEXT("VoiceIntensityComponent"));
 	
 	bReplicates = true;
 	AActor::SetReplicateMovement(true);
@@ -84,8 +81,6 @@ void ANetworkingPrototypeCharacter::BeginPlay()
 {
 	// Call the base class  
 	Super::BeginPlay();
-	GetWorld()->GetTimerManager().SetTimer(FocusTimerHandle, this, &ANetworkingPrototypeCharacter::FocusCall, 0.1f, true);
-	GetWorld()->GetTimerManager().SetTimer(FillDashMeterTimerHandle, this, &ANetworkingPrototypeCharacter::FillDashMeter, 0.1f, true);
 	Popup->SetVisibility(false);
 	HoldPopup->SetVisibility(false);
 
@@ -93,6 +88,16 @@ void ANetworkingPrototypeCharacter::BeginPlay()
 	{
 		HoldWidget = Cast<UHoldToInteractWidget>(HoldPopup->GetWidget());
 	}
+
+	// Let the interaction focus subsystem tell us what we're looking at.
+	// It only updates us while we're locally controlled, so every character can register here.
+	if (UInteractionFocusSubsystem* InteractionFocus = GetWorld()->GetSubsystem<UInteractionFocusSubsystem>())
+	{
+		InteractionFocus->RegisterViewer(this, FirstPersonCameraComponent,
+			FInteractionFocusGained::CreateUObject(this, &ANetworkingPrototypeCharacter::OnInteractionFocusGained),
+			FInteractionFocusLost::CreateUObject(this, &ANetworkingPrototypeCharacter::OnInteractionFocusLost),
+			FInteractionFocusMoved::CreateUObject(this, &ANetworkingPrototypeCharacter::OnInteractionFocusMoved));
+	}
 	// Ensure the server spawns the phone for all players
 	// The server spawns individual phone instances for each player and ensures they are replicated to the clients.
 	if (HasAuthority()) // Only the server should execute this
@@ -109,6 +114,20 @@ void ANetworkingPrototypeCharacter::BeginPlay()
 	}
 }
 
+void ANetworkingPrototypeCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Stop tracking focus so the subsystem never holds onto a destroyed character
+	if (UWorld* World = GetWorld())
+	{
+		if (UInteractionFocusSubsystem* InteractionFocus = World->GetSubsystem<UInteractionFocusSubsystem>())
+		{
+			InteractionFocus->UnregisterViewer(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
 //////////////////////////////////////////////////////////////////////////// Input
 
 // Primary use of currently held item
@@ -313,42 +332,9 @@ void ANetworkingPrototypeCharacter::OnRep_SlateHeld() const
 	OnSlateHeldChanged.Broadcast(SlateHeld);
 }
 
-void ANetworkingPrototypeCharacter::FillDashMeter()
-{
-	if (!UnlimitedSprint)
-	{
-		//Refilling
-		if (SprintBarCanRefill && !CurrentlySprinting && CurrentSprintValue < MaxSprintValue)
-		{
-			CurrentSprintValue += SprintDrainRate;
-			if (CurrentSprintValue > MaxSprintValue)
-			{
-				CurrentSprintValue = MaxSprintValue;
-				SprintBarCanRefill = false;
-			}
-		}
-		//Depleting
-		else if (CurrentlySprinting && CurrentSprintValue > 0)
-		{
-			CurrentSprintValue -= SprintDrainRate;
-			if (CurrentSprintValue <= 0)
-			{
-				CurrentSprintValue = 0;
-				ServerStopSprinting();
-			}
-		}
-	}
-}
-
 void ANetworkingPrototypeCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-	DOREPLIFETIME(ANetworkingPrototypeCharacter, CurrentlySprinting);
-	DOREPLIFETIME(ANetworkingPrototypeCharacter, SprintingSpeed);
-	DOREPLIFETIME(ANetworkingPrototypeCharacter, NormalSpeed);
-	DOREPLIFETIME(ANetworkingPrototypeCharacter, SprintBarCanRefill);
-	DOREPLIFETIME(ANetworkingPrototypeCharacter, UnlimitedSprint);
-
 	DOREPLIFETIME(ANetworkingPrototypeCharacter, PlayerPhone);
 	DOREPLIFETIME(ANetworkingPrototypeCharacter, ItemHeld);
 	DOREPLIFETIME(ANetworkingPrototypeCharacter, SlateHeld);
@@ -356,11 +342,6 @@ void ANetworkingPrototypeCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeP
 	DOREPLIFETIME(ANetworkingPrototypeCharacter, bIsAlive);
 }
 
-void ANetworkingPrototypeCharacter::OnRep_IsSprinting() const
-{
-	GetCharacterMovement()->MaxWalkSpeed = CurrentlySprinting ? SprintingSpeed : NormalSpeed;
-}
-
 void ANetworkingPrototypeCharacter::SetHeldSlate(ASlateItem* NewSlate, ANetworkingPrototypeCharacter* Character)
 {
 	if (!NewSlate)
@@ -383,6 +364,7 @@ void ANetworkingPrototypeCharacter::SetHeldSlate(ASlateItem* NewSlate, ANetworki
 void ANetworkingPrototypeCharacter::Server_SetHeldSlate_Implementation(ASlateItem* NewSlate,
 	ANetworkingPrototypeCharacter* Character)
 {
+	QU_COUNT_RPC(Server_SetHeldSlate);
 	if (HasAuthority())
 	{
 		SetHeldSlate(NewSlate, Character);
@@ -391,11 +373,12 @@ void ANetworkingPrototypeCharacter::Server_SetHeldSlate_Implementation(ASlateIte
 
 float ANetworkingPrototypeCharacter::GetSprintPercentage()
 {
-	return CurrentSprintValue / MaxSprintValue;
+	return GetQUCharacterMovement()->GetStaminaPercentage();
 }
 
 void ANetworkingPrototypeCharacter::Server_DropItem_Implementation(AActor* PlayerUser, bool Respawn)
 {
+	QU_COUNT_RPC(Server_DropItem);
 	DropItem(PlayerUser, Respawn);
 }
 
@@ -406,8 +389,7 @@ bool ANetworkingPrototypeCharacter::Server_DropItem_Validate(AActor* PlayerUser,
 
 void ANetworkingPrototypeCharacter::OnRep_IsAlive()
 {
-	GEngine->AddOnScreenDebugMessage
-	(-1, 1.0f, FColor::Yellow, TEXT("OnRep IsAlive"));
+	QU_DEBUG_MESSAGE(1.0f, FColor::Yellow, TEXT("OnRep IsAlive"));
 	
 	if (bIsAlive)
 	{
@@ -508,10 +490,10 @@ void ANetworkingPrototypeCharacter::SetupPlayerInputComponent(UInputComponent* P
 		EnhancedInputComponent->BindAction(AltUse, ETriggerEvent::Triggered, this, &ANetworkingPrototypeCharacter::AltUseItem);
 
 		// Sprinting
-		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Started, this, &ANetworkingPrototypeCharacter::ServerStartSprinting);
+		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Started, this, &ANetworkingPrototypeCharacter::StartSprinting);
 		//Only Start Refilling Bar When Player Releases Sprint Button
-		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Canceled, this, &ANetworkingPrototypeCharacter::ServerResetSprintBarFill);
-		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Completed, this, &ANetworkingPrototypeCharacter::ServerResetSprintBarFill);
+		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Canceled, this, &ANetworkingPrototypeCharacter::StopSprinting);
+		EnhancedInputComponent->BindAction(SprintAction, ETriggerEvent::Completed, this, &ANetworkingPrototypeCharacter::StopSprinting);
 
 		// Phone
 		EnhancedInputComponent->BindAction(PhoneAction, ETriggerEvent::Started, this, &ANetworkingPrototypeCharacter::TogglePhone);
@@ -547,26 +529,26 @@ void ANetworkingPrototypeCharacter::SetHeldItem(AItem* NewItem, ANetworkingProto
 void ANetworkingPrototypeCharacter::Server_SetHeldItem_Implementation(AItem* NewItem,
 	ANetworkingPrototypeCharacter* Character)
 {
+	QU_COUNT_RPC(Server_SetHeldItem);
 	// Server sets ItemHeld, triggers OnRep on clients
 	SetHeldItem(NewItem, Character);
 }
 
 void ANetworkingPrototypeCharacter::SetUnlimitedSprint_Implementation(bool IsSprintUnlimited)
 {
-	UnlimitedSprint = IsSprintUnlimited;
+	QU_COUNT_RPC(SetUnlimitedSprint);
+	GetQUCharacterMovement()->SetUnlimitedStamina(IsSprintUnlimited);
 }
 
 void ANetworkingPrototypeCharacter::KillPlayer()
 {
-	GEngine->AddOnScreenDebugMessage
-	(-1, 1.0f, FColor::Red, TEXT("Killing Player >:)"));
+	QU_DEBUG_MESSAGE(1.0f, FColor::Red, TEXT("Killing Player >:)"));
 	HandleDeath();
 }
 
 void ANetworkingPrototypeCharacter::RevivePlayer(const FVector& RespawnLocation)
 {
-	GEngine->AddOnScreenDebugMessage
-(-1, 1.0f, FColor::Green, TEXT("Reviving Player :)"));
+	QU_DEBUG_MESSAGE(1.0f, FColor::Green, TEXT("Reviving Player :)"));
 	HandleRespawn(RespawnLocation);
 }
 
@@ -593,6 +575,7 @@ void ANetworkingPrototypeCharacter::HandleRespawn(const FVector& RespawnLocation
 
 void ANetworkingPrototypeCharacter::Server_HandleRespawn_Implementation(const FVector& RespawnLocation, APlayerState* PlayerStateToRespawn)
 {
+	QU_COUNT_RPC(Server_HandleRespawn);
 	// Only handle respawn if we are the server
 	if (HasAuthority())
 	{
@@ -634,6 +617,7 @@ void ANetworkingPrototypeCharacter::HandleDeath()
 
 void ANetworkingPrototypeCharacter::Server_HandleDeath_Implementation(APlayerState* PlayerStateToKill)
 {
+	QU_COUNT_RPC(Server_HandleDeath);
 	// Only handle death if we are the server
 	if (HasAuthority())
 	{
@@ -679,6 +663,7 @@ void ANetworkingPrototypeCharacter::Look(const FInputActionValue& Value)
 
 void ANetworkingPrototypeCharacter::Server_Interact_Implementation(AActor* InteractableItem)
 {
+	QU_COUNT_RPC(Server_Interact);
 	// Ensure interaction is processed by the server
 	UE_LOG(LogTemplateCharacter, Log, TEXT("Server handling interaction."));
 
@@ -781,7 +766,7 @@ void ANetworkingPrototypeCharacter::Interact()
 			}
 			else
 			{
-				GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("Can't interact"));
+				QU_DEBUG_MESSAGE(1.0f, FColor::Red, TEXT("Can't interact"));
 			}
 		}
 	}
@@ -789,6 +774,7 @@ void ANetworkingPrototypeCharacter::Interact()
 
 void ANetworkingPrototypeCharacter::Server_CancelHoldInteract_Implementation(AActor* InteractableItem)
 {
+	QU_COUNT_RPC(Server_CancelHoldInteract);
 	// If we were holding E on an actor
 	if (InteractableItem)
 	{
@@ -833,85 +819,71 @@ void ANetworkingPrototypeCharacter::CancelHoldInteract()
 	}
 }
 
-void ANetworkingPrototypeCharacter::FocusCall()
+void ANetworkingPrototypeCharacter::OnInteractionFocusGained(AActor* Actor, const FVector& FocusLocation)
 {
-	if (IsLocallyControlled())
+	IInteractableInterface* InteractInterface = Cast<IInteractableInterface>(Actor);
+	if (!InteractInterface)
 	{
-		FVector Start = FirstPersonCameraComponent->GetComponentLocation();
-		FVector ForwardVector = FirstPersonCameraComponent->GetForwardVector();
-		FVector End = ((ForwardVector * 200.f) + Start);
-    
-		FHitResult HitResult;
-		FCollisionQueryParams CollisionParams;
+		return;
+	}
 
-		// Actual line trace
-		if (GetWorld()->LineTraceSingleByChannel(HitResult, Start, End, ECC_Visibility, CollisionParams))
-		{
-			// Store hit actor as a var
-			AActor* Actor = HitResult.GetActor();
+	FocusedObject = Actor;
 
-			// Compact version:
-			// Check to see if the hit actor implements the InteractableInterface
-			if(IInteractableInterface* InteractInterface = Cast<IInteractableInterface>(Actor))
+	// Pull the widget slightly towards the camera so it doesn't clip into the object
+	const FVector WidgetLocation = FocusLocation - FirstPersonCameraComponent->GetForwardVector();
+
+	// Depending on the interact type, we show press or hold E widget
+	switch (InteractInterface->GetInteractType())
+	{
+		case E_InteractType::Tap:
+			// Show press E widget
+			if (Popup)
 			{
-				if (InteractInterface->GetCanInteract())
-				{
-					FocusedObject = Actor;
+				Popup->SetVisibility(true);
+				Popup->SetWorldLocation(WidgetLocation);
+			}
+			break;
 
-					// Depending on the interact type, we show press or hold E widget
-					switch (InteractInterface->GetInteractType())
-					{
-						case E_InteractType::Tap:
-							// Show press E widget
-							if (Popup)
-							{
-								if (!Popup->IsVisible())
-								{
-									Popup->SetVisibility(true);
-								}
-								Popup->SetWorldLocation(HitResult.Location - ForwardVector);
-
-								// If we had a reference to a hold interactable, deref it
-								if (HoldWidget)
-								{
-									HoldWidget->UpdateInteractableActor(nullptr);
-								}
-							}
-							break;
+		case E_InteractType::Hold:
+			// Show Hold E widget
+			if (HoldPopup)
+			{
+				HoldPopup->SetVisibility(true);
+				HoldPopup->SetWorldLocation(WidgetLocation);
 
-						case E_InteractType::Hold:
-							// Show Hold E widget
-							if (HoldPopup)
-							{
-								if (!HoldPopup->IsVisible())
-								{
-									HoldPopup->SetVisibility(true);
-								}
-								
-								HoldPopup->SetWorldLocation(HitResult.Location - ForwardVector);
-
-								if (HoldWidget && (HoldWidget->GetInteractableActor() != Actor))
-								{
-									HoldWidget->UpdateInteractableActor(Actor);
-								}
-							}
-							break;
-					}
-				}
-				else
+				if (HoldWidget)
 				{
-					UnfocusCall();
+					HoldWidget->UpdateInteractableActor(Actor);
 				}
 			}
-			else
-			{
-				UnfocusCall();
-			}
-		}
-		else
-		{
-			UnfocusCall();
-		}
+			break;
+	}
+}
+
+void ANetworkingPrototypeCharacter::OnInteractionFocusLost(AActor* Actor)
+{
+	// Looking away from whatever we're holding E on lets go of it
+	if (CurrentHoldProgressionActor && CurrentHoldProgressionActor == Actor)
+	{
+		CancelHoldInteract();
+	}
+
+	UnfocusCall();
+}
+
+void ANetworkingPrototypeCharacter::OnInteractionFocusMoved(AActor* Actor, const FVector& FocusLocation)
+{
+	// Pull the widget slightly towards the camera so it doesn't clip into the object
+	const FVector WidgetLocation = FocusLocation - FirstPersonCameraComponent->GetForwardVector();
+
+	// Move whichever popup is showing
+	if (Popup && Popup->IsVisible())
+	{
+		Popup->SetWorldLocation(WidgetLocation);
+	}
+	if (HoldPopup && HoldPopup->IsVisible())
+	{
+		HoldPopup->SetWorldLocation(WidgetLocation);
 	}
 }
 
@@ -968,11 +940,11 @@ void ANetworkingPrototypeCharacter::StopTalking()
 		if(PlayerController)
 		{
 			PlayerController->ConsoleCommand("ToggleSpeaking 0");
-			GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Green, TEXT("Stopped Talking: Command Sent Successfully"));
+			QU_DEBUG_MESSAGE(1.0f, FColor::Green, TEXT("Stopped Talking: Command Sent Successfully"));
 		}
 		else
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("No Player Controller"));
+			QU_DEBUG_MESSAGE(1.0f, FColor::Red, TEXT("No Player Controller"));
 		}
 	}
 }
@@ -1012,8 +984,8 @@ void ANetworkingPrototypeCharacter::DropItemWrapper()
 
 void ANetworkingPrototypeCharacter::Server_SetIsAlive_Implementation(bool newAlive)
 {
-	GEngine->AddOnScreenDebugMessage
-	(-1, 1.0f, FColor::Red, TEXT("Server_SetIsAlive"));
+	QU_COUNT_RPC(Server_SetIsAlive);
+	QU_DEBUG_MESSAGE(1.0f, FColor::Red, TEXT("Server_SetIsAlive"));
 	bIsAlive = newAlive;
 }
 
@@ -1036,61 +1008,36 @@ void ANetworkingPrototypeCharacter::SetupStimulusSource() const
 
 void ANetworkingPrototypeCharacter::EnableSlateSpeed()
 {
-	NormalSpeed = SlateNormalSpeed;
-	SprintingSpeed = SlateSprintingSpeed;
-	OnRep_IsSprinting();
+	GetQUCharacterMovement()->SetSpeedMultiplier(SlateSpeedMultiplier);
 }
 
 void ANetworkingPrototypeCharacter::DisableSlateSpeed()
 {
-	NormalSpeed = RegularNormalSpeed;
-	SprintingSpeed = RegularSprintingSpeed;
-	OnRep_IsSprinting();
-}
-
-void ANetworkingPrototypeCharacter::Multicast_ResetSprintBarFill_Implementation()
-{
-	if (HasAuthority())
-	{
-		SprintBarCanRefill = true;
-		ServerStopSprinting();
-	}
+	GetQUCharacterMovement()->SetSpeedMultiplier(1.0f);
 }
 
-void ANetworkingPrototypeCharacter::Multicast_StartSprint_Implementation()
+float ANetworkingPrototypeCharacter::GetRegularWalkSpeed() const
 {
-	if (HasAuthority())
-	{
-		CurrentlySprinting = true;
-		SprintBarCanRefill = false;
-		OnRep_IsSprinting();
-		OnStartSprint.Broadcast();
-	}
+	return GetCharacterMovement()->MaxWalkSpeed;
 }
 
-void ANetworkingPrototypeCharacter::Multicast_StopSprint_Implementation()
+float ANetworkingPrototypeCharacter::GetRegularSprintSpeed() const
 {
-	if (HasAuthority())
-	{
-		CurrentlySprinting = false;
-		OnRep_IsSprinting();
-		OnStopSprint.Broadcast();
-	}
+	return GetQUCharacterMovement()->GetBaseSprintSpeed();
 }
 
-// Server RPCs
-void ANetworkingPrototypeCharacter::ServerResetSprintBarFill_Implementation()
+UQUCharacterMovementComponent* ANetworkingPrototypeCharacter::GetQUCharacterMovement() const
 {
-	Multicast_ResetSprintBarFill();
+	return CastChecked<UQUCharacterMovementComponent>(GetCharacterMovement());
 }
 
-void ANetworkingPrototypeCharacter::ServerStartSprinting_Implementation()
+void ANetworkingPrototypeCharacter::StartSprinting()
 {
-	Multicast_StartSprint();
+	GetQUCharacterMovement()->SetWantsToSprint(true);
 }
 
-void ANetworkingPrototypeCharacter::ServerStopSprinting_Implementation()
+void ANetworkingPrototypeCharacter::StopSprinting()
 {
-	Multicast_StopSprint();
+	GetQUCharacterMovement()->SetWantsToSprint(false);
 }
 
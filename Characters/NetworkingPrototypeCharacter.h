@@ -23,6 +23,8 @@ class UWidgetComponent;
 class AItem;
 class ASlateItem;
 class UAnimInstance;
+class UQUCharacterMovementComponent;
+class UVoiceIntensityComponent;
 
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 
@@ -82,16 +84,15 @@ class ANetworkingPrototypeCharacter : public ACharacter
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Input, meta=(AllowPrivateAccess = "true"))
 	UInputAction* PhoneAction;
 
-	// Timer Handles
-	FTimerHandle FillDashMeterTimerHandle;
-	FTimerHandle FocusTimerHandle;
-	
 public:
-	ANetworkingPrototypeCharacter();
+	ANetworkingPrototypeCharacter(const FObjectInitializer& ObjectInitializer);
 
 protected:
 	virtual void BeginPlay();
 
+	// Called when the character is being removed from the level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Function to request interaction from the server
 	// use this when a client is trying to interact with an object that should be updated on the server
 	// and updated on all clients
@@ -119,13 +120,9 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Audio")
 	USoundEffectSourcePresetChain* VCSoundEffectSourcePresetChain;
 
-	/** The maximum value the sprint bar can hold. */
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category= "Gameplay")
-	float MaxSprintValue;
-
-	/** The maximum value the sprint bar can hold. */
+	/** How much slower the player moves while carrying a slate. */
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category= "Gameplay")
-	float SprintDrainRate;
+	float SlateSpeedMultiplier = 0.5f;
 
 	// Interact widget
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
@@ -143,13 +140,20 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Footprint)
 	UFootprintComponent* FootprintComponent;
 
+	// Measures how loud we're talking into the mic so the ghost can hear it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Voice)
+	UVoiceIntensityComponent* VoiceIntensityComponent;
+
 	void EnableSlateSpeed();
 	void DisableSlateSpeed();
 
 	UFUNCTION(BlueprintCallable)
-	float GetRegularWalkSpeed() const { return RegularNormalSpeed; }
+	float GetRegularWalkSpeed() const;
 	UFUNCTION(BlueprintCallable)
-	float GetRegularSprintSpeed() const { return RegularSprintingSpeed; }
+	float GetRegularSprintSpeed() const;
+
+	// Our movement component, which handles sprinting
+	UQUCharacterMovementComponent* GetQUCharacterMovement() const;
 
 	// BP event delegate to trigger when the character picks up a new item
 	UPROPERTY(BlueprintAssignable, Category = "Item Events")
@@ -204,7 +208,14 @@ protected:
 	// Called when E is no longer being held
 	void CancelHoldInteract();
 	
-	void FocusCall();
+	// Called by the interaction focus subsystem when we start looking at an interactable
+	void OnInteractionFocusGained(AActor* Actor, const FVector& FocusLocation);
+
+	// Called by the interaction focus subsystem when we stop looking at an interactable
+	void OnInteractionFocusLost(AActor* Actor);
+
+	// Called by the interaction focus subsystem when we look at a different point on the same interactable
+	void OnInteractionFocusMoved(AActor* Actor, const FVector& FocusLocation);
 	
 	void UnfocusCall();
 
@@ -228,19 +239,9 @@ protected:
 	UFUNCTION()
 	void KeepPhoneUp(UAnimMontage* Montage, bool bInterrupted);
 
-	/** Networked Functions **/
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_StartSprint();
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_StopSprint();
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_ResetSprintBarFill();
-	UFUNCTION(Server, Reliable)
-	void ServerStartSprinting();
-	UFUNCTION(Server, Reliable)
-	void ServerStopSprinting();
-	UFUNCTION(Server, Reliable)
-	void ServerResetSprintBarFill();
+	/** Sprint input, the movement component predicts and replicates the sprint itself **/
+	void StartSprinting();
+	void StopSprinting();
 
 	UPROPERTY(ReplicatedUsing = OnRep_ItemHeld)
 	AItem* ItemHeld = nullptr;
@@ -262,32 +263,8 @@ protected:
 	UPROPERTY()
 	AActor* CurrentHoldProgressionActor = nullptr;
 
-	UPROPERTY(Replicated)
-	float NormalSpeed;
-	UPROPERTY(Replicated)
-	float SprintingSpeed;
-	float SlateNormalSpeed;
-	float SlateSprintingSpeed;
-	float RegularNormalSpeed;
-	float RegularSprintingSpeed;
-
-	UPROPERTY(Replicated)
-	bool SprintBarCanRefill = false;
-	UPROPERTY(ReplicatedUsing=OnRep_IsSprinting)
-	bool CurrentlySprinting = false;
-	float CurrentSprintValue;
-
-	UPROPERTY(Replicated)
-	bool UnlimitedSprint;
-	
-	UFUNCTION()
-	void FillDashMeter();
-
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-	UFUNCTION()
-	void OnRep_IsSprinting() const;
-
 	// Phone anim montages
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Montage", meta = (AllowPrivateAccess = "true"))
 	UAnimMontage* PullPhoneUpMontage;
@@ -0,0 +1,16 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/Engine.h"
+
+// On-screen gameplay debug messages.
+// Compiled out of Shipping, Test and Server builds, and skipped at runtime on dedicated servers
+// since there is no screen to draw them on.
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST || UE_SERVER)
+#define QU_DEBUG_MESSAGE(Duration, Color, Message) \
+	do { if (GEngine && !IsRunningDedicatedServer()) { GEngine->AddOnScreenDebugMessage(-1, Duration, Color, Message); } } while (0)
+#else
+#define QU_DEBUG_MESSAGE(Duration, Color, Message) do { } while (0)
+#endif
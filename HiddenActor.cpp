@@ -3,6 +3,8 @@
 
 #include "HiddenActor.h"
 
+#include "NetworkingPrototype/Managers/HiddenActorIndexSubsystem.h"
+
 // Sets default values
 AHiddenActor::AHiddenActor()
 {
@@ -17,6 +19,27 @@ void AHiddenActor::BeginPlay()
 
 	// Set the actor to be hidden in game by default
 	SetActorHiddenInGame(true);
+
+	// Add ourselves to the hidden actor index so the magnifying glass can find us
+	if (UHiddenActorIndexSubsystem* HiddenActorIndex = GetWorld()->GetSubsystem<UHiddenActorIndexSubsystem>())
+	{
+		HiddenActorIndex->RegisterHiddenActor(this);
+	}
+}
+
+// Called when the actor is being removed from the level
+void AHiddenActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leave the hidden actor index so it never holds onto a destroyed actor
+	if (UWorld* World = GetWorld())
+	{
+		if (UHiddenActorIndexSubsystem* HiddenActorIndex = World->GetSubsystem<UHiddenActorIndexSubsystem>())
+		{
+			HiddenActorIndex->UnregisterHiddenActor(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -3,13 +3,13 @@
 
 #include "HiddenActor_Footprint.h"
 #include "NetworkingPrototype/AnimNotifies/FootprintSpawnNotify.h"
+#include "NetworkingPrototype/Managers/HiddenActorIndexSubsystem.h"
 
 void AHiddenActor_Footprint::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Setup auto destroy timer here
-	
+	// Lifetime is handled by the UFootprintPoolSubsystem that owns this footprint
 }
 
 AHiddenActor_Footprint::AHiddenActor_Footprint()
@@ -38,38 +38,86 @@ void AHiddenActor_Footprint::ChangeFootprintColor(int PlayerIdx, E_FootEmum Foot
 		return;
 	}
 
-	constexpr FLinearColor Red = FLinearColor(1.0f, 0.0f, 0.0f, 1.0f);
-	constexpr FLinearColor Green = FLinearColor(0.0f, 1.0f, 0.0f, 1.0f);
-	constexpr FLinearColor Blue = FLinearColor(0.0f, 0.0f, 1.0f, 1.0f);
-	constexpr FLinearColor Pink = FLinearColor(1.0f, 0.0f, 1.0f, 1.0f);
-	
+	FootprintDecalComp->SetDecalMaterial(GetFootDecalMat(FootSelection));
+
+	FLinearColor PlayerColor;
+	if (GetPlayerFootprintColor(PlayerIdx, PlayerColor))
+	{
+		FootprintDecalComp->SetDecalColor(PlayerColor);
+	}
+}
+
+UMaterial* AHiddenActor_Footprint::GetFootDecalMat(E_FootEmum FootSelection) const
+{
 	switch (FootSelection)
 	{
 	case E_FootEmum::LeftFoot:
-		FootprintDecalComp->SetDecalMaterial(LeftFootDecalMat);
-		break;
+		return LeftFootDecalMat;
 
 	case E_FootEmum::RightFoot:
-		FootprintDecalComp->SetDecalMaterial(RightFootDecalMat);
-		break;
+		return RightFootDecalMat;
 	}
 
+	return nullptr;
+}
+
+bool AHiddenActor_Footprint::GetPlayerFootprintColor(int PlayerIdx, FLinearColor& OutColor)
+{
+	constexpr FLinearColor Red = FLinearColor(1.0f, 0.0f, 0.0f, 1.0f);
+	constexpr FLinearColor Green = FLinearColor(0.0f, 1.0f, 0.0f, 1.0f);
+	constexpr FLinearColor Blue = FLinearColor(0.0f, 0.0f, 1.0f, 1.0f);
+	constexpr FLinearColor Pink = FLinearColor(1.0f, 0.0f, 1.0f, 1.0f);
+
 	switch (PlayerIdx)
 	{
 	case 0:
-		FootprintDecalComp->SetDecalColor(Red);
-		break;
+		OutColor = Red;
+		return true;
 		
 	case 1:
-		FootprintDecalComp->SetDecalColor(Green);
-		break;
+		OutColor = Green;
+		return true;
 
 	case 2:
-		FootprintDecalComp->SetDecalColor(Blue);
-		break;
+		OutColor = Blue;
+		return true;
 
 	case 3:
-		FootprintDecalComp->SetDecalColor(Pink);
-		break;
+		OutColor = Pink;
+		return true;
+	}
+
+	return false;
+}
+
+void AHiddenActor_Footprint::ActivateFootprint(const FTransform& FootprintTransform, int PlayerIdx, E_FootEmum FootSelection)
+{
+	SetActorTransform(FootprintTransform, false, nullptr, ETeleportType::TeleportPhysics);
+
+	// Stay hidden until a magnifying glass reveals us, but let its trace hit us again
+	SetActorHiddenInGame(true);
+	SetIsBeingLookedAt(false);
+	SetActorEnableCollision(true);
+
+	// Put ourselves back in the hidden actor index at our new spot
+	if (UHiddenActorIndexSubsystem* HiddenActorIndex = GetWorld()->GetSubsystem<UHiddenActorIndexSubsystem>())
+	{
+		HiddenActorIndex->RegisterHiddenActor(this);
+	}
+
+	// Change the footprint decal's color and material depending on the foot placed and player idx
+	ChangeFootprintColor(PlayerIdx, FootSelection);
+}
+
+void AHiddenActor_Footprint::DeactivateFootprint()
+{
+	SetActorHiddenInGame(true);
+	SetIsBeingLookedAt(false);
+	SetActorEnableCollision(false);
+
+	// Parked footprints shouldn't show up in magnifying glass queries
+	if (UHiddenActorIndexSubsystem* HiddenActorIndex = GetWorld()->GetSubsystem<UHiddenActorIndexSubsystem>())
+	{
+		HiddenActorIndex->UnregisterHiddenActor(this);
 	}
 }
@@ -43,6 +43,23 @@ public:
 	UFUNCTION()
 	void ChangeFootprintColor(int PlayerIdx, E_FootEmum FootSelection) const;
 
+	// Called by the footprint pool when this footprint gets placed in the world.
+	// Moves it to the passed in transform and re-enables collision so the
+	// magnifying glass can find it again.
+	void ActivateFootprint(const FTransform& FootprintTransform, int PlayerIdx, E_FootEmum FootSelection);
+
+	// Called by the footprint pool when this footprint is aged out or recycled.
+	// Hides it and turns off collision until it gets placed again.
+	void DeactivateFootprint();
+
+	// Getters used by the footprint pool to draw footprints that don't have an actor
+	const UDecalComponent* GetFootprintDecalComp() const { return FootprintDecalComp; }
+	UMaterial* GetFootDecalMat(E_FootEmum FootSelection) const;
+
+	// Gets the decal color for the passed in player idx.
+	// Returns false if the player idx has no color assigned.
+	static bool GetPlayerFootprintColor(int PlayerIdx, FLinearColor& OutColor);
+
 private:
 	// Root component
 	UPROPERTY(EditAnywhere)
@@ -5,6 +5,7 @@
 #include "Kismet/GameplayStatics.h"
 #include "NetworkingPrototype/GameStates/QueriesUnlimitedGameState.h"
 #include "NetworkingPrototype/Ghost/Ghost.h"
+#include "NetworkingPrototype/DebugMessages.h"
 
 // Define the log category
 DEFINE_LOG_CATEGORY(LogBoombox);
@@ -47,7 +48,7 @@ void ABoombox::BeginPlay()
 
 void ABoombox::OnCDChosen(const FCDData& CDData)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Emerald,TEXT("Swap CD"));
+	QU_DEBUG_MESSAGE(2.0f, FColor::Emerald,TEXT("Swap CD"));
 	
 	// Set our new CDData through the server
 	Server_SetCurrentCDData(CDData);
@@ -223,6 +224,19 @@ void ABoombox::EndPlay(const EEndPlayReason::Type EndPlayReason)
 	}
 }
 
+void ABoombox::OnReturnedToPool()
+{
+	Super::OnReturnedToPool();
+
+	if (CDCaseActor)
+	{
+		CDCaseActor->Destroy();
+		CDCaseActor = nullptr;
+	}
+
+	mUserCharacter = nullptr;
+}
+
 void ABoombox::Server_SetCDCaseUp_Implementation(bool bNewCaseUp)
 {
 	bCDCaseUp = bNewCaseUp;
@@ -241,7 +255,7 @@ void ABoombox::EnableUnlimitedSprint_Implementation(ANetworkingPrototypeCharacte
 
 void ABoombox::DisableUnlimitedSprint_Implementation(ANetworkingPrototypeCharacter* MyCharacter)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Emerald, FString(TEXT("Unlimited Sprint Ended!!!!")));
+	QU_DEBUG_MESSAGE(2.0f, FColor::Emerald, FString(TEXT("Unlimited Sprint Ended!!!!")));
 	GetWorldTimerManager().ClearTimer(UnlimitedSprintTimerHandle);
 	MyCharacter->SetUnlimitedSprint(false);
 
@@ -82,6 +82,9 @@ public:
 
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+	// The CD case belongs to whoever was holding us, get rid of it before we're parked
+	virtual void OnReturnedToPool() override;
+
 private:
 	
 	// Networked Functions:
@@ -3,7 +3,10 @@
 #include "Item.h"
 #include "NetworkingPrototype/NetworkingPrototypeGameMode.h"
 #include "Pickup.h"
+#include "Engine/GameInstance.h"
 #include "Net/UnrealNetwork.h"
+#include "NetworkingPrototype/Managers/ItemPoolSubsystem.h"
+#include "NetworkingPrototype/Managers/ItemRegistrySubsystem.h"
 #include "Windows/WindowsApplication.h"
 
 // Sets default values
@@ -49,30 +52,35 @@ void AItem::DropItem(AActor* PlayerUser, bool Respawn)
 	// Spawn Dropped item in world
 	if (HasAuthority())
 	{
-		if (GameMode == NULL)
+		// Look the pickup up in the item registry, items it doesn't know about still go through the GameMode
+		const UItemRegistrySubsystem* ItemRegistry = GetGameInstance()->GetSubsystem<UItemRegistrySubsystem>();
+		ItemToDrop = ItemRegistry ? ItemRegistry->GetPickupClass(ID) : nullptr;
+		if (!ItemToDrop)
 		{
-			return;
+			if (GameMode == NULL)
+			{
+				return;
+			}
+			ItemToDrop = GameMode->GetPickupofItemID(ID);
 		}
-		ItemToDrop = GameMode->GetPickupofItemID(ID);
 		if (ItemToDrop)
 		{
-			UWorld* World = GetWorld();
-			if (World)
+			UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>();
+			if (ItemPool)
 			{
+				// Park ourselves instead of being destroyed, the next pickup of this item wakes us back up.
+				// Done first so a newly spawned pickup sees us parked and doesn't prewarm another item.
+				ItemPool->ReleaseItem(this);
+
 				if (Respawn)
 				{
 					// Specify location and rotation of the new actor to be 10 Units in front of user
 					const FVector SpawnLocation = PlayerUser->GetActorLocation() + (PlayerUser->GetActorForwardVector() * 50);
 					const FRotator SpawnRotation = PlayerUser->GetActorRotation();
 
-					// Spawn parameters
-					FActorSpawnParameters SpawnParams;
-					SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
-					// Spawn Item to be dropped
-					APickup* DroppedItem = World->SpawnActor<APickup>(ItemToDrop, SpawnLocation, SpawnRotation, SpawnParams);
+					// Take the pickup to be dropped from the pool, this only spawns one if none are parked
+					ItemPool->AcquirePickup(ItemToDrop, FTransform(SpawnRotation, SpawnLocation));
 				}
-				Destroy();
 			}
 		}
 		ItemToDrop = nullptr;
@@ -90,6 +98,81 @@ void AItem::Server_DropItem_Implementation(AActor* PlayerUser, bool Respawn)
 		DropItem(PlayerUser, Respawn);
 }
 
+void AItem::SetPooled(bool bNewPooled)
+{
+	if (!HasAuthority() || bIsPooled == bNewPooled)
+	{
+		return;
+	}
+
+	bIsPooled = bNewPooled;
+
+	// OnRep doesn't run on the server, so apply it here
+	ApplyPooledState();
+}
+
+void AItem::OnRep_IsPooled()
+{
+	ApplyPooledState();
+}
+
+void AItem::OnRep_Owner()
+{
+	Super::OnRep_Owner();
+
+	AttachToOwningCharacter();
+}
+
+void AItem::AttachToOwningCharacter()
+{
+	if (bIsPooled)
+	{
+		return;
+	}
+
+	// The owner of the Item MUST be the character pawn
+	ANetworkingPrototypeCharacter* Character = Cast<ANetworkingPrototypeCharacter>(GetOwner());
+	if (!Character)
+	{
+		return;
+	}
+
+	const EAttachmentRule LocationRule = EAttachmentRule::KeepRelative;
+	const EAttachmentRule RotationRule = EAttachmentRule::KeepRelative;
+	const EAttachmentRule ScaleRule = EAttachmentRule::KeepRelative;
+
+	const FAttachmentTransformRules AttachmentTransformRules(LocationRule, RotationRule, ScaleRule, true);
+
+	// Call the helper function to attach us to the character directly
+	if (Character->IsLocallyControlled())
+	{
+		Character->AttachToMesh1P(this, AttachmentTransformRules);
+	}
+	else
+	{
+		Character->AttachToMesh3P(this, AttachmentTransformRules);
+	}
+}
+
+void AItem::ApplyPooledState()
+{
+	// Clients attach held items themselves, so they need to detach them themselves too
+	if (bIsPooled)
+	{
+		DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+		OnParkedLocally();
+	}
+	else
+	{
+		// Our owner might have replicated before we were woken up
+		AttachToOwningCharacter();
+	}
+
+	SetActorHiddenInGame(bIsPooled);
+	SetActorEnableCollision(!bIsPooled);
+	SetActorTickEnabled(!bIsPooled && PrimaryActorTick.bStartWithTickEnabled);
+}
+
 E_ClickType AItem::GetClickType()
 {
 	return E_ClickType::Tap;
@@ -110,5 +193,6 @@ void AItem::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimePro
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(AItem, ItemToDrop);
+	DOREPLIFETIME(AItem, bIsPooled);
 }
 
@@ -63,6 +63,27 @@ public:
 
 	UFUNCTION(BlueprintCallable)
 	FName GetItemName();
+
+	// Parks or wakes the item for the Item Pool Subsystem, server only.
+	// Parked items are hidden, detached and don't collide or tick.
+	void SetPooled(bool bNewPooled);
+
+	// Is this item parked in the Item Pool Subsystem
+	bool IsPooled() const { return bIsPooled; }
+
+	// Called on the server right before the item is parked, clean up anything spawned or started while held
+	virtual void OnReturnedToPool() {}
+
+	// Called on the server and every client when the item is parked,
+	// reset anything this machine started while the item was held
+	virtual void OnParkedLocally() {}
+
+	// Attaches us to the character that owns us, first or third person depending on who's looking.
+	// Does nothing while we're parked or until our owner has replicated.
+	void AttachToOwningCharacter();
+
+	// Owner replicates on its own, a reused item can get it after the pickup that handed it out
+	virtual void OnRep_Owner() override;
 	
 	EndUseItemDelegate OnEndUseItem;
 	OnPickupDelegate OnPickup;
@@ -72,5 +93,15 @@ private:
 
 	UPROPERTY(Replicated)
 	TSubclassOf<APickup> ItemToDrop = nullptr;
+
+	// Is this item parked in the Item Pool Subsystem
+	UPROPERTY(ReplicatedUsing = OnRep_IsPooled)
+	bool bIsPooled = false;
+
+	UFUNCTION()
+	void OnRep_IsPooled();
+
+	// Hides or shows the item to match bIsPooled
+	void ApplyPooledState();
 	
 };
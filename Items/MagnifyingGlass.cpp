@@ -4,6 +4,9 @@
 #include "NetworkingPrototype/Characters/MagnifyingGlass.h"
 
 #include "Net/UnrealNetwork.h"
+#include "NetworkingPrototype/Managers/FootprintPoolSubsystem.h"
+#include "NetworkingPrototype/Managers/HiddenActorIndexSubsystem.h"
+#include "NetworkingPrototype/DebugMessages.h"
 
 // Define the log category
 DEFINE_LOG_CATEGORY(LogMagnifyingGlass);
@@ -63,12 +66,31 @@ void AMagnifyingGlass::UseItem(AActor* user)
 	// Apply a Post Process effect through the lens of the glass
 	
 
+	// UseItem gets called every frame the button is held, so only raise the glass once
+	if (bIsRevealing)
+	{
+		// Without a reveal rate we still reveal every time we're used
+		if (RevealRate <= 0.0f)
+		{
+			RevealHiddenObjects();
+		}
+		return;
+	}
+	bIsRevealing = true;
+
 	// Continue some functionality server side such as animations to play
 	// to all clients
 	Server_UseItem(user);
 	
 	// Reveal Hidden Objects/Textures/Decals to the owning client
 	RevealHiddenObjects();
+
+	// Keep revealing at our reveal rate until the glass is lowered
+	if (RevealRate > 0.0f)
+	{
+		GetWorldTimerManager().SetTimer(RevealTimerHandle, this, &AMagnifyingGlass::RevealHiddenObjects,
+			1.0f / RevealRate, true);
+	}
 }
 
 void AMagnifyingGlass::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -81,7 +103,6 @@ void AMagnifyingGlass::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& Out
 
 void AMagnifyingGlass::RevealHiddenObjects()
 {
-	TArray<FHitResult> HitResults;
 	const float CapsuleRadius = 50.0f;  // Radius of the sphere trace
 	const float CapsuleHalfHeight = 200.0f;
 	
@@ -92,19 +113,9 @@ void AMagnifyingGlass::RevealHiddenObjects()
 	// Perform a line trace or sphere trace to detect hidden objects in front of the magnifying glass
 	const FVector ForwardVec = MiddleOfLens->GetForwardVector();
 	const FVector End = Start + ForwardVec * 1000.0f;
-	
-	// Calculate rotation based on the camera's forward vector (to align the capsule horizontally)
-	const FQuat CapsuleRotation = FRotationMatrix::MakeFromZ(ForwardVec).ToQuat();
 
-	// Trace parameters, we can ignore this actor itself during the trace
-	FCollisionQueryParams TraceParams(FName(TEXT("CapsuleTrace")), true, this);
-
-	//Ignore the character holding the magnifying glass (the user character)
-	if (mUserCharacter)
-	{
-		// Ignore the character (AddIgnoredActor doesnt work with GetOwner for some reason..)
-		TraceParams.AddIgnoredActor(GetOwner());
-	}
+	// The capsule reaches CapsuleHalfHeight past the end of the trace, so the reveal does too
+	float RevealLength = (End - Start).Size() + CapsuleHalfHeight - CapsuleRadius;
 
 	// Debug line trace
 	if (GetWorld() && bShowDebug)
@@ -114,25 +125,69 @@ void AMagnifyingGlass::RevealHiddenObjects()
 		// Draw the debug capsule at the Start and End points
 		//DrawDebugCapsule(GetWorld(), Start, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, FColor::Green, false, 5.0f);
 		//DrawDebugCapsule(GetWorld(), End, CapsuleHalfHeight, CapsuleRadius, FQuat::Identity, FColor::Red, false, 5.0f);
-		
-		// Draw the capsule from Start to End with horizontal orientation
-		//DrawDebugCapsule(GetWorld(), Start, CapsuleHalfHeight, CapsuleRadius, CapsuleRotation, FColor::Purple, false, 5.0f);
 	}
 
-	// Create a temporary set to track the actors you're currently looking at
-	TSet<AHiddenActor*> CurrentLookedAtActors;
-
-	// MULTI SWEEP
-	if (GetWorld()->SweepMultiByChannel(HitResults,      // Output hit result
-			Start,          // Start of the trace
-			End,            // End of the trace
-			CapsuleRotation, // Rotate 90 on the y axis
-			ECC_Camera, // Collision channel
-			FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), // The collision shape (sphere)
-			TraceParams     // Additional trace parameters);
-		))
+	// The index doesn't know about walls, so stop the reveal at the first piece of static geometry
+	// the same way the sweep stops at its first blocking hit. A single line trace is far cheaper than the sweep.
+	if (bUseHiddenActorIndex)
 	{
-		for (auto HitResult : HitResults)
+		FHitResult WallHit;
+		FCollisionQueryParams WallTraceParams(FName(TEXT("RevealWallTrace")), false, this);
+		if (GetWorld()->LineTraceSingleByObjectType(WallHit, Start, Start + ForwardVec * RevealLength,
+			FCollisionObjectQueryParams(ECC_WorldStatic), WallTraceParams))
+		{
+			RevealLength = WallHit.Distance + CapsuleRadius;
+		}
+	}
+
+	// Footprints stored as records have no actor for the sweep to hit, so ask the pool for them directly.
+	if (UFootprintPoolSubsystem* FootprintPool = GetWorld()->GetSubsystem<UFootprintPoolSubsystem>())
+	{
+		FootprintPool->RevealFootprintsAlongSegment(this, Start, Start + ForwardVec * RevealLength, CapsuleRadius);
+	}
+
+	// Reuse last update's set so steady state reveals don't allocate
+	CurrentLookedAtActors.Reset();
+
+	if (bUseHiddenActorIndex)
+	{
+		// Walk the grid cells in front of the lens, this never touches the physics scene
+		if (UHiddenActorIndexSubsystem* HiddenActorIndex = GetWorld()->GetSubsystem<UHiddenActorIndexSubsystem>())
+		{
+			HiddenActorIndex->QueryCone(Start, ForwardVec, RevealLength, CapsuleRadius, RevealConeHalfAngle, IndexedHiddenActors);
+
+			for (AHiddenActor* HiddenActor : IndexedHiddenActors)
+			{
+				RevealHiddenActor(HiddenActor);
+			}
+		}
+	}
+	else
+	{
+		// Calculate rotation based on the camera's forward vector (to align the capsule horizontally)
+		const FQuat CapsuleRotation = FRotationMatrix::MakeFromZ(ForwardVec).ToQuat();
+
+		// Trace parameters, we can ignore this actor itself during the trace
+		FCollisionQueryParams TraceParams(FName(TEXT("CapsuleTrace")), true, this);
+
+		//Ignore the character holding the magnifying glass (the user character)
+		if (mUserCharacter)
+		{
+			// Ignore the character (AddIgnoredActor doesnt work with GetOwner for some reason..)
+			TraceParams.AddIgnoredActor(GetOwner());
+		}
+
+		// MULTI SWEEP
+		GetWorld()->SweepMultiByChannel(SweepHitResults,      // Output hit result
+				Start,          // Start of the trace
+				End,            // End of the trace
+				CapsuleRotation, // Rotate 90 on the y axis
+				ECC_Camera, // Collision channel
+				FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), // The collision shape (sphere)
+				TraceParams     // Additional trace parameters);
+			);
+
+		for (const FHitResult& HitResult : SweepHitResults)
 		{
 			if (bShowDebug)
 			{
@@ -145,55 +200,83 @@ void AMagnifyingGlass::RevealHiddenObjects()
 				if (bShowDebug)
 				{
 					// Print the name of the hit actor
-					GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Green, FString::Printf(TEXT("Hit actor: %s"), *HitActor->GetName()));
+					QU_DEBUG_MESSAGE(1.0f, FColor::Green, FString::Printf(TEXT("Hit actor: %s"), *HitActor->GetName()));
 				}
 				
 				// Check to see if the actor is of type AHiddenActor
-				AHiddenActor* HiddenActor = Cast<AHiddenActor>(HitActor);
-				if (HiddenActor)
-				{
-					// Set the actor to visible and mark it as being looked at
-					HiddenActor->SetActorHiddenInGame(false);
-					HiddenActor->SetIsBeingLookedAt(true);
-	                
-					// Add the actor to the revealed map if it's not already in it
-					if (!mRevealedActorsMap.Contains(HiddenActor->GetName()))
-					{
-						mRevealedActorsMap.Add(HiddenActor->GetName(), HiddenActor);
-						if (bShowDebug)
-						{
-							GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Green, FString::Printf(TEXT("Revealing Actor")));
-						}
-					}
-					
-					// Add to the current looked-at set
-					CurrentLookedAtActors.Add(HiddenActor);
-				}
+				RevealHiddenActor(Cast<AHiddenActor>(HitActor));
 			}
 		}
+	}
 
-		TArray<FString> KeysToRemove;
-		// Now check for actors that are no longer being looked at
-		for (const auto& Elem : mRevealedActorsMap)
-		{
-			if (!CurrentLookedAtActors.Contains(Elem.Value))
-			{
-				Elem.Value->SetActorHiddenInGame(true);
-				Elem.Value->SetIsBeingLookedAt(false);
-				KeysToRemove.Add(Elem.Key);
+	// Hide everything we revealed before that isn't in front of the lens anymore
+	HideActorsNoLongerLookedAt();
+}
 
-				if (bShowDebug)
-				{
-					GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("Hiding Actor"));
-				}
-			}
-		}
+void AMagnifyingGlass::RevealHiddenActor(AHiddenActor* HiddenActor)
+{
+	if (!HiddenActor)
+	{
+		return;
+	}
+
+	if (bShowDebug && bUseHiddenActorIndex)
+	{
+		DrawDebugSphere(GetWorld(), HiddenActor->GetActorLocation(), 10.0f, 4, FColor::Green, false, 1.0f);
+	}
+
+	// Add to the current looked-at set
+	const TWeakObjectPtr<AHiddenActor> HiddenActorPtr(HiddenActor);
+	CurrentLookedAtActors.Add(HiddenActorPtr);
+
+	// Only touch actors that just came into view. Pooled footprints can get recycled
+	// while we are looking at them, so also check they are still marked as looked at.
+	if (RevealedActors.Contains(HiddenActorPtr) && HiddenActor->GetIsBeingLookedAt())
+	{
+		return;
+	}
 
-		// Now remove safely outside the loop
-		for (const FString& Key : KeysToRemove)
+	// Set the actor to visible and mark it as being looked at
+	HiddenActor->SetActorHiddenInGame(false);
+	HiddenActor->SetIsBeingLookedAt(true);
+	RevealedActors.Add(HiddenActorPtr);
+
+	if (bShowDebug)
+	{
+		QU_DEBUG_MESSAGE(1.0f, FColor::Green, FString::Printf(TEXT("Revealing Actor")));
+	}
+}
+
+void AMagnifyingGlass::HideActorsNoLongerLookedAt()
+{
+	// Check for actors that are no longer being looked at, removing through the iterator
+	// keeps the set's memory around for the next update
+	for (auto It = RevealedActors.CreateIterator(); It; ++It)
+	{
+		if (CurrentLookedAtActors.Contains(*It))
 		{
-			mRevealedActorsMap.Remove(Key);
+			continue;
 		}
+
+		HideRevealedActor(It->Get());
+		It.RemoveCurrent();
+	}
+}
+
+void AMagnifyingGlass::HideRevealedActor(AHiddenActor* RevealedActor)
+{
+	// The actor might have been destroyed while we were looking at it
+	if (!RevealedActor)
+	{
+		return;
+	}
+
+	RevealedActor->SetActorHiddenInGame(true);
+	RevealedActor->SetIsBeingLookedAt(false);
+
+	if (bShowDebug)
+	{
+		QU_DEBUG_MESSAGE(1.0f, FColor::Red, TEXT("Hiding Actor"));
 	}
 }
 
@@ -205,25 +288,58 @@ void AMagnifyingGlass::RevealHiddenObjects()
  */
 void AMagnifyingGlass::LowerMagnifyingGlass(ANetworkingPrototypeCharacter* UserCharacter)
 {
-	for (auto Elem : mRevealedActorsMap)
+	StopRevealing();
+
+	// Play the lowering len's animation to all clients including the owning client's
+	Server_PlayLowerLensAnim();
+
+}
+
+void AMagnifyingGlass::StopRevealing()
+{
+	// Stop the continuous reveal
+	GetWorldTimerManager().ClearTimer(RevealTimerHandle);
+	bIsRevealing = false;
+
+	for (const TWeakObjectPtr<AHiddenActor>& RevealedActor : RevealedActors)
 	{
-		AHiddenActor* RevealedActor = Elem.Value;
-	
-		RevealedActor->SetActorHiddenInGame(true);
-		RevealedActor->SetIsBeingLookedAt(false);
+		HideRevealedActor(RevealedActor.Get());
+	}
 
-		if (bShowDebug)
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, FString::Printf(TEXT("Hiding all Hidden Actors")));
-		}
+	if (bShowDebug)
+	{
+		QU_DEBUG_MESSAGE(1.0f, FColor::Red, FString::Printf(TEXT("Hiding all Hidden Actors")));
 	}
 
-	// Clear our revealed actors map
-	mRevealedActorsMap.Empty();
+	// Clear our revealed actors, keeping the memory for the next time the glass is raised
+	RevealedActors.Reset();
+	CurrentLookedAtActors.Reset();
 
-	// Play the lowering len's animation to all clients including the owning client's
-	Server_PlayLowerLensAnim();
+	// Hide any footprint records the glass was showing
+	if (UFootprintPoolSubsystem* FootprintPool = GetWorld()->GetSubsystem<UFootprintPoolSubsystem>())
+	{
+		FootprintPool->HideRevealedFootprints(this);
+	}
+}
+
+void AMagnifyingGlass::OnParkedLocally()
+{
+	Super::OnParkedLocally();
 
+	// Dropped while held up, the lower never came
+	if (bIsRevealing)
+	{
+		StopRevealing();
+	}
+
+	mUserCharacter = nullptr;
+
+	// The server puts the glass down for everyone, clients get it through OnRep_IsHeldUp
+	if (HasAuthority() && bIsHeldUp)
+	{
+		bIsHeldUp = false;
+		OnRep_IsHeldUp();
+	}
 }
 
 void AMagnifyingGlass::OnPickupItem(ANetworkingPrototypeCharacter* Interactor)
@@ -34,6 +34,9 @@ public:
 	virtual void UseItem(AActor* user) override;
 	virtual E_ClickType GetClickType() override { return E_ClickType::Hold; }
 
+	// Stops revealing and forgets our holder so the next one starts fresh
+	virtual void OnParkedLocally() override;
+
 	// Replication functions
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
@@ -42,16 +45,36 @@ public:
 	FBPStateChanged OnStateChanged;
 
 private:
+#if WITH_DEV_AUTOMATION_TESTS
+	// Drives RevealHiddenObjects directly to count its allocations
+	friend class FMagnifyingGlassRevealAllocationTest;
+#endif
+
 	// Helper Functions:
 
 	// The actual functionality of holding up the MG.
 	// Reveals Actors of class AHiddenActor, client side. 
+	// Runs every RevealRate while the glass is held up.
 	void RevealHiddenObjects();
 
-	// Empties mRevealedActorsMap and hides all AHiddenActors,
+	// Adds a hidden actor found by the reveal to CurrentLookedAtActors,
+	// and shows it if it just came into view
+	void RevealHiddenActor(AHiddenActor* HiddenActor);
+
+	// Hides every revealed actor that isn't in CurrentLookedAtActors
+	// and removes it from RevealedActors
+	void HideActorsNoLongerLookedAt();
+
+	// Hides a single revealed actor
+	void HideRevealedActor(AHiddenActor* RevealedActor);
+
+	// Stops the reveal, empties RevealedActors and hides all AHiddenActors,
 	// then calls Server_PlayLowerLensAnim
 	void LowerMagnifyingGlass(ANetworkingPrototypeCharacter* UserCharacter);
 
+	// Stops the reveal timer and hides everything this machine revealed
+	void StopRevealing();
+
 	// Called when a player interacts with the MG pickup and spawns this item.
 	// Sets that player character as the owner of this MG.
 	UFUNCTION()
@@ -91,9 +114,38 @@ private:
 	UPROPERTY(Replicated)
 	ANetworkingPrototypeCharacter* mUserCharacter;
 
-	// Map to hold our currently revealed actors
+	// Actors we are currently revealing
+	TSet<TWeakObjectPtr<AHiddenActor>> RevealedActors;
+
+	// Actors found by the current reveal, kept around between reveals so it never reallocates
+	TSet<TWeakObjectPtr<AHiddenActor>> CurrentLookedAtActors;
+
+	// Reused every reveal for the sweep results when not using the index
+	TArray<FHitResult> SweepHitResults;
+
+	// How many times per second to reveal while the glass is held up.
+	// 0 or less reveals every time the item is used instead.
+	UPROPERTY(EditAnywhere, Category = "Reveal", meta = (ClampMin = "0.0"))
+	float RevealRate = 20.0f;
+
+	// Continuous reveal timer
+	FTimerHandle RevealTimerHandle;
+
+	// Local flag for whether we've raised the glass and started revealing
+	bool bIsRevealing = false;
+
+	// Find hidden actors through the UHiddenActorIndexSubsystem grid instead of a physics sweep.
+	// The sweep is kept around to compare against.
+	UPROPERTY(EditAnywhere, Category = "Reveal")
+	bool bUseHiddenActorIndex = true;
+
+	// Half angle in degrees the reveal widens by along its length when using the index, 0 keeps it a capsule
+	UPROPERTY(EditAnywhere, Category = "Reveal", meta = (ClampMin = "0.0", ClampMax = "45.0"))
+	float RevealConeHalfAngle = 0.0f;
+
+	// Reused every reveal for the index query results
 	UPROPERTY()
-	TMap<FString, AHiddenActor*> mRevealedActorsMap;
+	TArray<AHiddenActor*> IndexedHiddenActors;
 
 	// Simple bool to show/hide debug lines
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
@@ -4,6 +4,9 @@
 #include "Pickup.h"
 
 #include "Net/UnrealNetwork.h"
+#include "NetworkingPrototype/Managers/InteractionFocusSubsystem.h"
+#include "NetworkingPrototype/Managers/ItemPoolSubsystem.h"
+#include "NetworkingPrototype/DebugMessages.h"
 
 // Define the log category
 DEFINE_LOG_CATEGORY(LogPickup);
@@ -36,11 +39,46 @@ APickup::APickup(TSubclassOf<AItem> DefaultItem)
 void APickup::BeginPlay()
 {
 	Super::BeginPlay();
-	
+
+	// Add ourselves to the interaction focus index so players can look at us
+	if (UInteractionFocusSubsystem* InteractionFocus = GetWorld()->GetSubsystem<UInteractionFocusSubsystem>())
+	{
+		InteractionFocus->RegisterInteractable(this);
+	}
+
+	// Park an item for us ahead of time so picking us up doesn't have to spawn one
+	if (HasAuthority())
+	{
+		if (UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
+		{
+			ItemPool->PrewarmItems(Item, 1);
+		}
+	}
+}
+
+// Called when the actor is being removed from the level
+void APickup::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leave the interaction focus index so it never holds onto a destroyed actor
+	if (UWorld* World = GetWorld())
+	{
+		if (UInteractionFocusSubsystem* InteractionFocus = World->GetSubsystem<UInteractionFocusSubsystem>())
+		{
+			InteractionFocus->UnregisterInteractable(this);
+		}
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void APickup::OnRep_SpawnedItem()
 {
+	// Cleared when we go back to the pool, nothing to attach
+	if (!mSpawnedItem)
+	{
+		return;
+	}
+
 	// Hide our pickup visually
 	SetActorHiddenInGame(true);
 	// Disable interactions
@@ -48,43 +86,8 @@ void APickup::OnRep_SpawnedItem()
 	// Disable Collisions
 	SetActorEnableCollision(false);
 	
-	// Call Attach logic for clients
-	if (mSpawnedItem && mSpawnedItem->GetOwner())
-	{
-		// The owner of the Item MUST be the character pawn
-		ANetworkingPrototypeCharacter* Character = Cast<ANetworkingPrototypeCharacter>(mSpawnedItem->GetOwner());
-		if (!Character)
-		{
-			return;
-		}
-	
-		if (Character->IsLocallyControlled())
-		{
-			//AttachToPlayer(mSpawnedItem->GetOwner());  // If it's the locally controlled player
-
-			const EAttachmentRule LocationRule = EAttachmentRule::KeepRelative;
-			const EAttachmentRule RotationRule = EAttachmentRule::KeepRelative;
-			const EAttachmentRule ScaleRule = EAttachmentRule::KeepRelative;
-
-			const FAttachmentTransformRules AttachmentTransformRules(LocationRule, RotationRule, ScaleRule, true);
-
-			// Call the helper function to attach SpawnedItem to the character directly
-			Character->AttachToMesh1P(mSpawnedItem, AttachmentTransformRules);
-		}
-		else 
-		{
-			//AttachToOtherPlayer(mSpawnedItem->GetOwner());  // If it's another player's character
-
-			const EAttachmentRule LocationRule = EAttachmentRule::KeepRelative;
-			const EAttachmentRule RotationRule = EAttachmentRule::KeepRelative;
-			const EAttachmentRule ScaleRule = EAttachmentRule::KeepRelative;
-
-			const FAttachmentTransformRules AttachmentTransformRules(LocationRule, RotationRule, ScaleRule, true);
-
-			// Call the helper function to attach SpawnedItem to the character directly
-			Character->AttachToMesh3P(mSpawnedItem, AttachmentTransformRules);
-		}
-	}
+	// The item also attaches itself when its owner replicates, which can arrive before or after us
+	mSpawnedItem->AttachToOwningCharacter();
 }
 
 void APickup::Interact_Implementation(AActor* Interactor)
@@ -104,7 +107,7 @@ void APickup::Interact_Implementation(AActor* Interactor)
 			{
 				// If the item we spawn is NOT a slate AND this character is holding a slate,
 				// Don't let them pick this item up
-				GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Emerald,TEXT("Player is holding a slate and is trying to pickup an item that is not a slate!"));
+				QU_DEBUG_MESSAGE(2.0f, FColor::Emerald,TEXT("Player is holding a slate and is trying to pickup an item that is not a slate!"));
 				return;
 			}
 			else if (ItemIsSlate && ThisCharacter->GetHeldSlate())
@@ -120,17 +123,18 @@ void APickup::Interact_Implementation(AActor* Interactor)
 		if (World)
 		{
 
+			UItemPoolSubsystem* ItemPool = World->GetSubsystem<UItemPoolSubsystem>();
+			if (!ItemPool)
+			{
+				return;
+			}
+
 			// Specify the location and rotation for the new actor
 			const FVector SpawnLocation(0.0f, 0.0f, 100.0f);   // X, Y, Z coordinates
 			const FRotator SpawnRotation(0.0f, 0.0f, 0.0f);   // Pitch, Yaw, Roll
 
-			// Spawn parameters
-			FActorSpawnParameters SpawnParams;
-			SpawnParams.Owner = Interactor; // Hopefully this doesn't break anything
-			SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
-
-			// Spawn the actor
-			mSpawnedItem = World->SpawnActor<AItem>(Item, SpawnLocation, SpawnRotation, SpawnParams);
+			// Take the item from the pool, this only spawns one if none are parked
+			mSpawnedItem = ItemPool->AcquireItem(Item, Interactor, FTransform(SpawnRotation, SpawnLocation));
 
 			if (!mSpawnedItem)
 			{
@@ -141,17 +145,17 @@ void APickup::Interact_Implementation(AActor* Interactor)
 			// Set the Item's owner to be the one that interacted with this pickup
 			mSpawnedItem->SetOwner(Interactor);
 
-			UE_LOG(LogPickup, Log, TEXT("Actor spawned successfully: %s"), *mSpawnedItem->GetName());
+			UE_LOG(LogPickup, Log, TEXT("Item handed out successfully: %s"), *mSpawnedItem->GetName());
 
 			// Call the OnRep that is responsible for attachment on the server since
 			// the OnRep func doesn't get called on the server unless manually called
 			OnRep_SpawnedItem();
 			
-			GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Emerald, FString(TEXT("PICK UP IMPLEMENTATION!!!!")));
+			QU_DEBUG_MESSAGE(2.0f, FColor::Emerald, FString(TEXT("PICK UP IMPLEMENTATION!!!!")));
 			
-			// Ensure the actor is destroyed after a delay
-			// We don't immediately destroy because we need the Multicast to finish processing
-			SetLifeSpan(0.5f);
+			// Go back to the pool after a delay
+			// We don't immediately park because clients need the spawned item to attach it first
+			GetWorldTimerManager().SetTimer(ReturnToPoolTimerHandle, this, &APickup::ReturnToPool, 0.5f, false);
 		}
 	}
 	else
@@ -166,10 +170,79 @@ void APickup::Server_Interact_Implementation(AActor* Interactor)
 		Interact_Implementation(Interactor);
 }
 
+void APickup::SetPooled(bool bNewPooled)
+{
+	if (!HasAuthority() || bIsPooled == bNewPooled)
+	{
+		return;
+	}
+
+	bIsPooled = bNewPooled;
+
+	// The pool moves us before waking us up, send clients where that was
+	if (!bIsPooled)
+	{
+		PooledLocation = GetActorLocation();
+		PooledRotation = GetActorRotation();
+	}
+
+	// OnRep doesn't run on the server, so apply it here
+	ApplyPooledState();
+}
+
+void APickup::OnRep_IsPooled()
+{
+	ApplyPooledState();
+}
+
+void APickup::ApplyPooledState()
+{
+	// Move to where the server woke us up before we show up or join the focus index there
+	if (!bIsPooled && !HasAuthority())
+	{
+		SetActorLocationAndRotation(PooledLocation, PooledRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	}
+
+	SetActorHiddenInGame(bIsPooled);
+	SetCanInteract(!bIsPooled);
+	SetActorEnableCollision(!bIsPooled);
+
+	// Parked pickups leave the interaction focus index, woken ones come back at their new location
+	if (UInteractionFocusSubsystem* InteractionFocus = GetWorld()->GetSubsystem<UInteractionFocusSubsystem>())
+	{
+		if (bIsPooled)
+		{
+			InteractionFocus->UnregisterInteractable(this);
+		}
+		else
+		{
+			InteractionFocus->RegisterInteractable(this);
+		}
+	}
+}
+
+void APickup::ReturnToPool()
+{
+	// The item belongs to whoever picked it up now
+	mSpawnedItem = nullptr;
+
+	if (UItemPoolSubsystem* ItemPool = GetWorld()->GetSubsystem<UItemPoolSubsystem>())
+	{
+		ItemPool->ReleasePickup(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
 void APickup::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
 	DOREPLIFETIME(APickup, mSpawnedItem);
+	DOREPLIFETIME(APickup, bIsPooled);
+	DOREPLIFETIME(APickup, PooledLocation);
+	DOREPLIFETIME(APickup, PooledRotation);
 }
 
@@ -26,9 +26,36 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the actor is being removed from the level
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
 	bool ItemIsSlate = false;
 
+	// Is this pickup parked in the Item Pool Subsystem
+	UPROPERTY(ReplicatedUsing = OnRep_IsPooled)
+	bool bIsPooled = false;
+
+	UFUNCTION()
+	void OnRep_IsPooled();
+
+	// Where the pool last woke us up. Sent alongside bIsPooled so clients move us
+	// before showing us, pickups don't replicate movement otherwise.
+	UPROPERTY(Replicated)
+	FVector_NetQuantize PooledLocation;
+
+	UPROPERTY(Replicated)
+	FRotator PooledRotation;
+
+	// Hides or shows the pickup to match bIsPooled
+	void ApplyPooledState();
+
+	// Hands this pickup back to the Item Pool Subsystem once its item has reached clients
+	void ReturnToPool();
+
+	// Delay before a picked up pickup goes back to the pool
+	FTimerHandle ReturnToPoolTimerHandle;
+
 public:	
 
 	//======== Properties =============
@@ -46,6 +73,13 @@ public:
 
 	//========== Functions =============
 
+	// Parks or wakes the pickup for the Item Pool Subsystem, server only.
+	// Parked pickups are hidden and can't be interacted with.
+	void SetPooled(bool bNewPooled);
+
+	// Is this pickup parked in the Item Pool Subsystem
+	bool IsPooled() const { return bIsPooled; }
+
 	UFUNCTION(BlueprintImplementableEvent)
 	void BPPickUpItem(AActor* Interactor);
 
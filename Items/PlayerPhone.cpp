@@ -4,16 +4,30 @@
 #include "NetworkingPrototype/Public/PlayerPhone.h"
 
 #include "Components/AudioComponent.h"
+#include "Engine/GameInstance.h"
+#include "Engine/LocalPlayer.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Sound/SoundWave.h"
 #include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
 #include "OnsetVoip/Public/OnsetVoipWorldSubsystem.h"
 #include "AkGameplayStatics.h"
 #include "NetworkingPrototype/Characters/QUPlayerState.h"
+#include "NetworkingPrototype/Managers/PhoneAudioCacheSubsystem.h"
+#include "NetworkingPrototype/Managers/PhoneChannelSubsystem.h"
+#include "NetworkingPrototype/DebugMessages.h"
+#include "NetworkingPrototype/RPCStats.h"
 
 // Define the log category
 DEFINE_LOG_CATEGORY(LogPlayerPhone);
 
+// Phone call RPCs and call state updates, to compare network traffic per call
+CSV_DEFINE_CATEGORY(Phone, true);
+
 // Hear ourselves
 //#define VOICE_LOOPBACK 1
 
@@ -33,6 +47,9 @@ APlayerPhone::APlayerPhone()
 	PhoneSkele->CastShadow = false;
 	//PhoneSkele->SetRelativeLocation(FVector(-30.f, 0.f, -150.f));
 
+	// Sound, screen and lights are never created in a server build,
+	// dedicated servers run from the editor or a game build still strip them in BeginPlay
+#if !UE_SERVER
 	// Default create an audio component
 	PhoneAudioComponent = CreateDefaultSubobject<UAudioComponent>(TEXT("PhoneAudioComp"));
 	// Set Audio Parent to the phone skeleton
@@ -63,6 +80,7 @@ APlayerPhone::APlayerPhone()
 	// Phone screen light
 	PhoneScreenPLight = CreateDefaultSubobject<UPointLightComponent>(TEXT("PhoneScreenPLight"));
 	PhoneScreenPLight->SetupAttachment(PhoneSkele, PhoneScreenSocketName);
+#endif
 
 	// Setup networked replication
 	bReplicates = true;
@@ -80,6 +98,13 @@ void APlayerPhone::BeginPlay()
 	}
 	mOwningCharacter = Cast<ANetworkingPrototypeCharacter>(Owner);
 
+	// Dedicated servers only run the call logic
+	if (IsNetMode(NM_DedicatedServer))
+	{
+		StripCosmeticComponents();
+		return;
+	}
+
 	// Set visibility of our widget comp and phone lights to false by default
 	PhoneScreenWidgetPopUp->SetVisibility(false);
 	PhoneScreenLight->SetVisibility(false);
@@ -107,6 +132,91 @@ void APlayerPhone::BeginPlay()
 			mPlayerPhoneWidget->SetOwningPlayer(PC);
 		}
 	}
+
+	// Other players' phones don't need the screen or lights
+	UpdateProxyMode();
+}
+
+void APlayerPhone::UpdateProxyMode()
+{
+	if (bProxyModeDecided)
+	{
+		return;
+	}
+
+	// Compare player states, the owning character might not be possessed yet on the server
+	// and other players' characters never have a controller on clients
+	const ULocalPlayer* LocalPlayer = GetWorld()->GetFirstLocalPlayerFromController();
+	const APlayerController* LocalPC = LocalPlayer ? LocalPlayer->GetPlayerController(GetWorld()) : nullptr;
+	const APlayerState* LocalPS = LocalPC ? LocalPC->PlayerState.Get() : nullptr;
+	const APlayerState* OwnerPS = mOwningCharacter ? mOwningCharacter->GetPlayerState() : nullptr;
+
+	if (!LocalPS || !OwnerPS)
+	{
+		GetWorldTimerManager().SetTimer(ProxyModeTimerHandle, this, &APlayerPhone::UpdateProxyMode, ProxyModeRetryInterval, false);
+		return;
+	}
+
+	bProxyModeDecided = true;
+
+	if (LocalPS != OwnerPS)
+	{
+		EnterProxyMode();
+	}
+}
+
+void APlayerPhone::EnterProxyMode()
+{
+	bIsProxy = true;
+
+	DestroyScreenComponents();
+
+	// Ringtones and UI sounds share the one audio component we keep
+	if (PhoneAudioRingtoneComp)
+	{
+		PhoneAudioRingtoneComp->DestroyComponent();
+		PhoneAudioRingtoneComp = nullptr;
+	}
+}
+
+void APlayerPhone::DestroyScreenComponents()
+{
+	mPlayerPhoneWidget = nullptr;
+
+	if (PhoneScreenWidgetPopUp)
+	{
+		PhoneScreenWidgetPopUp->DestroyComponent();
+		PhoneScreenWidgetPopUp = nullptr;
+	}
+	if (PhoneScreenLight)
+	{
+		PhoneScreenLight->DestroyComponent();
+		PhoneScreenLight = nullptr;
+	}
+	if (PhoneScreenPLight)
+	{
+		PhoneScreenPLight->DestroyComponent();
+		PhoneScreenPLight = nullptr;
+	}
+}
+
+void APlayerPhone::StripCosmeticComponents()
+{
+	DestroyScreenComponents();
+
+	// Keep the audible range around, the server still uses it to pick who gets UI sounds
+	PhoneUIAudioRange = GetPhoneUIAudioRange();
+
+	if (PhoneAudioComponent)
+	{
+		PhoneAudioComponent->DestroyComponent();
+		PhoneAudioComponent = nullptr;
+	}
+	if (PhoneAudioRingtoneComp)
+	{
+		PhoneAudioRingtoneComp->DestroyComponent();
+		PhoneAudioRingtoneComp = nullptr;
+	}
 }
 
 // Called every frame
@@ -120,109 +230,204 @@ void APlayerPhone::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLife
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME(APlayerPhone, mCurrentChannel);
-	DOREPLIFETIME(APlayerPhone, bIsInCall);
-	DOREPLIFETIME(APlayerPhone, PhoneAudioComponent);
-	DOREPLIFETIME(APlayerPhone, PhoneAudioRingtoneComp);
+	DOREPLIFETIME_CONDITION(APlayerPhone, CallState, COND_OwnerOnly);
 }
 
-void APlayerPhone::Client_NotifyCallReceived_Implementation(APlayerState* CallerPlayerState, APlayerPhone* CallerPhone, uint32 ChannelID)
+void APlayerPhone::Client_NotifyLineBusy_Implementation(E_PhoneLineBusyReason Reason)
 {
-	if (!CallerPhone)
+	QU_COUNT_RPC(Client_NotifyLineBusy);
+	// Let any subscribers know the call couldn't go through
+	OnLineBusy.Broadcast(Reason);
+}
+
+void APlayerPhone::NotifyLineBusy(E_PhoneLineBusyReason Reason)
+{
+	// Let anything on the server know first
+	if (UPhoneChannelSubsystem* PhoneChannels = GetWorld()->GetSubsystem<UPhoneChannelSubsystem>())
+	{
+		PhoneChannels->BroadcastLineBusy(this, Reason);
+	}
+
+	// Then the caller
+	Client_NotifyLineBusy(Reason);
+}
+
+void APlayerPhone::Server_PlayPhoneAudio_Implementation(E_AudioType AudioType)
+{
+	QU_COUNT_RPC(Server_PlayPhoneAudio);
+	// Only UI sounds come through here, the ringtone is played by the server itself
+	if (AudioType == E_AudioType::Ringtone)
+	{
+		return;
+	}
+
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (!GameState)
 	{
 		return;
 	}
 
-	// Broadcast the dynamic delegate to notify the client
-	OnCallReceived.Broadcast(CallerPlayerState, ChannelID);
+	const FVector PhoneLocation = GetActorLocation();
+	const float RangeSquared = FMath::Square(GetPhoneUIAudioRange());
 
-	// Clear the existing timer
-	GetWorldTimerManager().ClearTimer(PhoneCallTimeoutHandle);
+	// Only send the sound to players close enough to hear it
+	for (const APlayerState* PlayerState : GameState->PlayerArray)
+	{
+		const ANetworkingPrototypeCharacter* Listener = PlayerState ? Cast<ANetworkingPrototypeCharacter>(PlayerState->GetPawn()) : nullptr;
+
+		// Our own player already played it locally
+		if (!Listener || Listener == GetOwner())
+		{
+			continue;
+		}
 
-	// Restart the timer **without resetting progress**
-	GetWorldTimerManager().SetTimer(PhoneCallTimeoutHandle, this, &APlayerPhone::PendingCallTimeout, CallTimeoutTime, false);
+		if (FVector::DistSquared(Listener->GetActorLocation(), PhoneLocation) > RangeSquared)
+		{
+			continue;
+		}
 
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green, TEXT("Call received on the client!"));
+		// Send it through the listener's own phone since that's the actor their connection owns
+		if (APlayerPhone* ListenerPhone = Listener->GetPlayerPhone())
+		{
+			ListenerPhone->Client_PlayPhoneAudio(this, AudioType);
+		}
+	}
 }
 
-void APlayerPhone::Client_NotifyCallStarted_Implementation(APlayerState* TargetPlayerState, uint32 ChannelID)
+void APlayerPhone::Client_PlayPhoneAudio_Implementation(APlayerPhone* SourcePhone, E_AudioType AudioType)
 {
-	// Broadcast the dynamic delegate to notify the client
-	OnCallStarted.Broadcast(TargetPlayerState, ChannelID);
+	QU_COUNT_RPC(Client_PlayPhoneAudio);
+	if (SourcePhone)
+	{
+		SourcePhone->PlayPhoneAudioLocal(AudioType);
+	}
+}
 
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green, TEXT("Call started on the client!"));
+void APlayerPhone::Multicast_PlayPhoneAudio_Implementation(APlayerPhone* TargetPhone, E_AudioType AudioType)
+{
+	QU_COUNT_RPC(Multicast_PlayPhoneAudio);
+	if (TargetPhone)
+	{
+		TargetPhone->PlayPhoneAudioLocal(AudioType);
+	}
 }
 
-void APlayerPhone::Server_PlayPhoneAudio_Implementation(APlayerPhone* TargetPhone, E_AudioType AudioType)
+void APlayerPhone::PlayPhoneUISound(E_AudioType AudioType)
 {
-	Multicast_PlayPhoneAudio(TargetPhone, AudioType);
+	// Our own clicks play right away instead of waiting on a round trip
+	PlayPhoneAudioLocal(AudioType);
+	Server_PlayPhoneAudio(AudioType);
 }
 
-void APlayerPhone::Multicast_PlayPhoneAudio_Implementation(APlayerPhone* TargetPhone, E_AudioType AudioType)
+void APlayerPhone::PlayPhoneAudioLocal(E_AudioType AudioType)
 {
-	if (!TargetPhone || !TargetPhone->PhoneAudioComponent || !TargetPhone->PhoneAudioRingtoneComp
-		|| !AkRingtoneEvent || !AkLeftEvent || !AkRightEvent || !AkBackEvent || !AkConfirmEvent
-		|| !AkOpenPhoneEvent || !AkClosePhoneEvent)
+	// The ringtone has its own component so UI sounds don't cut it off, proxy phones only have the one
+	UAudioComponent* AudioComponent = (AudioType == E_AudioType::Ringtone && PhoneAudioRingtoneComp) ? PhoneAudioRingtoneComp : PhoneAudioComponent;
+	const TSoftObjectPtr<USoundWave>& SoundWave = GetSoundWave(AudioType);
+	if (!AudioComponent || SoundWave.IsNull())
 	{
 		return;
 	}
 
-	switch (AudioType)
+	// No phone has needed this sound yet, stream it in and play it once it's here
+	if (!SoundWave.IsValid())
 	{
-	case E_AudioType::Ringtone:
-		TargetPhone->PhoneAudioRingtoneComp->SetSound(RingtoneSoundWave);
-		TargetPhone->PhoneAudioRingtoneComp->Play();
-
-		//PlayWwiseEvent(AkRingtoneEvent, TargetPhone);
-		break;
+		// Worlds without a game instance, like automation test worlds, have no cache to stream from
+		const UGameInstance* GameInstance = GetGameInstance();
+		UPhoneAudioCacheSubsystem* PhoneAudioCache = GameInstance ? GameInstance->GetSubsystem<UPhoneAudioCacheSubsystem>() : nullptr;
+		if (!PhoneAudioCache)
+		{
+			return;
+		}
 
-	case E_AudioType::Left:
-		TargetPhone->PhoneAudioComponent->SetSound(LeftSoundWave);
-		TargetPhone->PhoneAudioComponent->Play();
+		PhoneAudioCache->RequestAssets({ SoundWave.ToSoftObjectPath() }, FStreamableDelegate::CreateWeakLambda(this, [this, AudioType]()
+		{
+			if (GetSoundWave(AudioType).IsValid())
+			{
+				PlayPhoneAudioLocal(AudioType);
+			}
+			else
+			{
+				UE_LOG(LogPlayerPhone, Warning, TEXT("Phone sound %s failed to load!"), *GetSoundWave(AudioType).ToString());
+			}
+		}));
+		return;
+	}
 
-		//PlayWwiseEvent(AkLeftEvent, TargetPhone);
-		break;
+	AudioComponent->SetSound(SoundWave.Get());
+	AudioComponent->Play();
+}
 
+const TSoftObjectPtr<USoundWave>& APlayerPhone::GetSoundWave(E_AudioType AudioType) const
+{
+	switch (AudioType)
+	{
+	case E_AudioType::Ringtone:
+		return RingtoneSoundWave;
+	case E_AudioType::Left:
+		return LeftSoundWave;
 	case E_AudioType::Right:
-		TargetPhone->PhoneAudioComponent->SetSound(RightSoundWave);
-		TargetPhone->PhoneAudioComponent->Play();
-
-		//PlayWwiseEvent(AkRightEvent, TargetPhone);
-		break;
-
+		return RightSoundWave;
 	case E_AudioType::Back:
-		TargetPhone->PhoneAudioComponent->SetSound(BackSoundWave);
-		TargetPhone->PhoneAudioComponent->Play();
-
-		//PlayWwiseEvent(AkBackEvent, TargetPhone);
-		break;
-
+		return BackSoundWave;
 	case E_AudioType::Confirm:
-		TargetPhone->PhoneAudioComponent->SetSound(ConfirmSoundWave);
-		TargetPhone->PhoneAudioComponent->Play();
-
-		//PlayWwiseEvent(AkConfirmEvent, TargetPhone);
-		break;
-
+		return ConfirmSoundWave;
 	case E_AudioType::Open:
-		TargetPhone->PhoneAudioComponent->SetSound(OpenPhoneSoundWave);
-		TargetPhone->PhoneAudioComponent->Play();
+		return OpenPhoneSoundWave;
+	case E_AudioType::Close:
+	default:
+		return ClosePhoneSoundWave;
+	}
+}
 
-		//PlayWwiseEvent(AkOpenPhoneEvent, TargetPhone);
-		break;
+void APlayerPhone::GetPhoneAudioAssets(TArray<FSoftObjectPath>& OutAssets) const
+{
+	OutAssets.Append({
+		RingtoneSoundWave.ToSoftObjectPath(), LeftSoundWave.ToSoftObjectPath(), RightSoundWave.ToSoftObjectPath(),
+		BackSoundWave.ToSoftObjectPath(), ConfirmSoundWave.ToSoftObjectPath(), OpenPhoneSoundWave.ToSoftObjectPath(),
+		ClosePhoneSoundWave.ToSoftObjectPath(),
+		AkRingtoneEvent.ToSoftObjectPath(), AkLeftEvent.ToSoftObjectPath(), AkRightEvent.ToSoftObjectPath(),
+		AkBackEvent.ToSoftObjectPath(), AkConfirmEvent.ToSoftObjectPath(), AkOpenPhoneEvent.ToSoftObjectPath(),
+		AkClosePhoneEvent.ToSoftObjectPath()
+	});
+}
 
-	case E_AudioType::Close:
-		TargetPhone->PhoneAudioComponent->SetSound(ClosePhoneSoundWave);
-		TargetPhone->PhoneAudioComponent->Play();
+void APlayerPhone::RequestPhoneAudio()
+{
+	if (bRequestedPhoneAudio || IsNetMode(NM_DedicatedServer))
+	{
+		return;
+	}
 
-		//PlayWwiseEvent(AkClosePhoneEvent, TargetPhone);
-		break;
+	const UGameInstance* GameInstance = GetGameInstance();
+	if (UPhoneAudioCacheSubsystem* PhoneAudioCache = GameInstance ? GameInstance->GetSubsystem<UPhoneAudioCacheSubsystem>() : nullptr)
+	{
+		TArray<FSoftObjectPath> PhoneAssets;
+		GetPhoneAudioAssets(PhoneAssets);
+		PhoneAudioCache->RequestAssets(PhoneAssets);
+		bRequestedPhoneAudio = true;
 	}
 }
 
+float APlayerPhone::GetPhoneUIAudioRange() const
+{
+	// Match how far the sound can actually be heard when the audio component has attenuation
+	if (PhoneAudioComponent)
+	{
+		if (const FSoundAttenuationSettings* AttenuationSettings = PhoneAudioComponent->GetAttenuationSettingsToApply())
+		{
+			return AttenuationSettings->GetMaxDimension();
+		}
+	}
+
+	return PhoneUIAudioRange;
+}
+
 void APlayerPhone::Server_StopPhoneAudio_Implementation(APlayerPhone* TargetPhone)
 {
-	if (!TargetPhone || !TargetPhone->PhoneAudioComponent || !TargetPhone->PhoneAudioRingtoneComp)
+	QU_COUNT_RPC(Server_StopPhoneAudio);
+	// Don't check the audio components here, dedicated servers don't have any
+	if (!TargetPhone)
 	{
 		return;
 	}
@@ -232,27 +437,45 @@ void APlayerPhone::Server_StopPhoneAudio_Implementation(APlayerPhone* TargetPhon
 
 void APlayerPhone::Multicast_StopPhoneAudio_Implementation(APlayerPhone* TargetPhone)
 {
-	if (!TargetPhone || !TargetPhone->PhoneAudioComponent || !TargetPhone->PhoneAudioRingtoneComp)
+	QU_COUNT_RPC(Multicast_StopPhoneAudio);
+	if (!TargetPhone)
 	{
 		return;
 	}
 
-	TargetPhone->PhoneAudioComponent->Stop();
-	TargetPhone->PhoneAudioRingtoneComp->Stop();
+	// Proxy phones don't have a ringtone component and dedicated servers have neither
+	if (TargetPhone->PhoneAudioComponent)
+	{
+		TargetPhone->PhoneAudioComponent->Stop();
+	}
+	if (TargetPhone->PhoneAudioRingtoneComp)
+	{
+		TargetPhone->PhoneAudioRingtoneComp->Stop();
+	}
 }
 
 void APlayerPhone::Server_CallPlayerByState_Implementation(APlayerState* TargetPlayerState, APlayerState* CallerPlayerState)
 {
+	QU_COUNT_RPC(Server_CallPlayerByState);
+	CSV_CUSTOM_STAT(Phone, CallRPCs, 1, ECsvCustomStatOp::Accumulate);
+
+	// Get both player's phones by their states
+	APlayerPhone* CallerPhone = GetPhoneFromPlayerState(CallerPlayerState);
+	APlayerPhone* TargetPhone = GetPhoneFromPlayerState(TargetPlayerState);
+	if (!CallerPhone || !TargetPhone)
+	{
+		UE_LOG(LogPlayerPhone, Error, TEXT("CallerPhone or TargetPhone is invalid!"));
+		return;
+	}
 
 	// Check to see if either player is currently in a call
-	if (GetPhoneFromPlayerState(TargetPlayerState)->bIsInCall || GetPhoneFromPlayerState(CallerPlayerState)->bIsInCall)
+	if (TargetPhone->GetIsInCall() || CallerPhone->GetIsInCall())
 	{
 		UE_LOG(LogPlayerPhone, Error, TEXT("One or both of the call players are currently in a call."));
-		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red,
+		QU_DEBUG_MESSAGE(2.0f, FColor::Red,
 			TEXT("One or both of the call players are currently in a call."));
 
-		// Post a delegate here for OnBusyLine() or something equivalent
-
+		CallerPhone->NotifyLineBusy(E_PhoneLineBusyReason::InCall);
 		return;
 	}
 
@@ -272,6 +495,14 @@ void APlayerPhone::Server_CallPlayerByState_Implementation(APlayerState* TargetP
 		return;
 	}
 
+	// Get the PhoneChannelSubsystem
+	UPhoneChannelSubsystem* PhoneChannels = World->GetSubsystem<UPhoneChannelSubsystem>();
+	if (!PhoneChannels)
+	{
+		UE_LOG(LogPlayerPhone, Error, TEXT("PhoneChannelSubsystem is NULL!"));
+		return;
+	}
+
 	// Get the caller's VOIPTalker
 	UOnsetVoipTalker* CallerPlayerTalker = OnsetVoipWorldSubsystem->GetVoipTalker(CallerPlayerState);
 	if (!CallerPlayerTalker)
@@ -280,194 +511,70 @@ void APlayerPhone::Server_CallPlayerByState_Implementation(APlayerState* TargetP
 		return;
 	}
 
-	// First check if Channel 1 is free
-	const TArray<UOnsetVoipTalker*> TalkersInChannel1 = OnsetVoipWorldSubsystem->GetAllTalkersInVoiceChannel(1);
-	if (TalkersInChannel1.Num() == 0)
+	// Take a free phone channel for both players
+	const int32 ChannelID = PhoneChannels->AllocateChannel(CallerPhone, TargetPhone);
+	if (ChannelID == INDEX_NONE)
 	{
-		// It's free, so join it and ask the receiver to join it too
-		CallerPlayerTalker->SetVoiceChannel(1, true);
-		UE_LOG(LogPlayerPhone, Log, TEXT("A player caller joined Phone Channel 1."));
-		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green,
-			TEXT("A player caller joined Phone Channel 1!"));
+		// Every Phone Channel is taken, wait for one to be free
+		QU_DEBUG_MESSAGE(1.0f, FColor::Red,
+			TEXT("Every Phone Channel is taken! Wait for one to be free."));
 
-		// Notify the receiving player and the calling player
-		Server_NotifyClientsAboutCallByState(TargetPlayerState, CallerPlayerState, 1);
+		CallerPhone->NotifyLineBusy(E_PhoneLineBusyReason::NoFreeChannel);
 		return;
 	}
 
-	// It's not free, check Channel 2
-	const TArray<UOnsetVoipTalker*> TalkersInChannel2 = OnsetVoipWorldSubsystem->GetAllTalkersInVoiceChannel(2);
-	if (TalkersInChannel2.Num() == 0)
-	{
-		// It's free, so join it and ask the receiver to join it too
-		CallerPlayerTalker->SetVoiceChannel(2, true);
-		UE_LOG(LogPlayerPhone, Log, TEXT("Caller joined Phone Channel 2."));
-		GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Green,
-			TEXT("Joined Phone Channel 2!"));
+	// Join it, the receiver joins too once they pick up
+	CallerPlayerTalker->SetVoiceChannel(ChannelID, true);
+	UE_LOG(LogPlayerPhone, Log, TEXT("A player caller joined Phone Channel %d."), ChannelID);
+	QU_DEBUG_MESSAGE(2.0f, FColor::Green,
+		FString::Printf(TEXT("A player caller joined Phone Channel %d!"), ChannelID));
 
-		// Notify the receiving player and the calling player
-		Server_NotifyClientsAboutCallByState(TargetPlayerState, CallerPlayerState, 2);
-		return;
-	}
+	// The caller is dialing and the receiver's phone is ringing,
+	// each owning client finds out through its phone's replicated call state
+	CallerPhone->SetCallState(E_CallPhase::Dialing, ChannelID, TargetPlayerState);
+	TargetPhone->SetCallState(E_CallPhase::Ringing, ChannelID, CallerPlayerState);
 
-	// Both Phone Channels are taken, wait for one to be free
-	UE_LOG(LogPlayerPhone, Warning, TEXT("Both Phone Channels are taken! Wait for one to be free."));
+	// Play the ringtone through the server at the receiving phone's location
+	CSV_CUSTOM_STAT(Phone, CallRPCs, 1, ECsvCustomStatOp::Accumulate);
+	Multicast_PlayPhoneAudio(TargetPhone, E_AudioType::Ringtone);
 
-	GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red,
-		TEXT("Both Phone Channels are taken! Wait for one to be free."));
+	// Automatically end the call if the receiver doesn't answer in time
+	TargetPhone->GetWorldTimerManager().SetTimer(TargetPhone->PhoneCallTimeoutHandle, TargetPhone,
+		&APlayerPhone::PendingCallTimeout, TargetPhone->CallTimeoutTime, false);
 }
 
 void APlayerPhone::Server_LeaveCurrentPhoneChannel_Implementation(APlayerState* PlayerToChange)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red,
-		TEXT("Server_LeaveCurrentPhoneChannel_Implementation."));
-
-	if (bIsLeavingCall)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("Already leaving call!"));
-		return;
-	}
-
-	// set our flag to true to avoid recursion
-	bIsLeavingCall = true;
-
-	// Get the current world ref
-	const UWorld* const World = GEngine->GetWorldFromContextObject(GetWorld(), EGetWorldErrorMode::LogAndReturnNull);
-	if (!IsValid(World))
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("Invalid World from Server_LeaveCurrentPhoneChannel!"));
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red,
-			TEXT("Invalid World from Server_LeaveCurrentPhoneChannel!"));
-		bIsLeavingCall = false;  // Reset flag before exiting
-		return;
-	}
-
-	// Get the OnsetVoipWorldSubsystem
-	const UOnsetVoipWorldSubsystem* OnsetVoipWorldSubsystem = World->GetSubsystem<UOnsetVoipWorldSubsystem>();
-	if (!OnsetVoipWorldSubsystem)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("OnsetVoipWorldSubsystem is NULL!"));
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red,
-			TEXT("OnsetVoipWorldSubsystem is NULL!"));
-		bIsLeavingCall = false;  // Reset flag before exiting
-		return;
-	}
-
-	// Get the player's VOIPTalker
-	UOnsetVoipTalker* PlayerTalker = OnsetVoipWorldSubsystem->GetVoipTalker(PlayerToChange);
-	if (!PlayerTalker)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("PlayerTalker is NULL!"));
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("PlayerTalker is NULL!"));
-		bIsLeavingCall = false;  // Reset flag before exiting
-		return;
-	}
+	QU_COUNT_RPC(Server_LeaveCurrentPhoneChannel);
+	CSV_CUSTOM_STAT(Phone, CallRPCs, 1, ECsvCustomStatOp::Accumulate);
 
 	// Get Player Phone
 	APlayerPhone* PlayerPhone = GetPhoneFromPlayerState(PlayerToChange);
 	if (!PlayerPhone)
 	{
 		UE_LOG(LogPlayerPhone, Error, TEXT("PlayerPhone is NULL!"));
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("PlayerPhone is NULL!"));
-		bIsLeavingCall = false;  // Reset flag before exiting
 		return;
 	}
 
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Yellow,
-		FString::Printf(TEXT("Current Channel: %d"), PlayerPhone->GetCurrentChannel()));
-
-	// Just in case the ringtone is playing, stop playing any sounds on this phone
-	Multicast_StopPhoneAudio(PlayerPhone);
-
-	// Check the Player's current channel
-	if (PlayerPhone->GetCurrentChannel() != -1)
-	{
-		// Leave the current channel
-		PlayerTalker->SetVoiceChannel(PlayerPhone->GetCurrentChannel(), false);
-
-		// Notify any subscribers that this player left the call,
-		// must be done through the server because it's technically a multicast I believe
-		if (PlayerPhone->OnEndCall.IsBound())
-		{
-			GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("Executing OnEndCall delegate"));
-
-			PlayerPhone->OnEndCall.Broadcast(PlayerToChange);
-
-			// Unbind the delegate to prevent further executions
-			PlayerPhone->OnEndCall.Clear();
-		}
-
-		// Extra precaution, remove this talker from all phone channels
-		PlayerTalker->SetVoiceChannel(1, false);
-		PlayerTalker->SetVoiceChannel(2, false);
-
-		// Reset the current channel tracker
-		PlayerPhone->SetCurrentChannel(-1);
-
-		// Set the replicated flag for bIsInCall to false for this phone
-		PlayerPhone->bIsInCall = false;
-
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red,
-			TEXT("Someone left their current call."));
-	}
-	else
+	if (!PlayerPhone->GetIsInCall())
 	{
-		UE_LOG(LogPlayerPhone, Log, TEXT("Trying to leave a channel when we arent in one currently!"));
+		UE_LOG(LogPlayerPhone, Log, TEXT("Trying to leave a call when we arent in one currently!"));
+		return;
 	}
 
-	// Broadcast the Blueprintable OnCallEnded Event through the owning client's machine
-	Client_BroadcastOnCallEnded();
+	// Either player leaving ends the call for both of them, so hang up the other phone too
+	// as long as it's still in this call with us
+	APlayerPhone* OtherPhone = GetPhoneFromPlayerState(PlayerPhone->CallState.OtherPlayerState);
 
+	PlayerPhone->HangUp();
 
-	// Reset flag before exiting
-	bIsLeavingCall = false;
-}
-
-void APlayerPhone::Server_SetIsInCall_Implementation(const bool newVal, APlayerPhone* phoneToModify)
-{
-	phoneToModify->bIsInCall = newVal;
-}
-
-void APlayerPhone::Client_BindOnEndCall_Implementation(APlayerPhone* OtherPlayerPhone)
-{
-	// THIS is a phone that is in a call with another phone.
-	// We are binding THIS OnEndCall delegate to THE OTHER phone's OnOtherPlayerEndCall().
-	// So when THIS phone broadcasts OnEndCall, THE OTHER phone will run OnOtherPlayerEndCall()
-	// and pass in the PlayerState that owns THIS phone.
-	if (OtherPlayerPhone)
+	if (OtherPhone && OtherPhone->CallState.OtherPlayerState == PlayerToChange)
 	{
-		OnEndCall.AddUniqueDynamic(OtherPlayerPhone, &APlayerPhone::OnOtherPlayerEndCall);
+		OtherPhone->HangUp();
 	}
-}
 
-void APlayerPhone::Client_UnbindOnEndCall_Implementation(APlayerPhone* OtherPlayerPhone)
-{
-	// Same description as Client_BindOnEndCall but instead we are unbinding
-	if (OtherPlayerPhone)
-	{
-		OnEndCall.RemoveDynamic(OtherPlayerPhone, &APlayerPhone::OnOtherPlayerEndCall);
-	}
-}
-
-void APlayerPhone::Client_BroadcastOnCallEnded_Implementation()
-{
-	if (BPOnEndCall.IsBound())
-	{
-		BPOnEndCall.Broadcast();
-	}
-}
-
-void APlayerPhone::Client_BroadcastOnEndCall_Implementation(APlayerState* OtherPlayerState)
-{
-	if (OnEndCall.IsBound())
-	{
-		GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Red, TEXT("Executing OnEndCall delegate"));
-
-		OnEndCall.Broadcast(OtherPlayerState);
-
-		// Unbind the delegate to prevent further executions
-		OnEndCall.Clear();
-	}
+	QU_DEBUG_MESSAGE(1.0f, FColor::Red,
+		TEXT("Someone left their current call."));
 }
 
 void APlayerPhone::AcceptCall()
@@ -475,37 +582,48 @@ void APlayerPhone::AcceptCall()
 	UE_LOG(LogPlayerPhone, Log, TEXT("Accepting received call"));
 
 	// Only work if we are being called currently
-	if (PhoneCallTimeoutHandle.IsValid())
+	if (CallState.Phase == E_CallPhase::Ringing)
 	{
-		// Clear the existing timer
-		GetWorldTimerManager().ClearTimer(PhoneCallTimeoutHandle);
-
-		// Tell the server that we accepted the call, pass in our player state
-		// and current channel
-		Server_AcceptCall(mOwningCharacter->GetPlayerState(), mCurrentChannel);
+		// Tell the server that we accepted the call
+		Server_AcceptCall();
 	}
 }
 
-void APlayerPhone::Server_AcceptCall_Implementation(APlayerState* ReceivingPlayerState, uint32 ChannelID)
+void APlayerPhone::Server_AcceptCall_Implementation()
 {
-	// Player now in a call
-	Server_SetIsInCall_Implementation(true, this);
+	QU_COUNT_RPC(Server_AcceptCall);
+	CSV_CUSTOM_STAT(Phone, CallRPCs, 1, ECsvCustomStatOp::Accumulate);
+
+	// The call might have timed out or been hung up while this was on its way
+	if (CallState.Phase != E_CallPhase::Ringing)
+	{
+		return;
+	}
 
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Yellow, TEXT("Accepting a phone call."));
+	QU_DEBUG_MESSAGE(2.0f, FColor::Yellow, TEXT("Accepting a phone call."));
 	UE_LOG(LogPlayerPhone, Log, TEXT("Accepting a phone call."));
 
-	// Stop playing our ringtone if we are playing it
-	APlayerPhone* PlayerPhone = GetPhoneFromPlayerState(ReceivingPlayerState);
-	if (PlayerPhone->PhoneAudioComponent->IsPlaying())
+	// The caller has to still be waiting on us
+	APlayerPhone* CallerPhone = GetPhoneFromPlayerState(CallState.OtherPlayerState);
+	if (!CallerPhone || CallerPhone->CallState.Phase != E_CallPhase::Dialing)
 	{
-		Server_StopPhoneAudio(PlayerPhone);
+		UE_LOG(LogPlayerPhone, Log, TEXT("Caller left the call early!"));
+		HangUp();
+		return;
 	}
 
+	// Nobody needs to time this call out anymore
+	GetWorldTimerManager().ClearTimer(PhoneCallTimeoutHandle);
+
+	// Stop playing our ringtone
+	CSV_CUSTOM_STAT(Phone, CallRPCs, 1, ECsvCustomStatOp::Accumulate);
+	Multicast_StopPhoneAudio(this);
+
 	// Get the current world ref
 	const UWorld* const World = GEngine->GetWorldFromContextObject(GetWorld(), EGetWorldErrorMode::LogAndReturnNull);
 	if (!IsValid(World))
 	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("Invalid World from ReceivePhoneCall!"));
+		UE_LOG(LogPlayerPhone, Error, TEXT("Invalid World from Server_AcceptCall!"));
 		return;
 	}
 
@@ -518,7 +636,7 @@ void APlayerPhone::Server_AcceptCall_Implementation(APlayerState* ReceivingPlaye
 	}
 
 	// Get the receiving player's VOIPTalker
-	UOnsetVoipTalker* ReceivingPlayerTalker = OnsetVoipWorldSubsystem->GetVoipTalker(ReceivingPlayerState);
+	UOnsetVoipTalker* ReceivingPlayerTalker = OnsetVoipWorldSubsystem->GetVoipTalker(GetOwningPlayerState());
 	if (!ReceivingPlayerTalker)
 	{
 		UE_LOG(LogPlayerPhone, Error, TEXT("ReceivingPlayerTalker is NULL!"));
@@ -526,17 +644,26 @@ void APlayerPhone::Server_AcceptCall_Implementation(APlayerState* ReceivingPlaye
 	}
 
 	// Officially join the channel
-	ReceivingPlayerTalker->SetVoiceChannel(ChannelID, true);
+	ReceivingPlayerTalker->SetVoiceChannel(CallState.Channel, true);
+
+	// Both players are connected
+	SetCallState(E_CallPhase::Connected, CallState.Channel, CallState.OtherPlayerState);
+	CallerPhone->SetCallState(E_CallPhase::Connected, CallerPhone->CallState.Channel, CallerPhone->CallState.OtherPlayerState);
 
 	UE_LOG(LogPlayerPhone, Log, TEXT("Phone call successfully received and joined!"));
-	GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Green, TEXT("Phone call successfully received and joined!"));
+	QU_DEBUG_MESSAGE(1.0f, FColor::Green, TEXT("Phone call successfully received and joined!"));
 }
 
 void APlayerPhone::PhoneSkeleSetHidden(bool bHide) const
 {
-	if (PhoneSkele && PhoneScreenWidgetPopUp && PhoneScreenLight)
+	if (PhoneSkele)
 	{
 		PhoneSkele->SetHiddenInGame(bHide);
+	}
+
+	// Proxy phones don't have a screen
+	if (PhoneScreenWidgetPopUp && PhoneScreenLight && PhoneScreenPLight)
+	{
 		PhoneScreenWidgetPopUp->SetVisibility(!bHide);
 		PhoneScreenLight->SetVisibility(!bHide);
 		PhoneScreenPLight->SetVisibility(!bHide);
@@ -554,142 +681,136 @@ APlayerPhone* APlayerPhone::GetPhoneFromPlayerState(APlayerState* PlayerState)
 	return QUPS->GetPlayerPhone();
 }
 
-void APlayerPhone::OnOtherPlayerEndCall(APlayerState* OtherPlayerState)
+void APlayerPhone::EndCall(APlayerState* PlayerEndingCall)
 {
-	if (HasAuthority())
+	UE_LOG(LogPlayerPhone, Log, TEXT("Ending current call"));
+	QU_DEBUG_MESSAGE(2.0f, FColor::Red,
+		TEXT("Ending current call"));
+
+	// Leave the current call, the server hangs up both phones
+	Server_LeaveCurrentPhoneChannel(PlayerEndingCall);
+}
+
+void APlayerPhone::PendingCallTimeout()
+{
+	APlayerState* OwningState = GetOwningPlayerState();
+	if (!OwningState)
 	{
-		// If this was called on the server but this phone isn't owned by the server player,
-		// then we tell the owner of this phone to react to the other player (probably server player)
-		// ending the call
-		Client_OnOtherPlayerEndCall(OtherPlayerState);
+		UE_LOG(LogPlayerPhone, Error, TEXT("mOwningCharacter->GetPlayerState() returned NULL!"));
+		return;
 	}
-	else
-	{
-		GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red,
-			TEXT("Other player ended call, disconnecting you from channel."));
 
-		// Get the world
-		const UWorld* World = GetWorld();
-		if (!World)
-		{
-			UE_LOG(LogPlayerPhone, Error, TEXT("World is NULL!"));
-			return;
-		}
+	// Automatically end the call, we're already on the server
+	Server_LeaveCurrentPhoneChannel_Implementation(OwningState);
+}
 
-		// Get our local player's state
-		APlayerState* LocalPlayerState = UGameplayStatics::GetPlayerState(World, 0);
-		if (!LocalPlayerState || !LocalPlayerState->GetPlayerController()->IsLocalController())
-		{
-			UE_LOG(LogPlayerPhone, Error, TEXT("LocalPlayerState is NULL or is not the local controller!"));
-			return;
-		}
+void APlayerPhone::SetCallState(const E_CallPhase NewPhase, const int32 NewChannel, APlayerState* NewOtherPlayerState)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
 
-		// Unbind OnEndCall to avoid recursion
-		if (OnEndCall.IsBound())
-		{
-			if (HasAuthority())
-			{
-				APlayerPhone* OtherPlayerPhone = GetPhoneFromPlayerState(OtherPlayerState);
+	const FCallState OldCallState = CallState;
 
-				// Client RPC called through the server will be ran on the OWNING CLIENT'S computer.
-				// In this case if we are the server player AND we own this phone, it will run on
-				// our computer which will technically still be on the sever
-				Client_UnbindOnEndCall(OtherPlayerPhone);
-			}
-			else
-			{
-				APlayerPhone* OtherPlayerPhone = GetPhoneFromPlayerState(OtherPlayerState);
+	CallState.Phase = NewPhase;
+	CallState.Channel = static_cast<int8>(NewChannel);
+	CallState.OtherPlayerState = NewOtherPlayerState;
 
-				// Client RPC called on a phone owned by THIS client will run on THIS client's computer
-				Client_UnbindOnEndCall(OtherPlayerPhone);
-			}
-		}
+	// Bump the version so every transition replicates, even one back to the same phase
+	CallState.Version++;
 
-		// We are no longer in a call
-		Server_SetIsInCall_Implementation(false, this);
+	CSV_CUSTOM_STAT(Phone, CallStateUpdates, 1, ECsvCustomStatOp::Accumulate);
 
-		// Get our local player to leave the channel
-		Server_LeaveCurrentPhoneChannel(LocalPlayerState);
+	// OnRep doesn't run on the server, so the listen server player's own phone reacts here
+	if (mOwningCharacter && mOwningCharacter->IsLocallyControlled())
+	{
+		OnRep_CallState(OldCallState);
 	}
 }
 
-void APlayerPhone::Client_OnOtherPlayerEndCall_Implementation(APlayerState* OtherPlayerState)
+void APlayerPhone::OnRep_CallState(const FCallState& OldCallState)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 5.0f, FColor::Red,
-		TEXT("Other player ended call, disconnecting you from channel."));
-
-	// Get our local player's state
-	APlayerState* LocalPlayerState = mOwningCharacter->GetPlayerState();
-	if (!LocalPlayerState || !LocalPlayerState->GetPlayerController()->IsLocalController())
+	if (CallState.Version == OldCallState.Version)
 	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("LocalPlayerState is NULL or is not the local controller!"));
 		return;
 	}
 
-	// Unbind OnEndCall to avoid recursion
-	if (OnEndCall.IsBound())
+	// Phases in between can get skipped if they changed faster than they replicated,
+	// so only react to the phase we ended up in
+	switch (CallState.Phase)
 	{
-		if (HasAuthority())
-		{
-			APlayerPhone* OtherPlayerPhone = GetPhoneFromPlayerState(OtherPlayerState);
+		case E_CallPhase::Dialing:
+			OnCallStarted.Broadcast(CallState.OtherPlayerState, CallState.Channel);
+			QU_DEBUG_MESSAGE(2.0f, FColor::Green, TEXT("Call started on the client!"));
+			break;
 
-			// Client RPC called through the server will be ran on the OWNING CLIENT'S computer.
-			// In this case if we are the server player AND we own this phone, it will run on
-			// our computer which will technically still be on the sever
-			Client_UnbindOnEndCall(OtherPlayerPhone);
-		}
-		else
-		{
-			APlayerPhone* OtherPlayerPhone = GetPhoneFromPlayerState(OtherPlayerState);
+		case E_CallPhase::Ringing:
+			OnCallReceived.Broadcast(CallState.OtherPlayerState, CallState.Channel);
+			QU_DEBUG_MESSAGE(2.0f, FColor::Green, TEXT("Call received on the client!"));
+			break;
 
-			// Client RPC called on a phone owned by THIS client will run on THIS client's computer
-			Client_UnbindOnEndCall(OtherPlayerPhone);
-		}
-	}
+		case E_CallPhase::Connected:
+			OnCallConnected.Broadcast();
+			break;
 
-	// We are no longer in a call
-	Server_SetIsInCall_Implementation(false, this);
+		case E_CallPhase::Ending:
+			BPOnEndCall.Broadcast();
+			break;
 
-	// Get our local player to leave the channel
-	Server_LeaveCurrentPhoneChannel(LocalPlayerState);
+		case E_CallPhase::Idle:
+		default:
+			break;
+	}
 }
 
-void APlayerPhone::EndCall(APlayerState* PlayerEndingCall)
+void APlayerPhone::HangUp()
 {
-	UE_LOG(LogPlayerPhone, Log, TEXT("Ending current call"));
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Red,
-		TEXT("Ending current call"));
+	if (!HasAuthority() || !GetIsInCall())
+	{
+		return;
+	}
 
-	// No longer in a call
-	Server_SetIsInCall(false, this);
+	// No more timing out a call that's over
+	GetWorldTimerManager().ClearTimer(PhoneCallTimeoutHandle);
 
-	// Leave the current phone channel
-	Server_LeaveCurrentPhoneChannel(PlayerEndingCall);
-}
+	// Stop the ringtone if nobody picked up
+	if (CallState.Phase == E_CallPhase::Ringing)
+	{
+		CSV_CUSTOM_STAT(Phone, CallRPCs, 1, ECsvCustomStatOp::Accumulate);
+		Multicast_StopPhoneAudio(this);
+	}
 
-void APlayerPhone::PendingCallTimeout()
-{
-	APlayerState* OwningState = mOwningCharacter->GetPlayerState();
-	if (!OwningState)
+	if (const UWorld* World = GetWorld())
 	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("mOwningCharacter->GetPlayerState() returned NULL!"));
-		return;
+		// Leave the voice channel, the receiver only ever joined it if they picked up
+		const UOnsetVoipWorldSubsystem* OnsetVoipWorldSubsystem = World->GetSubsystem<UOnsetVoipWorldSubsystem>();
+		UOnsetVoipTalker* PlayerTalker = OnsetVoipWorldSubsystem ? OnsetVoipWorldSubsystem->GetVoipTalker(GetOwningPlayerState()) : nullptr;
+		if (PlayerTalker && CallState.Channel != INDEX_NONE)
+		{
+			PlayerTalker->SetVoiceChannel(CallState.Channel, false);
+		}
+
+		// Give the channel back once both players have left it
+		if (UPhoneChannelSubsystem* PhoneChannels = World->GetSubsystem<UPhoneChannelSubsystem>())
+		{
+			PhoneChannels->ReleasePhone(this);
+		}
 	}
 
-	// Automatically end the call
-	EndCall(OwningState);
+	SetCallState(E_CallPhase::Ending, INDEX_NONE, nullptr);
 }
 
-void APlayerPhone::SetCurrentChannel(const int NewChannel)
+APlayerState* APlayerPhone::GetOwningPlayerState() const
 {
-	if (HasAuthority())
-	{
-		mCurrentChannel = NewChannel;
-	}
+	return mOwningCharacter ? mOwningCharacter->GetPlayerState() : nullptr;
 }
 
 void APlayerPhone::PullUpPhone()
 {
+	// First time the phone comes out, start streaming in its audio so it's ready for the menu
+	RequestPhoneAudio();
+
 	UAnimInstance* AnimInstance = PhoneSkele->GetAnimInstance();
 	if (AnimInstance && PullPhoneUpMontage)
 	{
@@ -715,7 +836,7 @@ void APlayerPhone::PullUpPhone()
 		AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, PullPhoneUpMontage);
 
 		// Play Open phone audio
-		Server_PlayPhoneAudio(this, E_AudioType::Open);
+		PlayPhoneUISound(E_AudioType::Open);
 	}
 }
 
@@ -751,7 +872,7 @@ void APlayerPhone::NavLeft()
 {
 	if (mPlayerPhoneWidget)
 	{
-		Server_PlayPhoneAudio(this, E_AudioType::Left);
+		PlayPhoneUISound(E_AudioType::Left);
 		mPlayerPhoneWidget->NavigateLeft();
 	}
 }
@@ -760,7 +881,7 @@ void APlayerPhone::NavRight()
 {
 	if (mPlayerPhoneWidget)
 	{
-		Server_PlayPhoneAudio(this, E_AudioType::Right);
+		PlayPhoneUISound(E_AudioType::Right);
 		mPlayerPhoneWidget->NavigateRight();
 	}
 }
@@ -769,7 +890,7 @@ void APlayerPhone::NavConfirm()
 {
 	if (mPlayerPhoneWidget)
 	{
-		Server_PlayPhoneAudio(this, E_AudioType::Confirm);
+		PlayPhoneUISound(E_AudioType::Confirm);
 		mPlayerPhoneWidget->ConfirmSelection();
 	}
 }
@@ -778,7 +899,7 @@ void APlayerPhone::NavBack()
 {
 	if (mPlayerPhoneWidget)
 	{
-		Server_PlayPhoneAudio(this, E_AudioType::Back);
+		PlayPhoneUISound(E_AudioType::Back);
 		mPlayerPhoneWidget->GoBack();
 	}
 }
@@ -825,9 +946,12 @@ void APlayerPhone::PutDownPhone()
 		}
 
 		// Hide the screen widget and lights
-		PhoneScreenWidgetPopUp->SetVisibility(false);
-		PhoneScreenLight->SetVisibility(false);
-		PhoneScreenPLight->SetVisibility(false);
+		if (PhoneScreenWidgetPopUp && PhoneScreenLight && PhoneScreenPLight)
+		{
+			PhoneScreenWidgetPopUp->SetVisibility(false);
+			PhoneScreenLight->SetVisibility(false);
+			PhoneScreenPLight->SetVisibility(false);
+		}
 
 		// Play the phone put-down montage
 		AnimInstance->Montage_Play(PutPhoneDownMontage);
@@ -842,124 +966,15 @@ void APlayerPhone::PutDownPhone()
 		AnimInstance->Montage_SetEndDelegate(MontageEndedDelegate, PutPhoneDownMontage);
 
 		// Play Close phone audio
-		Server_PlayPhoneAudio(this, E_AudioType::Close);
-	}
-}
-
-void APlayerPhone::Server_NotifyClientsAboutCallByState_Implementation(APlayerState* ReceivingPlayerState,
-	APlayerState* CallerPlayerState, int32 ChannelID)
-{
-	// Get both player's phone by their states
-	APlayerPhone* CallerPhone = GetPhoneFromPlayerState(CallerPlayerState);
-	if (!CallerPhone)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("CallerPhone is invalid!"));
-		return;
-	}
-
-	APlayerPhone* ReceiverPhone = GetPhoneFromPlayerState(ReceivingPlayerState);
-	if (!ReceiverPhone)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("ReceiverPhone is invalid!"));
-		return;
-	}
-
-	// Set the replicated flag bIsInCall to true for the caller's phone
-	CallerPhone->bIsInCall = true;
-
-	// Set the target player's phone flag bIsInCall to true
-	ReceiverPhone->bIsInCall = true;
-
-	// Set mCurrentChannel on the caller client's phone through the server
-	CallerPhone->SetCurrentChannel(ChannelID);
-	// Set mCurrentChannel on the receiver client's phone through the server
-	ReceiverPhone->SetCurrentChannel(ChannelID);
-
-	// Subscribe the receiver's phone to the Caller's phone to listen
-	// for when the caller ends the call, must do here on the server (I believe it's because
-	// it's technically a multicast
-	CallerPhone->OnEndCall.AddUniqueDynamic(ReceiverPhone, &APlayerPhone::OnOtherPlayerEndCall);
-
-	// Subscribe the Caller's phone to the Receiver's phone to listen
-	// for when the receiver ends the call, must do here on the server (I believe it's because
-	// it's technically a multicast
-	ReceiverPhone->OnEndCall.AddUniqueDynamic(CallerPhone, &APlayerPhone::OnOtherPlayerEndCall);
-
-	// Play the ringtone through the server at the receiving phone's location
-	Multicast_PlayPhoneAudio(ReceiverPhone, E_AudioType::Ringtone);
-
-	Multicast_CallReceivingPlayerByState(ReceivingPlayerState, CallerPlayerState, CallerPhone, ReceiverPhone, ChannelID);
-}
-
-void APlayerPhone::Multicast_CallReceivingPlayerByState_Implementation(APlayerState* ReceivingPlayerState,
-	APlayerState* CallerPlayerState, APlayerPhone* CallerPhone, APlayerPhone* ReceiverPhone, int32 ChannelID)
-{
-	GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Yellow, FString::Printf(
-		TEXT("Someone is asking another player to join their call.")));
-
-	if (!ReceivingPlayerState || !CallerPlayerState || (ChannelID == 0))
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("Passed in info in Multicast_CallReceivingPlayerByState_Implementation is invalid!"));
-		return;
-	}
-
-	const UWorld* World = GetWorld();
-	if (!World)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("World is NULL!"));
-		return;
-	}
-
-	// Get the local player controller so we can get the local player state
-	const APlayerController* LocalPlayerController = UGameplayStatics::GetPlayerController(World, 0);
-	if (!LocalPlayerController)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("LocalPlayerController is NULL!"));
-		return;
-	}
-
-	// Get the local player state through the controller since this is a listen server,
-	// getting world player idx 0's player state ALWAYS returns the server player's PlayerState
-	APlayerState* LocalPlayerState = LocalPlayerController->GetPlayerState<APlayerState>();
-	if (!LocalPlayerState)
-	{
-		UE_LOG(LogPlayerPhone, Error, TEXT("LocalPlayerState is NULL!"));
-		return;
-	}
-
-	// Check to see if the local player state is the one being called
-	if (LocalPlayerState == ReceivingPlayerState)
-	{
-		// It is
-		GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Green, FString::Printf(TEXT("YOU ARE THE RECEIVER!")));
-
-		// Notify the receiving player that they are being called and send in the calling player's info
-		// Start the call timeout timer
-		ReceiverPhone->Client_NotifyCallReceived(CallerPlayerState, CallerPhone, ChannelID);
-
-		// Call the local player and send in the caller ID
-		// Server side logic for joining the call (auto joins call if placed here)
-		//ReceiverPhone->Server_ReceivePhoneCall(LocalPlayerState, CallerPlayerState, ChannelID);
-	}
-	// Check to see if the local player is the caller
-	else if (LocalPlayerState == CallerPlayerState)
-	{
-		// It is
-		GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Green, FString::Printf(TEXT("YOU ARE THE CALLER!")));
-
-		// Notify the calling player that they started a call and send in the other player's info 
-		CallerPhone->Client_NotifyCallStarted(ReceivingPlayerState, ChannelID);
-	}
-	else
-	{
-		GEngine->AddOnScreenDebugMessage(-1, 3.0f, FColor::Red, FString::Printf(TEXT("It's not you.")));
+		PlayPhoneUISound(E_AudioType::Close);
 	}
 }
 
 // CURRENTLY NOT IN USE, ONLY USED WHEN WE WANT PLAYERS TO AUTOMATICALLY ACCEPT CALLS
 void APlayerPhone::Server_ReceivePhoneCall_Implementation(APlayerState* ReceivingPlayerState, APlayerState* CallerPlayerState, int32 ChannelID)
 {
-	GEngine->AddOnScreenDebugMessage(-1, 2.0f, FColor::Yellow, TEXT("Receiving a phone call."));
+	QU_COUNT_RPC(Server_ReceivePhoneCall);
+	QU_DEBUG_MESSAGE(2.0f, FColor::Yellow, TEXT("Receiving a phone call."));
 	UE_LOG(LogPlayerPhone, Log, TEXT("Phone call received from player"));
 
 	// Check if the passed params are valid
@@ -1022,5 +1037,5 @@ void APlayerPhone::Server_ReceivePhoneCall_Implementation(APlayerState* Receivin
 	}
 
 	UE_LOG(LogPlayerPhone, Log, TEXT("Phone call successfully received and joined!"));
-	GEngine->AddOnScreenDebugMessage(-1, 1.0f, FColor::Green, TEXT("Phone call successfully received and joined!"));
+	QU_DEBUG_MESSAGE(1.0f, FColor::Green, TEXT("Phone call successfully received and joined!"));
 }
\ No newline at end of file
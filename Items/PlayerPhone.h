@@ -7,6 +7,7 @@
 #include "Components/RectLightComponent.h"
 #include "GameFramework/Actor.h"
 #include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
+#include "NetworkingPrototype/Managers/PhoneChannelSubsystem.h"
 #include "NetworkingPrototype/Widgets/PlayerPhoneWidget.h"
 #include "AkAudioEvent.h"
 
@@ -18,8 +19,9 @@ DECLARE_LOG_CATEGORY_EXTERN(LogPlayerPhone, Log, All);
 // Delegate declarations
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FCallStartedDelegate, APlayerState*, ReceivingPlayerState, int, ChannelID);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FCallReceivedDelegate, APlayerState*, CallerPlayerState, int, ChannelID);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FCallConnectedDelegate);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE(FBPEndCallDelegate);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FEndCallDelegate, APlayerState*, PlayerState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FLineBusyDelegate, E_PhoneLineBusyReason, Reason);
 
 UENUM(BlueprintType)
 enum class E_AudioType : uint8
@@ -33,6 +35,45 @@ enum class E_AudioType : uint8
 	Close  UMETA(DisplayName = "Close"),
 };
 
+// Where a phone is in a call
+UENUM(BlueprintType)
+enum class E_CallPhase : uint8
+{
+	// Never been in a call
+	Idle UMETA(DisplayName = "Idle"),
+	// Calling another player and waiting for them to pick up
+	Dialing UMETA(DisplayName = "Dialing"),
+	// Another player is calling us
+	Ringing UMETA(DisplayName = "Ringing"),
+	// Both players are talking
+	Connected UMETA(DisplayName = "Connected"),
+	// The last call ended and the line is free, stays here until the next call
+	Ending UMETA(DisplayName = "Ending")
+};
+
+// Everything the owning client needs to know about its phone's call, replicated as one property
+// so starting, answering or ending a call is a single update instead of a string of RPCs
+USTRUCT()
+struct FCallState
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	E_CallPhase Phase = E_CallPhase::Idle;
+
+	// Bumped on every change, so a call ending and a new one starting in the same phase still replicates
+	UPROPERTY()
+	uint8 Version = 0;
+
+	// Voice channel the call is in, -1 when not in a call
+	UPROPERTY()
+	int8 Channel = INDEX_NONE;
+
+	// The player on the other end of the call
+	UPROPERTY()
+	APlayerState* OtherPlayerState = nullptr;
+};
+
 UCLASS()
 class NETWORKINGPROTOTYPE_API APlayerPhone final : public AActor
 {
@@ -42,11 +83,11 @@ class NETWORKINGPROTOTYPE_API APlayerPhone final : public AActor
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Mesh, meta = (AllowPrivateAccess = "true"))
 	USkeletalMeshComponent* PhoneSkele;
 
-	/** Audio Component for phone sounds */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Audio, Replicated, meta = (AllowPrivateAccess = "true"))
+	/** Audio Component for phone sounds, null on dedicated servers */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Audio, meta = (AllowPrivateAccess = "true"))
 	UAudioComponent* PhoneAudioComponent;
-	/** Audio Component for phone ringtone */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Audio, Replicated, meta = (AllowPrivateAccess = "true"))
+	/** Audio Component for phone ringtone, null on dedicated servers */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Audio, meta = (AllowPrivateAccess = "true"))
 	UAudioComponent* PhoneAudioRingtoneComp;
 
 public:
@@ -56,14 +97,20 @@ public:
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
 
-	// Getter for bIsInCall
-	bool GetIsInCall() const { return bIsInCall; }
+	// Is this phone dialing, ringing or talking
+	bool GetIsInCall() const
+	{
+		return CallState.Phase == E_CallPhase::Dialing || CallState.Phase == E_CallPhase::Ringing
+			|| CallState.Phase == E_CallPhase::Connected;
+	}
+
+	// Where this phone is in a call
+	UFUNCTION(BlueprintCallable)
+	E_CallPhase GetCallPhase() const { return CallState.Phase; }
 
-	// Getter for mCurrentChannel
+	// Getter for the current call's channel, -1 when not in a call
 	UFUNCTION(BlueprintCallable)
-	int GetCurrentChannel() const { return mCurrentChannel; }
-	// Setter for mCurrentChannel
-	void SetCurrentChannel(const int NewChannel);
+	int GetCurrentChannel() const { return CallState.Channel; }
 
 	/* Phone anim functions */
 	UFUNCTION()
@@ -85,21 +132,21 @@ public:
 	UFUNCTION()
 	void NavBack();
 
-	// Wwise AkAudio Events
+	// Wwise AkAudio Events, streamed in through the Phone Audio Cache Subsystem
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkRingtoneEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkRingtoneEvent;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkLeftEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkLeftEvent;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkRightEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkRightEvent;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkConfirmEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkConfirmEvent;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkBackEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkBackEvent;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkOpenPhoneEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkOpenPhoneEvent;
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Sound)
-	UAkAudioEvent* AkClosePhoneEvent;
+	TSoftObjectPtr<UAkAudioEvent> AkClosePhoneEvent;
 
 	// Wwise Functions
 	UFUNCTION(BlueprintCallable, Category = "Audio")
@@ -116,48 +163,57 @@ public:
 		const EAkCurveInterpolation FadeCurve = EAkCurveInterpolation::Linear
 	);
 
+	// How far phone UI sounds get sent if the phone audio component has no attenuation set.
+	// Server builds have no audio component, so this is always the range there, keep it matching the attenuation.
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
+	float PhoneUIAudioRange = 1500.0f;
+
+	// Phone sound waves, streamed in through the Phone Audio Cache Subsystem the first time the phone is pulled up
+	// or a sound is needed, so players who never use the phone never load them
+
 	// Ringtone sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* RingtoneSoundWave;
+	TSoftObjectPtr<USoundWave> RingtoneSoundWave;
 	// Nav Left sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* LeftSoundWave;
+	TSoftObjectPtr<USoundWave> LeftSoundWave;
 	// Nav Right sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* RightSoundWave;
+	TSoftObjectPtr<USoundWave> RightSoundWave;
 	// Nav Confirm sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* ConfirmSoundWave;
+	TSoftObjectPtr<USoundWave> ConfirmSoundWave;
 	// Nav Back sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* BackSoundWave;
+	TSoftObjectPtr<USoundWave> BackSoundWave;
 	// Open Phone sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* OpenPhoneSoundWave;
+	TSoftObjectPtr<USoundWave> OpenPhoneSoundWave;
 	// Close Phone sound wave
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Sound)
-	USoundWave* ClosePhoneSoundWave;
+	TSoftObjectPtr<USoundWave> ClosePhoneSoundWave;
+
+	// Every sound and Wwise event this phone uses, for the Phone Audio Cache Subsystem to stream in
+	void GetPhoneAudioAssets(TArray<FSoftObjectPath>& OutAssets) const;
 
 	// Server function to call another player.
-	// Caller checks to see if Channel 1 or 2 are open and joins one of them.
-	// After joining, calls Server_NotifyClientsAboutCallByState which calls
-	// Multicast_CallReceivingPlayerByState.
+	// Caller takes a free channel from the Phone Channel Subsystem and joins it,
+	// or gets OnLineBusy if either player is in a call or every channel is taken.
+	// After joining, the caller's phone goes to Dialing and the receiver's to Ringing.
 	UFUNCTION(BlueprintCallable, Server, Reliable)
 	void Server_CallPlayerByState(APlayerState* TargetPlayerState, APlayerState* CallerPlayerState);
 
-	// Server RPC to leave the current phone channel
+	// Server RPC to leave the current call, hangs up both phones in it
 	UFUNCTION(Server, Reliable, BlueprintCallable)
 	void Server_LeaveCurrentPhoneChannel(APlayerState* PlayerToChange);
 
 	// Server RPC to accept the current call and join the current phone channel
 	UFUNCTION(Server, Reliable)
-	void Server_AcceptCall(APlayerState* ReceivingPlayerState, uint32 ChannelID);
+	void Server_AcceptCall();
 
 	// Delegates
 
 	// Called when either player ends the current call
-	FEndCallDelegate OnEndCall;
-	// OnEndCall but for Blueprint listeners
 	UPROPERTY(BlueprintAssignable, Category = "Phone Events")
 	FBPEndCallDelegate BPOnEndCall;
 	// Called when this player receives a call from another player
@@ -166,19 +222,25 @@ public:
 	// Called when a call is started
 	UPROPERTY(BlueprintAssignable, Category = "Phone Events")
 	FCallStartedDelegate OnCallStarted;
+	// Called when the player we're calling picks up, or we pick up
+	UPROPERTY(BlueprintAssignable, Category = "Phone Events")
+	FCallConnectedDelegate OnCallConnected;
+	// Called on the caller when their call couldn't go through
+	UPROPERTY(BlueprintAssignable, Category = "Phone Events")
+	FLineBusyDelegate OnLineBusy;
 
-	// Timer handle for managing phone call timeouts
+	// Timer handle for managing phone call timeouts, server only
 	FTimerHandle PhoneCallTimeoutHandle;
 
-	// Phone Screen Widget
+	// Phone Screen Widget, null on dedicated servers
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
 	UWidgetComponent* PhoneScreenWidgetPopUp;
 
-	// Phone Screen Rect Light
+	// Phone Screen Rect Light, null on dedicated servers
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
 	URectLightComponent* PhoneScreenLight;
 
-	// Phone Screen Point Light
+	// Phone Screen Point Light, null on dedicated servers
 	UPROPERTY(BlueprintReadWrite, VisibleAnywhere)
 	UPointLightComponent* PhoneScreenPLight;
 
@@ -186,16 +248,30 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
-	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	// Destroys the screen widget, lights and audio components.
+	// Nobody sees or hears a dedicated server's phones, and they would otherwise follow the hand every frame.
+	void StripCosmeticComponents();
 
-	// Client RPC that broadcasts the OnCallStarted Delegate to the
-	// client's phone
-	UFUNCTION(Client, Reliable)
-	void Client_NotifyCallStarted(APlayerState* TargetPlayerState, uint32 ChannelID);
+	// Works out whether this phone belongs to our player, and drops to proxy mode if it doesn't.
+	// Who owns the phone isn't always known at BeginPlay, so this retries until it is.
+	void UpdateProxyMode();
+
+	// Proxy mode for other players' phones: destroys the screen widget, the lights and the ringtone component,
+	// leaving just the mesh and one audio component that plays both the ringtone and UI sounds
+	void EnterProxyMode();
+
+	// Destroys the screen widget and lights
+	void DestroyScreenComponents();
+
+	// Is this someone else's phone running in proxy mode
+	bool IsProxy() const { return bIsProxy; }
 
-	//
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Client RPC that broadcasts the OnLineBusy Delegate to the
+	// caller's phone
 	UFUNCTION(Client, Reliable)
-	void Client_NotifyCallReceived(APlayerState* CallerPlayerState, APlayerPhone* CallerPhone, uint32 ChannelID);
+	void Client_NotifyLineBusy(E_PhoneLineBusyReason Reason);
 
 	// Function that ends the current call
 	UFUNCTION(BlueprintCallable)
@@ -205,10 +281,14 @@ protected:
 	UFUNCTION(BlueprintCallable)
 	void AcceptCall();
 
-	// Function that gets called after a receiving player doesn't answer/deny the phone call
+	// Function that gets called on the server after a receiving player doesn't answer/deny the phone call
 	UFUNCTION()
 	void PendingCallTimeout();
 
+	// Broadcasts the phone event for the phase the call is now in
+	UFUNCTION()
+	void OnRep_CallState(const FCallState& OldCallState);
+
 	// Float for how long it takes for an ignored call to be
 	// auto denied
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
@@ -229,9 +309,15 @@ private:
 	// NETWORKED FUNCTIONS
 
 
-	// Tell the server to run Multicast_PlayPhoneAudio()
-	UFUNCTION(Server, Reliable)
-	void Server_PlayPhoneAudio(APlayerPhone* TargetPhone, E_AudioType AudioType);
+	// Tell the server to send a phone UI sound to the players close enough to hear it.
+	// Unreliable since it's cosmetic, menu spam must never back up the reliable buffer.
+	UFUNCTION(Server, Unreliable)
+	void Server_PlayPhoneAudio(E_AudioType AudioType);
+
+	// Play a phone UI sound from SourcePhone on this phone's owning client.
+	// The server only sends it to players within earshot of SourcePhone.
+	UFUNCTION(Client, Unreliable)
+	void Client_PlayPhoneAudio(APlayerPhone* SourcePhone, E_AudioType AudioType);
 
 	// Play phone ringtone from this phone to all clients 
 	UFUNCTION(NetMulticast, Reliable)
@@ -245,42 +331,35 @@ private:
 	UFUNCTION(NetMulticast, Reliable)
 	void Multicast_StopPhoneAudio(APlayerPhone* TargetPhone);
 
-	// Server RPC to call Multicast_CallReceivingPlayerByState
-	UFUNCTION(Server, Reliable)
-	void Server_NotifyClientsAboutCallByState(APlayerState* ReceivingPlayerState, APlayerState* CallerPlayerState, int32 ChannelID);
-
-	// Multicast RPC that goes through each client and compares their
-	// local player state to the passed in ReceivingPlayerState.
-	// If they are equal, then we know this player is the Receiving Player.
-	// So we let them know they've been invited to a call.
-	UFUNCTION(NetMulticast, Reliable)
-	void Multicast_CallReceivingPlayerByState(APlayerState* ReceivingPlayerState, APlayerState* CallerPlayerState,
-		APlayerPhone* CallerPhone, APlayerPhone* ReceiverPhone, int32 ChannelID);
-
 	// Server RPC that gets called when this player receives a call.
 	// Allows the player to accept or deny the call.
 	UFUNCTION(Server, Reliable)
 	void Server_ReceivePhoneCall(APlayerState* ReceivingPlayerState, APlayerState* CallerPlayerState, int32 ChannelID);
 
-	// Server RPC to modify the bIsInCall replicated bool on a specific phone
-	UFUNCTION(Server, Reliable)
-	void Server_SetIsInCall(const bool newVal, APlayerPhone* phoneToModify);
 
-	// Client RPC to bind two phone's OnEndCall Delegates locally
-	UFUNCTION(Client, Reliable)
-	void Client_BindOnEndCall(APlayerPhone* OtherPlayerPhone);
-	// Client RPC to unbind two phone's OnEndCall Delegates locally
-	UFUNCTION(Client, Reliable)
-	void Client_UnbindOnEndCall(APlayerPhone* OtherPlayerPhone);
+	// HELPER FUNCTIONS
 
-	UFUNCTION(Client, Reliable)
-	void Client_BroadcastOnCallEnded();
+	// Plays a phone UI sound right away for our player, then has the server send it to anyone nearby
+	void PlayPhoneUISound(E_AudioType AudioType);
 
-	UFUNCTION(Client, Reliable)
-	void Client_BroadcastOnEndCall(APlayerState* OtherPlayerState);
+	// Plays one of the phone sounds on this phone, locally only.
+	// If the sound isn't loaded yet it gets streamed in and plays once it's ready.
+	void PlayPhoneAudioLocal(E_AudioType AudioType);
 
+	// Sound wave for this audio type
+	const TSoftObjectPtr<USoundWave>& GetSoundWave(E_AudioType AudioType) const;
 
-	// HELPER FUNCTIONS
+	// Asks the Phone Audio Cache Subsystem to stream in all of our audio, only does anything the first time
+	void RequestPhoneAudio();
+
+	// Have we already asked for all of our audio
+	bool bRequestedPhoneAudio = false;
+
+	// How far away players can hear this phone's UI sounds
+	float GetPhoneUIAudioRange() const;
+
+	// Tells the server and this phone's player that their call couldn't go through, server only
+	void NotifyLineBusy(E_PhoneLineBusyReason Reason);
 
 	// Debug Function to allow player to hear themselves while in a call
 	void PlayVoiceLocally();
@@ -292,13 +371,14 @@ private:
 	// Can be called from Client or Server
 	APlayerPhone* GetPhoneFromPlayerState(APlayerState* PlayerState);
 
-	// Delegate function that gets called when the other player in the call
-	// ends the call
-	UFUNCTION()
-	void OnOtherPlayerEndCall(APlayerState* OtherPlayerState);
+	// Moves this phone's call to a new phase, server only
+	void SetCallState(const E_CallPhase NewPhase, const int32 NewChannel, APlayerState* NewOtherPlayerState);
 
-	UFUNCTION(Client, Reliable)
-	void Client_OnOtherPlayerEndCall(APlayerState* OtherPlayerState);
+	// Leaves the voice channel, frees it and ends this phone's side of the call, server only
+	void HangUp();
+
+	// Player state of the player holding this phone
+	APlayerState* GetOwningPlayerState() const;
 
 	// MEMBER VARIABLES
 
@@ -309,24 +389,28 @@ private:
 	// bool for debugging, allows player to hear themselves in a call
 	bool bHearSelf = true;
 
-	// bool
-	bool bIsLeavingCall = false;
-
 	// FUniqueNetIdPtr to keep track of the other person in the call with us
 	FUniqueNetIdPtr mOtherPlayerId;
 	// FUniqueNetIdPtr to keep track of our owning player's id
 	FUniqueNetIdPtr mOwningPlayerId;
 
-	// Replicated property to keep track of the current channel.
-	// Channel -1 means no phone channel connected currently
-	UPROPERTY(Replicated, BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
-	int mCurrentChannel = -1;
-
-	// Replicated bool to keep track of if the player is currently in a call
-	UPROPERTY(Replicated)
-	bool bIsInCall = false;
+	// Replicated state of this phone's call, only the owning client needs it
+	UPROPERTY(ReplicatedUsing = OnRep_CallState)
+	FCallState CallState;
 
 	// Pointer to store a ref to our phone's 3D widget
 	UPROPERTY(BlueprintReadOnly, meta = (AllowPrivateAccess = "true"))
 	UPlayerPhoneWidget* mPlayerPhoneWidget = nullptr;
+
+	// Is this someone else's phone running in proxy mode
+	bool bIsProxy = false;
+
+	// Do we know yet whether this phone is ours
+	bool bProxyModeDecided = false;
+
+	// Retries UpdateProxyMode until we know who owns this phone
+	FTimerHandle ProxyModeTimerHandle;
+
+	// How often to retry UpdateProxyMode, in seconds
+	static constexpr float ProxyModeRetryInterval = 0.25f;
 };
@@ -0,0 +1,125 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ActorSpatialGrid.h"
+
+FActorSpatialGrid::FActorSpatialGrid(const float InCellSize)
+	: CellSize(FMath::Max(InCellSize, 1.0f))
+{
+}
+
+void FActorSpatialGrid::Add(AActor* Actor, const FVector& Location)
+{
+	if (!Actor)
+	{
+		return;
+	}
+
+	const FIntVector NewCellCoord = GetCellCoord(Location);
+
+	// If we are already in the grid, either update our location in place or move cells
+	if (const FIntVector* CurrentCellCoord = ActorCells.Find(Actor))
+	{
+		if (*CurrentCellCoord == NewCellCoord)
+		{
+			for (FEntry& Entry : Cells.FindChecked(NewCellCoord))
+			{
+				if (Entry.Actor == Actor)
+				{
+					Entry.Location = Location;
+					break;
+				}
+			}
+			return;
+		}
+
+		RemoveFromCell(*CurrentCellCoord, Actor);
+	}
+
+	Cells.FindOrAdd(NewCellCoord).Add({ Actor, Location });
+	ActorCells.Add(Actor, NewCellCoord);
+}
+
+void FActorSpatialGrid::Remove(const AActor* Actor)
+{
+	FIntVector CellCoord;
+	if (ActorCells.RemoveAndCopyValue(Actor, CellCoord))
+	{
+		RemoveFromCell(CellCoord, Actor);
+	}
+}
+
+void FActorSpatialGrid::Empty()
+{
+	Cells.Empty();
+	ActorCells.Empty();
+}
+
+void FActorSpatialGrid::QueryCone(const FVector& Origin, const FVector& Direction, const float Length,
+	const float BaseRadius, const float HalfAngleDegrees, TArray<AActor*>& OutActors) const
+{
+	if (Length <= 0.0f || Cells.Num() == 0)
+	{
+		return;
+	}
+
+	const FVector Dir = Direction.GetSafeNormal();
+	const float RadiusGrowth = FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(HalfAngleDegrees, 0.0f, 89.0f)));
+	const float EndRadius = BaseRadius + Length * RadiusGrowth;
+
+	// Only walk the cells that overlap the cone's bounds
+	FBox ConeBounds(Origin - FVector(BaseRadius), Origin + FVector(BaseRadius));
+	ConeBounds += FBox(Origin + Dir * Length - FVector(EndRadius), Origin + Dir * Length + FVector(EndRadius));
+
+	ForEachInBox(ConeBounds, [&](AActor* Actor, const FVector& Location)
+	{
+		const FVector ToActor = Location - Origin;
+
+		// Distance along the cone's axis
+		const float AxisDist = FVector::DotProduct(ToActor, Dir);
+		if (AxisDist < 0.0f || AxisDist > Length)
+		{
+			return;
+		}
+
+		// Distance away from the cone's axis, compared against the cone's radius at that point
+		const float ConeRadius = BaseRadius + AxisDist * RadiusGrowth;
+		const float AxisDistSquared = ToActor.SizeSquared() - AxisDist * AxisDist;
+		if (AxisDistSquared <= ConeRadius * ConeRadius)
+		{
+			OutActors.Add(Actor);
+		}
+	});
+}
+
+FIntVector FActorSpatialGrid::GetCellCoord(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / CellSize),
+		FMath::FloorToInt(Location.Y / CellSize),
+		FMath::FloorToInt(Location.Z / CellSize));
+}
+
+void FActorSpatialGrid::RemoveFromCell(const FIntVector& CellCoord, const AActor* Actor)
+{
+	TArray<FEntry>* Cell = Cells.Find(CellCoord);
+	if (!Cell)
+	{
+		return;
+	}
+
+	for (int32 EntryIdx = 0; EntryIdx < Cell->Num(); EntryIdx++)
+	{
+		if ((*Cell)[EntryIdx].Actor == Actor)
+		{
+			Cell->RemoveAtSwap(EntryIdx, 1, false);
+			break;
+		}
+	}
+
+	// Drop empty cells so queries don't walk them
+	if (Cell->Num() == 0)
+	{
+		Cells.Remove(CellCoord);
+	}
+}
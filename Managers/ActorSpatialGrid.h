@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform grid that buckets actors by the cell their location falls in.
+ * Each cell keeps the actor next to the location it was added at, so queries
+ * can test a cell's entries without touching the actors themselves.
+ * Not a UObject, owners are responsible for removing actors before they're destroyed.
+ */
+class NETWORKINGPROTOTYPE_API FActorSpatialGrid
+{
+public:
+	explicit FActorSpatialGrid(const float InCellSize = 500.0f);
+
+	// Adds an actor at the passed in location, or moves it there if it's already in the grid
+	void Add(AActor* Actor, const FVector& Location);
+
+	// Removes an actor from the grid, does nothing if it isn't in it
+	void Remove(const AActor* Actor);
+
+	// Removes every actor from the grid
+	void Empty();
+
+	// Is this actor in the grid
+	bool Contains(const AActor* Actor) const { return ActorCells.Contains(Actor); }
+
+	// Number of actors in the grid
+	int32 Num() const { return ActorCells.Num(); }
+
+	float GetCellSize() const { return CellSize; }
+
+	// Calls Visitor(AActor*, const FVector& Location) for every actor in a cell overlapping the box.
+	// Actors in those cells can still be outside the box, visitors need to do their own test.
+	template <typename VisitorType>
+	void ForEachInBox(const FBox& Box, VisitorType&& Visitor) const
+	{
+		const FIntVector MinCell = GetCellCoord(Box.Min);
+		const FIntVector MaxCell = GetCellCoord(Box.Max);
+
+		for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					const TArray<FEntry>* Cell = Cells.Find(FIntVector(X, Y, Z));
+					if (!Cell)
+					{
+						continue;
+					}
+
+					for (const FEntry& Entry : *Cell)
+					{
+						Visitor(Entry.Actor, Entry.Location);
+					}
+				}
+			}
+		}
+	}
+
+	// Gathers every actor inside a cone starting at Origin and going Length units along Direction.
+	// The cone's radius starts at BaseRadius and widens by HalfAngleDegrees, a half angle of 0 gives a capsule.
+	// OutActors is appended to, not emptied.
+	void QueryCone(const FVector& Origin, const FVector& Direction, const float Length, const float BaseRadius,
+		const float HalfAngleDegrees, TArray<AActor*>& OutActors) const;
+
+private:
+	// An actor and the location it was added at
+	struct FEntry
+	{
+		AActor* Actor;
+		FVector Location;
+	};
+
+	// Gets the cell coordinate the passed in location falls in
+	FIntVector GetCellCoord(const FVector& Location) const;
+
+	// Removes an actor from the passed in cell
+	void RemoveFromCell(const FIntVector& CellCoord, const AActor* Actor);
+
+	// Side length of each cell in world units
+	float CellSize;
+
+	// Actors bucketed by cell
+	TMap<FIntVector, TArray<FEntry>> Cells;
+
+	// Which cell each actor is currently in
+	TMap<const AActor*, FIntVector> ActorCells;
+};
@@ -0,0 +1,394 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FootprintPoolSubsystem.h"
+
+#include "HiddenActor_Footprint.h"
+#include "Components/DecalComponent.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogFootprintPool);
+
+bool UFootprintPoolSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if UE_SERVER
+	return false;
+#else
+	// Footprint components handle a missing pool by not placing anything
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+#endif
+}
+
+void UFootprintPoolSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(AgeOutTimerHandle);
+		World->GetTimerManager().ClearTimer(PreallocateTimerHandle);
+	}
+
+	// The actors belong to the world and get cleaned up with it, just drop our refs
+	FootprintRecords.Empty();
+	FootprintSlots.Empty();
+	NumPreallocatedSlots = 0;
+	RevealSets.Empty();
+	RevealDecalOwner = nullptr;
+	NumActiveFootprints = 0;
+	NextSlotIdx = 0;
+
+	Super::Deinitialize();
+}
+
+void UFootprintPoolSubsystem::ConfigurePool(TSubclassOf<AHiddenActor_Footprint> InFootprintClass,
+	E_FootprintStorageMode InStorageMode, int32 InCapacity, float InMaxFootprintAge, int32 InMaxRevealedFootprints)
+{
+	// The ring has already been built by another footprint component, all we can do is keep footprints around
+	// long enough for this one too. 0 or less never ages out, which beats any lifetime.
+	if (FootprintRecords.Num() > 0)
+	{
+		if (MaxFootprintAge > 0.0f && (InMaxFootprintAge <= 0.0f || InMaxFootprintAge > MaxFootprintAge))
+		{
+			MaxFootprintAge = InMaxFootprintAge;
+			if (MaxFootprintAge <= 0.0f)
+			{
+				GetWorld()->GetTimerManager().ClearTimer(AgeOutTimerHandle);
+			}
+		}
+		return;
+	}
+
+	if (!InFootprintClass || InCapacity <= 0)
+	{
+		UE_LOG(LogFootprintPool, Error, TEXT("ConfigurePool called without a footprint class or with an invalid capacity!"));
+		return;
+	}
+
+	FootprintClass = InFootprintClass;
+	StorageMode = InStorageMode;
+	Capacity = InCapacity;
+	MaxFootprintAge = InMaxFootprintAge;
+
+	FootprintRecords.SetNum(Capacity);
+
+	switch (StorageMode)
+	{
+	case E_FootprintStorageMode::Actors:
+		FootprintSlots.SetNumZeroed(Capacity);
+		PreallocateFootprintActors();
+		break;
+
+	case E_FootprintStorageMode::Records:
+		PrepareRevealDecals(FMath::Max(1, InMaxRevealedFootprints));
+		break;
+	}
+
+	// Start the age out timer
+	if (MaxFootprintAge > 0.0f)
+	{
+		GetWorld()->GetTimerManager().SetTimer(AgeOutTimerHandle, this, &UFootprintPoolSubsystem::AgeOutFootprints,
+			AgeOutCheckInterval, true);
+	}
+}
+
+void UFootprintPoolSubsystem::PlaceFootprint(const FTransform& FootprintTransform, int PlayerIdx,
+	E_FootEmum FootSelection)
+{
+	if (FootprintRecords.Num() == 0)
+	{
+		return;
+	}
+
+	// When the ring is full the next slot is also the oldest one, so we just reuse it
+	if (NumActiveFootprints < FootprintRecords.Num())
+	{
+		NumActiveFootprints++;
+	}
+
+	FFootprintRecord& Record = FootprintRecords[NextSlotIdx];
+	Record.Transform = FootprintTransform;
+	Record.PlacedTime = GetWorld()->GetTimeSeconds();
+	Record.PlacementId = NextPlacementId++;
+	Record.PlayerIdx = static_cast<uint8>(FMath::Clamp(PlayerIdx, 0, 255));
+	Record.FootSelection = FootSelection;
+
+	if (StorageMode == E_FootprintStorageMode::Actors)
+	{
+		if (AHiddenActor_Footprint* Footprint = FootprintSlots[NextSlotIdx])
+		{
+			Footprint->ActivateFootprint(FootprintTransform, PlayerIdx, FootSelection);
+		}
+	}
+
+	// Advance the ring
+	NextSlotIdx = (NextSlotIdx + 1) % FootprintRecords.Num();
+}
+
+void UFootprintPoolSubsystem::ClearFootprints()
+{
+	for (AHiddenActor_Footprint* Footprint : FootprintSlots)
+	{
+		if (Footprint)
+		{
+			Footprint->DeactivateFootprint();
+		}
+	}
+
+	for (FFootprintRevealSet& RevealSet : RevealSets)
+	{
+		HideRevealSet(RevealSet);
+	}
+
+	NumActiveFootprints = 0;
+}
+
+int32 UFootprintPoolSubsystem::RevealFootprintsAlongSegment(const UObject* Requester, const FVector& Start,
+	const FVector& End, float Radius)
+{
+	if (StorageMode != E_FootprintStorageMode::Records)
+	{
+		return 0;
+	}
+
+	FFootprintRevealSet* RevealSet = FindOrAddRevealSet(Requester);
+	if (!RevealSet)
+	{
+		return 0;
+	}
+
+	const AHiddenActor_Footprint* FootprintCDO = FootprintClass->GetDefaultObject<AHiddenActor_Footprint>();
+	const float RadiusSquared = Radius * Radius;
+	const int32 NumSlots = FootprintRecords.Num();
+	int32 NumRevealed = 0;
+
+	// Walk the active part of the ring from the newest footprint to the oldest,
+	// so if there are more footprints in view than decals the freshest ones win
+	for (int32 Age = 0; Age < NumActiveFootprints && NumRevealed < RevealSet->Decals.Num(); Age++)
+	{
+		const int32 SlotIdx = (NextSlotIdx - 1 - Age + NumSlots) % NumSlots;
+		const FFootprintRecord& Record = FootprintRecords[SlotIdx];
+
+		if (FMath::PointDistToSegmentSquared(Record.Transform.GetLocation(), Start, End) > RadiusSquared)
+		{
+			continue;
+		}
+
+		UDecalComponent* RevealDecal = RevealSet->Decals[NumRevealed];
+
+		// Only touch the decal's render state if it's showing a different footprint than last time
+		if (RevealSet->PlacementIds[NumRevealed] != Record.PlacementId)
+		{
+			RevealSet->PlacementIds[NumRevealed] = Record.PlacementId;
+
+			RevealDecal->SetWorldTransform(RevealDecalRelativeTransform * Record.Transform);
+			RevealDecal->SetDecalMaterial(FootprintCDO->GetFootDecalMat(Record.FootSelection));
+
+			FLinearColor PlayerColor;
+			if (AHiddenActor_Footprint::GetPlayerFootprintColor(Record.PlayerIdx, PlayerColor))
+			{
+				RevealDecal->SetDecalColor(PlayerColor);
+			}
+		}
+
+		if (!RevealDecal->IsVisible())
+		{
+			RevealDecal->SetVisibility(true);
+		}
+
+		NumRevealed++;
+	}
+
+	// Hide any decals this requester's last reveal used that we didn't need this time
+	for (int32 DecalIdx = NumRevealed; DecalIdx < RevealSet->NumShown; DecalIdx++)
+	{
+		RevealSet->Decals[DecalIdx]->SetVisibility(false);
+	}
+	RevealSet->NumShown = NumRevealed;
+
+	return NumRevealed;
+}
+
+void UFootprintPoolSubsystem::HideRevealedFootprints(const UObject* Requester)
+{
+	for (FFootprintRevealSet& RevealSet : RevealSets)
+	{
+		if (RevealSet.Requester.Get() == Requester)
+		{
+			HideRevealSet(RevealSet);
+			return;
+		}
+	}
+}
+
+void UFootprintPoolSubsystem::HideRevealSet(FFootprintRevealSet& RevealSet)
+{
+	for (int32 DecalIdx = 0; DecalIdx < RevealSet.NumShown; DecalIdx++)
+	{
+		RevealSet.Decals[DecalIdx]->SetVisibility(false);
+	}
+	RevealSet.NumShown = 0;
+}
+
+FFootprintRevealSet* UFootprintPoolSubsystem::FindOrAddRevealSet(const UObject* Requester)
+{
+	if (!Requester || !RevealDecalOwner)
+	{
+		return nullptr;
+	}
+
+	// There's only ever a handful of requesters, one per magnifying glass
+	FFootprintRevealSet* StaleRevealSet = nullptr;
+	for (FFootprintRevealSet& RevealSet : RevealSets)
+	{
+		if (RevealSet.Requester.Get() == Requester)
+		{
+			return &RevealSet;
+		}
+
+		if (!StaleRevealSet && !RevealSet.Requester.IsValid())
+		{
+			StaleRevealSet = &RevealSet;
+		}
+	}
+
+	// Take over the decals of a requester that's gone, it can't hide what it left showing anymore
+	if (StaleRevealSet)
+	{
+		HideRevealSet(*StaleRevealSet);
+		StaleRevealSet->Requester = Requester;
+		return StaleRevealSet;
+	}
+
+	FFootprintRevealSet& RevealSet = RevealSets.AddDefaulted_GetRef();
+	RevealSet.Requester = Requester;
+	RevealSet.Decals.Reserve(NumDecalsPerRevealSet);
+	RevealSet.PlacementIds.Init(0, NumDecalsPerRevealSet);
+
+	for (int32 DecalIdx = 0; DecalIdx < NumDecalsPerRevealSet; DecalIdx++)
+	{
+		UDecalComponent* RevealDecal = NewObject<UDecalComponent>(RevealDecalOwner);
+		RevealDecal->DecalSize = RevealDecalSize;
+		RevealDecal->SetVisibility(false);
+		RevealDecal->RegisterComponent();
+
+		RevealSet.Decals.Add(RevealDecal);
+	}
+
+	UE_LOG(LogFootprintPool, Log, TEXT("Created %d reveal decals for %s."), NumDecalsPerRevealSet, *GetNameSafe(Requester));
+
+	return &RevealSet;
+}
+
+void UFootprintPoolSubsystem::PreallocateFootprintActors()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int32 LastSlotIdx = FMath::Min(NumPreallocatedSlots + FootprintActorsPerFrame, FootprintSlots.Num());
+	for (; NumPreallocatedSlots < LastSlotIdx; NumPreallocatedSlots++)
+	{
+		AHiddenActor_Footprint* Footprint = World->SpawnActor<AHiddenActor_Footprint>(FootprintClass,
+			FVector::ZeroVector, FRotator::ZeroRotator, SpawnParams);
+
+		if (Footprint)
+		{
+			// A step may have already landed in this slot before its actor was ready
+			const FFootprintRecord& Record = FootprintRecords[NumPreallocatedSlots];
+			if (IsSlotActive(NumPreallocatedSlots))
+			{
+				Footprint->ActivateFootprint(Record.Transform, Record.PlayerIdx, Record.FootSelection);
+			}
+			else
+			{
+				// Start out parked until a step places it
+				Footprint->DeactivateFootprint();
+			}
+		}
+
+		FootprintSlots[NumPreallocatedSlots] = Footprint;
+	}
+
+	if (NumPreallocatedSlots < FootprintSlots.Num())
+	{
+		PreallocateTimerHandle = World->GetTimerManager().SetTimerForNextTick(this, &UFootprintPoolSubsystem::PreallocateFootprintActors);
+		return;
+	}
+
+	UE_LOG(LogFootprintPool, Log, TEXT("Preallocated %d footprint actors."), NumPreallocatedSlots);
+}
+
+void UFootprintPoolSubsystem::PrepareRevealDecals(int32 NumDecals)
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// Copy the decal setup from the footprint blueprint so records look the same as footprint actors
+	const AHiddenActor_Footprint* FootprintCDO = FootprintClass->GetDefaultObject<AHiddenActor_Footprint>();
+	const UDecalComponent* TemplateDecal = FootprintCDO ? FootprintCDO->GetFootprintDecalComp() : nullptr;
+	if (!TemplateDecal)
+	{
+		UE_LOG(LogFootprintPool, Error, TEXT("Footprint class has no decal component to copy for Records mode!"));
+		return;
+	}
+	RevealDecalRelativeTransform = TemplateDecal->GetRelativeTransform();
+	RevealDecalSize = TemplateDecal->DecalSize;
+	NumDecalsPerRevealSet = NumDecals;
+
+	// Every requester's decals get made on this actor the first time it reveals
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	RevealDecalOwner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+	UE_LOG(LogFootprintPool, Log, TEXT("Each reveal gets %d decals for %d footprint records."), NumDecals, Capacity);
+}
+
+void UFootprintPoolSubsystem::AgeOutFootprints()
+{
+	if (MaxFootprintAge <= 0.0f)
+	{
+		return;
+	}
+
+	const float OldestAllowedTime = GetWorld()->GetTimeSeconds() - MaxFootprintAge;
+
+	// Footprints are placed in order, so once we hit one that is young enough
+	// every footprint after it is too
+	while (NumActiveFootprints > 0)
+	{
+		const int32 OldestSlotIdx = GetOldestSlotIdx();
+		if (FootprintRecords[OldestSlotIdx].PlacedTime > OldestAllowedTime)
+		{
+			break;
+		}
+
+		if (StorageMode == E_FootprintStorageMode::Actors)
+		{
+			if (AHiddenActor_Footprint* Footprint = FootprintSlots[OldestSlotIdx])
+			{
+				Footprint->DeactivateFootprint();
+			}
+		}
+
+		NumActiveFootprints--;
+	}
+}
+
+int32 UFootprintPoolSubsystem::GetOldestSlotIdx() const
+{
+	const int32 NumSlots = FootprintRecords.Num();
+	return (NextSlotIdx - NumActiveFootprints + NumSlots) % NumSlots;
+}
+
+bool UFootprintPoolSubsystem::IsSlotActive(int32 SlotIdx) const
+{
+	const int32 NumSlots = FootprintRecords.Num();
+	return (SlotIdx - GetOldestSlotIdx() + NumSlots) % NumSlots < NumActiveFootprints;
+}
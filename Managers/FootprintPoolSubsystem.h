@@ -0,0 +1,195 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NetworkingPrototype/Components/FootprintComponent.h"
+#include "FootprintPoolSubsystem.generated.h"
+
+// Forward declare our footprint actor
+class AHiddenActor_Footprint;
+class UDecalComponent;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogFootprintPool, Log, All);
+
+// Plain data for a single placed footprint
+struct FFootprintRecord
+{
+	// Where the footprint was placed
+	FTransform Transform = FTransform::Identity;
+
+	// World time the footprint was placed at
+	float PlacedTime = 0.0f;
+
+	// Bumped every time this slot gets placed, lets reveal decals know
+	// when the footprint they are showing got recycled
+	uint32 PlacementId = 0;
+
+	// Index of the player who left this footprint
+	uint8 PlayerIdx = 0;
+
+	// Which foot left this footprint
+	E_FootEmum FootSelection = E_FootEmum::LeftFoot;
+};
+
+// Decals one reveal requester draws its revealed footprint records with,
+// so every magnifying glass in the world shows its own footprints
+USTRUCT()
+struct FFootprintRevealSet
+{
+	GENERATED_BODY()
+
+	// Who is revealing with these decals, a stale requester's set gets handed to the next new one
+	TWeakObjectPtr<const UObject> Requester;
+
+	// Fixed set of decals used to draw revealed footprints
+	UPROPERTY()
+	TArray<UDecalComponent*> Decals;
+
+	// PlacementId each decal is currently showing, parallel to Decals
+	TArray<uint32> PlacementIds;
+
+	// Number of decals shown by the requester's last reveal
+	int32 NumShown = 0;
+};
+
+/**
+ * Per-world pool of footprints.
+ * Keeps a fixed ring of footprint slots that is built the first time a Footprint Component
+ * configures it, then recycles the oldest footprint whenever a new one is placed
+ * and the ring is full. Footprints older than MaxFootprintAge are handed back to the ring,
+ * so the footprint count never grows past Capacity no matter how long a match runs.
+ *
+ * In Actors mode every slot is a preallocated AHiddenActor_Footprint, spawned a few per frame
+ * after the ring is built so the first player to spawn doesn't hitch.
+ * In Records mode every slot is just an FFootprintRecord and the magnifying glass
+ * queries the records directly, only the ones being revealed get one of a small
+ * fixed set of decal components. Every magnifying glass revealing them has its own set.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UFootprintPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Footprints are only ever seen, so dedicated servers don't get a pool at all
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+
+	virtual void Deinitialize() override;
+
+	// Sets up the pool with the footprint class to use and its limits.
+	// The first call with a valid class builds the ring. Later calls can only make footprints
+	// last longer, every footprint ages out at the longest lifetime any caller asked for.
+	void ConfigurePool(TSubclassOf<AHiddenActor_Footprint> InFootprintClass, E_FootprintStorageMode InStorageMode,
+		int32 InCapacity, float InMaxFootprintAge, int32 InMaxRevealedFootprints);
+
+	// Places a footprint in the world, recycling the oldest footprint if the pool is full.
+	void PlaceFootprint(const FTransform& FootprintTransform, int PlayerIdx, E_FootEmum FootSelection);
+
+	// Hides every footprint and returns them all to the pool
+	void ClearFootprints();
+
+	// Records mode only. Shows the newest footprints within Radius of the segment from Start to End
+	// and hides the ones shown by Requester's last reveal that aren't in it anymore.
+	// Every requester gets its own decals, so reveals by different requesters don't hide each other's footprints.
+	// Returns the number of footprints revealed.
+	int32 RevealFootprintsAlongSegment(const UObject* Requester, const FVector& Start, const FVector& End, float Radius);
+
+	// Records mode only. Hides every footprint shown by Requester's last reveal.
+	void HideRevealedFootprints(const UObject* Requester);
+
+	// Getters for the pool settings and state
+	E_FootprintStorageMode GetStorageMode() const { return StorageMode; }
+	int32 GetCapacity() const { return Capacity; }
+	float GetMaxFootprintAge() const { return MaxFootprintAge; }
+	int32 GetNumActiveFootprints() const { return NumActiveFootprints; }
+
+private:
+	// Spawns the next FootprintActorsPerFrame footprint actors the ring holds, hidden and without collision,
+	// and keeps going next frame until every slot has one
+	void PreallocateFootprintActors();
+
+	// Copies the decal setup from the footprint class and spawns the actor that owns every reveal decal
+	void PrepareRevealDecals(int32 NumDecals);
+
+	// Reveal set of Requester, made the first time it reveals. Reuses the set of a requester that's gone if there is one.
+	// Null if the reveal decals couldn't be prepared.
+	FFootprintRevealSet* FindOrAddRevealSet(const UObject* Requester);
+
+	// Hides every decal shown by a reveal set
+	static void HideRevealSet(FFootprintRevealSet& RevealSet);
+
+	// Looping function that returns footprints older than MaxFootprintAge to the pool.
+	// Footprints are placed in ring order so we only ever look at the oldest ones.
+	void AgeOutFootprints();
+
+	// Index of the oldest active footprint in the ring
+	int32 GetOldestSlotIdx() const;
+
+	// Is a footprint currently placed in this slot
+	bool IsSlotActive(int32 SlotIdx) const;
+
+	// How footprints are stored
+	E_FootprintStorageMode StorageMode = E_FootprintStorageMode::Actors;
+
+	// Footprint Actor class to spawn for every slot, or to copy the decal settings from in Records mode
+	UPROPERTY()
+	TSubclassOf<AHiddenActor_Footprint> FootprintClass;
+
+	// Ring of footprint records, always used to keep track of placement order and age
+	TArray<FFootprintRecord> FootprintRecords;
+
+	// Actors mode only. Ring of preallocated footprint actors, parallel to FootprintRecords.
+	// Slots past NumPreallocatedSlots are null until their actor gets spawned.
+	UPROPERTY()
+	TArray<AHiddenActor_Footprint*> FootprintSlots;
+
+	// Actors mode only. Number of slots that have had their actor spawned
+	int32 NumPreallocatedSlots = 0;
+
+	// Actors mode only. Footprint actors spawned per frame while preallocating
+	static constexpr int32 FootprintActorsPerFrame = 32;
+
+	// Records mode only. Actor that owns every requester's reveal decals
+	UPROPERTY()
+	AActor* RevealDecalOwner = nullptr;
+
+	// Records mode only. Decals of every requester that has revealed footprints, there's usually one per magnifying glass
+	UPROPERTY()
+	TArray<FFootprintRevealSet> RevealSets;
+
+	// Records mode only. Number of decals in every reveal set
+	int32 NumDecalsPerRevealSet = 0;
+
+	// Size of the footprint actor's decal, copied to every reveal decal
+	FVector RevealDecalSize = FVector::ZeroVector;
+
+	// Relative transform of the footprint actor's decal, applied on top of the record transform
+	FTransform RevealDecalRelativeTransform = FTransform::Identity;
+
+	// Slot the next footprint will be placed in
+	int32 NextSlotIdx = 0;
+
+	// Number of slots currently holding a footprint
+	int32 NumActiveFootprints = 0;
+
+	// Used to stamp every placed footprint with a unique id
+	uint32 NextPlacementId = 1;
+
+	// Max number of footprints alive at once
+	int32 Capacity = 0;
+
+	// How long a footprint stays in the world, in seconds. 0 or less never ages out.
+	float MaxFootprintAge = 0.0f;
+
+	// How often we check for footprints to age out, in seconds
+	static constexpr float AgeOutCheckInterval = 1.0f;
+
+	// Age out timer
+	FTimerHandle AgeOutTimerHandle;
+
+	// Timer for the next frame of preallocation
+	FTimerHandle PreallocateTimerHandle;
+};
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HiddenActorIndexSubsystem.h"
+
+#include "HiddenActor.h"
+
+void UHiddenActorIndexSubsystem::Deinitialize()
+{
+	HiddenActorGrid.Empty();
+	QueryScratch.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHiddenActorIndexSubsystem::RegisterHiddenActor(AHiddenActor* HiddenActor)
+{
+	if (!HiddenActor)
+	{
+		return;
+	}
+
+	HiddenActorGrid.Add(HiddenActor, HiddenActor->GetActorLocation());
+}
+
+void UHiddenActorIndexSubsystem::UnregisterHiddenActor(AHiddenActor* HiddenActor)
+{
+	HiddenActorGrid.Remove(HiddenActor);
+}
+
+void UHiddenActorIndexSubsystem::UpdateHiddenActor(AHiddenActor* HiddenActor)
+{
+	if (!HiddenActor || !HiddenActorGrid.Contains(HiddenActor))
+	{
+		return;
+	}
+
+	HiddenActorGrid.Add(HiddenActor, HiddenActor->GetActorLocation());
+}
+
+void UHiddenActorIndexSubsystem::QueryCone(const FVector& Origin, const FVector& Direction, const float Length,
+	const float BaseRadius, const float HalfAngleDegrees, TArray<AHiddenActor*>& OutHiddenActors)
+{
+	OutHiddenActors.Reset();
+	QueryScratch.Reset();
+
+	HiddenActorGrid.QueryCone(Origin, Direction, Length, BaseRadius, HalfAngleDegrees, QueryScratch);
+
+	// Only hidden actors ever get added to the grid so we don't need to cast
+	for (AActor* Actor : QueryScratch)
+	{
+		OutHiddenActors.Add(static_cast<AHiddenActor*>(Actor));
+	}
+}
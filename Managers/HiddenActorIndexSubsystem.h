@@ -0,0 +1,55 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorSpatialGrid.h"
+#include "HiddenActorIndexSubsystem.generated.h"
+
+// Forward declare our hidden actor
+class AHiddenActor;
+
+/**
+ * Per-world spatial index of every AHiddenActor.
+ * Hidden actors add themselves on BeginPlay and remove themselves on EndPlay,
+ * so the magnifying glass can find the ones in front of it by walking grid cells
+ * instead of sweeping the physics scene.
+ * Anything that moves a hidden actor after BeginPlay needs to call UpdateHiddenActor.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UHiddenActorIndexSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Adds a hidden actor to the index at its current location
+	void RegisterHiddenActor(AHiddenActor* HiddenActor);
+
+	// Removes a hidden actor from the index
+	void UnregisterHiddenActor(AHiddenActor* HiddenActor);
+
+	// Moves a hidden actor in the index to its current location, does nothing if it isn't registered
+	void UpdateHiddenActor(AHiddenActor* HiddenActor);
+
+	// Gathers every registered hidden actor inside the cone, see FActorSpatialGrid::QueryCone.
+	// OutHiddenActors is emptied first.
+	void QueryCone(const FVector& Origin, const FVector& Direction, const float Length, const float BaseRadius,
+		const float HalfAngleDegrees, TArray<AHiddenActor*>& OutHiddenActors);
+
+	// Number of hidden actors in the index
+	int32 GetNumHiddenActors() const { return HiddenActorGrid.Num(); }
+
+private:
+	// Side length of each grid cell. The magnifying glass' reveal is about 1150 long and 100 wide,
+	// so it walks 3 or 4 cells along its length and the cells stay small enough to hold few actors outside it
+	static constexpr float CellSize = 400.0f;
+
+	// Grid holding every registered hidden actor
+	FActorSpatialGrid HiddenActorGrid{ CellSize };
+
+	// Scratch array for cone queries so we don't allocate every reveal
+	TArray<AActor*> QueryScratch;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HoldInteractionSubsystem.h"
+
+#include "GameFramework/GameStateBase.h"
+#include "NetworkingPrototype/Components/HoldInteractionComponent.h"
+
+void UHoldInteractionSubsystem::Deinitialize()
+{
+	ActiveHolds.Empty();
+	TickScratch.Empty();
+
+	Super::Deinitialize();
+}
+
+void UHoldInteractionSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (ActiveHolds.Num() == 0)
+	{
+		return;
+	}
+
+	// Every hold shares the same clock and focus test timing this frame
+	const AGameStateBase* GameState = GetWorld()->GetGameState();
+	const float ServerTime = GameState ? GameState->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+
+	TimeUntilFocusCheck -= DeltaTime;
+	const bool bCheckFocus = TimeUntilFocusCheck <= 0.0f;
+	if (bCheckFocus)
+	{
+		TimeUntilFocusCheck = FocusCheckInterval;
+	}
+
+	// Drop holds that were destroyed without unregistering
+	ActiveHolds.RemoveAllSwap([](const TWeakObjectPtr<UHoldInteractionComponent>& Hold) { return !Hold.IsValid(); });
+
+	TickScratch = ActiveHolds;
+	for (const TWeakObjectPtr<UHoldInteractionComponent>& Hold : TickScratch)
+	{
+		if (UHoldInteractionComponent* HoldInteraction = Hold.Get())
+		{
+			HoldInteraction->TickHold(ServerTime, bCheckFocus);
+		}
+	}
+}
+
+TStatId UHoldInteractionSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UHoldInteractionSubsystem, STATGROUP_Tickables);
+}
+
+void UHoldInteractionSubsystem::RegisterActiveHold(UHoldInteractionComponent* HoldInteraction)
+{
+	if (HoldInteraction)
+	{
+		ActiveHolds.AddUnique(HoldInteraction);
+	}
+}
+
+void UHoldInteractionSubsystem::UnregisterActiveHold(UHoldInteractionComponent* HoldInteraction)
+{
+	ActiveHolds.RemoveSwap(HoldInteraction);
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "HoldInteractionSubsystem.generated.h"
+
+class UHoldInteractionComponent;
+
+/**
+ * Server side manager for every hold interaction that someone is currently holding.
+ * Components add themselves when the first player starts holding and remove themselves when the hold
+ * completes or is canceled. Each frame the subsystem checks every active hold for completion in one pass,
+ * and runs their focus tests at a lower rate, so no hold needs its own timer or tick.
+ * Idle holds cost nothing.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UHoldInteractionSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject implementation
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Starts ticking a hold that someone is holding
+	void RegisterActiveHold(UHoldInteractionComponent* HoldInteraction);
+
+	// Stops ticking a hold, does nothing if it isn't active
+	void UnregisterActiveHold(UHoldInteractionComponent* HoldInteraction);
+
+	// Number of holds being ticked
+	int32 GetNumActiveHolds() const { return ActiveHolds.Num(); }
+
+private:
+	// Every hold someone is currently holding
+	TArray<TWeakObjectPtr<UHoldInteractionComponent>> ActiveHolds;
+
+	// Copy of ActiveHolds to tick from, since holds remove themselves when they finish
+	TArray<TWeakObjectPtr<UHoldInteractionComponent>> TickScratch;
+
+	// How often holding players get their focus tested, in seconds
+	float FocusCheckInterval = 0.1f;
+
+	// Time until the next focus test
+	float TimeUntilFocusCheck = 0.0f;
+};
@@ -0,0 +1,331 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "InteractionFocusSubsystem.h"
+
+#include "InteractableInterface.h"
+#include "Components/SceneComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+void UInteractionFocusSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Pick up interactables spawned later and ones in streamed in levels
+	UWorld* World = GetWorld();
+	ActorSpawnedHandle = World->AddOnActorSpawnedHandler(
+		FOnActorSpawned::FDelegate::CreateUObject(this, &UInteractionFocusSubsystem::RegisterIfInteractable));
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UInteractionFocusSubsystem::OnLevelAddedToWorld);
+}
+
+void UInteractionFocusSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Interactables placed in the persistent level were never spawned, so add them here
+	OnLevelAddedToWorld(InWorld.PersistentLevel, &InWorld);
+}
+
+void UInteractionFocusSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	InteractableGrid.Empty();
+	Viewers.Empty();
+
+	Super::Deinitialize();
+}
+
+void UInteractionFocusSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (Viewers.Num() == 0)
+	{
+		return;
+	}
+
+	TimeUntilFocusUpdate -= DeltaTime;
+	if (TimeUntilFocusUpdate > 0.0f)
+	{
+		return;
+	}
+	TimeUntilFocusUpdate = FocusUpdateInterval;
+
+	// Drop viewers that were destroyed without unregistering
+	Viewers.RemoveAllSwap([](const FFocusViewer& Viewer) { return !Viewer.Pawn.IsValid(); });
+
+	for (FFocusViewer& Viewer : Viewers)
+	{
+		UpdateViewerFocus(Viewer);
+	}
+}
+
+TStatId UInteractionFocusSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UInteractionFocusSubsystem, STATGROUP_Tickables);
+}
+
+void UInteractionFocusSubsystem::RegisterInteractable(AActor* Interactable)
+{
+	if (!Interactable)
+	{
+		return;
+	}
+
+	// Follow the interactable around if it moves, EX: a physics pickup settling
+	if (USceneComponent* RootComponent = Interactable->GetRootComponent())
+	{
+		if (!InteractableGrid.Contains(Interactable))
+		{
+			RootComponent->TransformUpdated.AddUObject(this, &UInteractionFocusSubsystem::OnInteractableMoved);
+		}
+	}
+
+	// The grid only holds raw pointers, so never let it outlive the actor
+	Interactable->OnEndPlay.AddUniqueDynamic(this, &UInteractionFocusSubsystem::OnInteractableEndPlay);
+
+	InteractableGrid.Add(Interactable, Interactable->GetActorLocation());
+}
+
+void UInteractionFocusSubsystem::UnregisterInteractable(AActor* Interactable)
+{
+	if (Interactable && InteractableGrid.Contains(Interactable))
+	{
+		if (USceneComponent* RootComponent = Interactable->GetRootComponent())
+		{
+			RootComponent->TransformUpdated.RemoveAll(this);
+		}
+		Interactable->OnEndPlay.RemoveDynamic(this, &UInteractionFocusSubsystem::OnInteractableEndPlay);
+	}
+
+	InteractableGrid.Remove(Interactable);
+
+	// Anyone looking at it loses focus right away instead of on the next update
+	for (FFocusViewer& Viewer : Viewers)
+	{
+		if (Viewer.FocusedActor == Interactable)
+		{
+			SetFocus(Viewer, nullptr, FVector::ZeroVector);
+		}
+	}
+}
+
+void UInteractionFocusSubsystem::UpdateInteractable(AActor* Interactable)
+{
+	if (!Interactable || !InteractableGrid.Contains(Interactable))
+	{
+		return;
+	}
+
+	InteractableGrid.Add(Interactable, Interactable->GetActorLocation());
+}
+
+void UInteractionFocusSubsystem::RegisterViewer(APawn* Viewer, USceneComponent* ViewComponent,
+	const FInteractionFocusGained& OnFocusGained, const FInteractionFocusLost& OnFocusLost,
+	const FInteractionFocusMoved& OnFocusMoved)
+{
+	if (!Viewer || !ViewComponent)
+	{
+		return;
+	}
+
+	// Re-registering just swaps the view component and events
+	FFocusViewer* FocusViewer = Viewers.FindByPredicate([Viewer](const FFocusViewer& Other) { return Other.Pawn == Viewer; });
+	if (!FocusViewer)
+	{
+		FocusViewer = &Viewers.AddDefaulted_GetRef();
+		FocusViewer->Pawn = Viewer;
+	}
+
+	FocusViewer->ViewComponent = ViewComponent;
+	FocusViewer->OnFocusGained = OnFocusGained;
+	FocusViewer->OnFocusLost = OnFocusLost;
+	FocusViewer->OnFocusMoved = OnFocusMoved;
+}
+
+void UInteractionFocusSubsystem::UnregisterViewer(const APawn* Viewer)
+{
+	const int32 ViewerIdx = Viewers.IndexOfByPredicate([Viewer](const FFocusViewer& Other) { return Other.Pawn == Viewer; });
+	if (ViewerIdx == INDEX_NONE)
+	{
+		return;
+	}
+
+	SetFocus(Viewers[ViewerIdx], nullptr, FVector::ZeroVector);
+	Viewers.RemoveAtSwap(ViewerIdx);
+}
+
+AActor* UInteractionFocusSubsystem::GetFocusedActor(const APawn* Viewer) const
+{
+	const FFocusViewer* FocusViewer = Viewers.FindByPredicate([Viewer](const FFocusViewer& Other) { return Other.Pawn == Viewer; });
+	return FocusViewer ? FocusViewer->FocusedActor.Get() : nullptr;
+}
+
+void UInteractionFocusSubsystem::UpdateViewerFocus(FFocusViewer& Viewer)
+{
+	// Only the player looking through the camera cares what it's focused on
+	const APawn* Pawn = Viewer.Pawn.Get();
+	const USceneComponent* ViewComponent = Viewer.ViewComponent.Get();
+	if (!Pawn || !ViewComponent || !Pawn->IsLocallyControlled())
+	{
+		SetFocus(Viewer, nullptr, FVector::ZeroVector);
+		return;
+	}
+
+	const FVector ViewLocation = ViewComponent->GetComponentLocation();
+	const FVector ViewDirection = ViewComponent->GetForwardVector();
+
+	// Every interactable is in the index, so with nothing around to look at there's nothing to trace
+	const AActor* Candidate = FindBestCandidate(ViewLocation, ViewDirection);
+	if (!Candidate)
+	{
+		SetFocus(Viewer, nullptr, FVector::ZeroVector);
+		return;
+	}
+
+	// Make sure we can actually reach the best candidate and nothing is in the way
+	const FVector TraceEnd = ViewLocation + (Candidate->GetActorLocation() - ViewLocation).GetSafeNormal() * InteractRange;
+
+	FHitResult HitResult;
+	FCollisionQueryParams CollisionParams;
+	CollisionParams.AddIgnoredActor(Pawn);
+
+	// Whatever we hit can be the candidate, or another interactable in front of it
+	NumFocusTraces++;
+	if (GetWorld()->LineTraceSingleByChannel(HitResult, ViewLocation, TraceEnd, ECC_Visibility, CollisionParams)
+		&& IsFocusable(HitResult.GetActor()))
+	{
+		SetFocus(Viewer, HitResult.GetActor(), HitResult.Location);
+	}
+	else
+	{
+		SetFocus(Viewer, nullptr, FVector::ZeroVector);
+	}
+}
+
+AActor* UInteractionFocusSubsystem::FindBestCandidate(const FVector& ViewLocation, const FVector& ViewDirection) const
+{
+	const float SearchRadius = InteractRange + MaxInteractableExtent;
+	const float SearchRadiusSquared = SearchRadius * SearchRadius;
+	const FBox SearchBox = FBox(ViewLocation, ViewLocation).ExpandBy(SearchRadius);
+
+	AActor* BestCandidate = nullptr;
+	float BestScore = -1.0f;
+
+	InteractableGrid.ForEachInBox(SearchBox, [&](AActor* Actor, const FVector& Location)
+	{
+		const FVector ToActor = Location - ViewLocation;
+		const float DistanceSquared = ToActor.SizeSquared();
+		if (DistanceSquared > SearchRadiusSquared)
+		{
+			return;
+		}
+
+		const float Distance = FMath::Sqrt(DistanceSquared);
+		const float Dot = Distance > UE_KINDA_SMALL_NUMBER ? FVector::DotProduct(ToActor / Distance, ViewDirection) : 1.0f;
+		if (Dot < MinFocusDot)
+		{
+			return;
+		}
+
+		if (!IsFocusable(Actor))
+		{
+			return;
+		}
+
+		// Prefer whatever is closest to the center of the view, closer ones win near-ties
+		const float Score = Dot - 0.1f * (Distance / SearchRadius);
+		if (Score > BestScore)
+		{
+			BestScore = Score;
+			BestCandidate = Actor;
+		}
+	});
+
+	return BestCandidate;
+}
+
+bool UInteractionFocusSubsystem::IsFocusable(AActor* Actor)
+{
+	if (!Actor || Actor->IsHidden())
+	{
+		return false;
+	}
+
+	IInteractableInterface* InteractInterface = Cast<IInteractableInterface>(Actor);
+	return InteractInterface && InteractInterface->GetCanInteract();
+}
+
+void UInteractionFocusSubsystem::OnInteractableMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags,
+	ETeleportType Teleport)
+{
+	UpdateInteractable(UpdatedComponent ? UpdatedComponent->GetOwner() : nullptr);
+}
+
+void UInteractionFocusSubsystem::OnInteractableEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterInteractable(Actor);
+}
+
+void UInteractionFocusSubsystem::RegisterIfInteractable(AActor* Actor)
+{
+	if (Actor && Actor->GetClass()->ImplementsInterface(UInteractableInterface::StaticClass()))
+	{
+		RegisterInteractable(Actor);
+	}
+}
+
+void UInteractionFocusSubsystem::OnLevelAddedToWorld(ULevel* Level, UWorld* InWorld)
+{
+	if (!Level || InWorld != GetWorld())
+	{
+		return;
+	}
+
+	for (AActor* Actor : Level->Actors)
+	{
+		RegisterIfInteractable(Actor);
+	}
+}
+
+void UInteractionFocusSubsystem::SetFocus(FFocusViewer& Viewer, AActor* NewFocus, const FVector& FocusLocation)
+{
+	// Keep the old focus around even if it's been destroyed, so we still tell the viewer it was lost
+	const bool bHadFocus = !Viewer.FocusedActor.IsExplicitlyNull();
+	AActor* OldFocus = Viewer.FocusedActor.Get();
+
+	if (bHadFocus && OldFocus && OldFocus == NewFocus)
+	{
+		// Same interactable, but the popup has to follow the point we're looking at on it
+		if (!Viewer.FocusLocation.Equals(FocusLocation))
+		{
+			Viewer.FocusLocation = FocusLocation;
+			Viewer.OnFocusMoved.ExecuteIfBound(NewFocus, FocusLocation);
+		}
+		return;
+	}
+	if (!bHadFocus && !NewFocus)
+	{
+		return;
+	}
+
+	Viewer.FocusedActor = NewFocus;
+	Viewer.FocusLocation = FocusLocation;
+
+	if (bHadFocus)
+	{
+		Viewer.OnFocusLost.ExecuteIfBound(OldFocus);
+	}
+
+	if (NewFocus)
+	{
+		Viewer.OnFocusGained.ExecuteIfBound(NewFocus, FocusLocation);
+	}
+}
@@ -0,0 +1,140 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ActorSpatialGrid.h"
+#include "InteractionFocusSubsystem.generated.h"
+
+class USceneComponent;
+
+// Called when a viewer starts looking at an interactable, with the point on it they're looking at
+DECLARE_DELEGATE_TwoParams(FInteractionFocusGained, AActor* /*FocusedActor*/, const FVector& /*FocusLocation*/);
+
+// Called when a viewer stops looking at an interactable. The actor can be null if it was destroyed.
+DECLARE_DELEGATE_OneParam(FInteractionFocusLost, AActor* /*LostActor*/);
+
+// Called when a viewer keeps looking at the same interactable but at a different point on it
+DECLARE_DELEGATE_TwoParams(FInteractionFocusMoved, AActor* /*FocusedActor*/, const FVector& /*FocusLocation*/);
+
+/**
+ * Per-world index of interactable actors, and the focus tracker for locally controlled players.
+ * Every actor implementing IInteractableInterface is added when it's spawned or its level is added to the world,
+ * EX: doors and other interactables that never register themselves, and removed on EndPlay.
+ * Indexed interactables follow their root component when it moves.
+ * Viewers register with a view component (their camera) and get focus gained, moved and lost events,
+ * so they only touch their interaction widgets when what they're looking at changes.
+ * Each update only scores the interactables in the grid cells around a viewer by how close they are
+ * to the center of the view, and only the best one is traced to make sure nothing is in the way.
+ * A viewer with nothing interactable nearby costs one grid lookup and no trace.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UInteractionFocusSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// FTickableGameObject implementation
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Adds an interactable to the index at its current location, it's kept up to date as it moves
+	void RegisterInteractable(AActor* Interactable);
+
+	// Removes an interactable from the index
+	void UnregisterInteractable(AActor* Interactable);
+
+	// Moves an interactable in the index to its current location, does nothing if it isn't registered
+	void UpdateInteractable(AActor* Interactable);
+
+	// Starts tracking what a pawn is looking at through ViewComponent. Only locally controlled pawns get updated.
+	void RegisterViewer(APawn* Viewer, USceneComponent* ViewComponent,
+		const FInteractionFocusGained& OnFocusGained, const FInteractionFocusLost& OnFocusLost,
+		const FInteractionFocusMoved& OnFocusMoved = FInteractionFocusMoved());
+
+	// Stops tracking a pawn, it gets a focus lost event first if it was looking at something
+	void UnregisterViewer(const APawn* Viewer);
+
+	// The interactable a viewer is currently looking at, if any
+	AActor* GetFocusedActor(const APawn* Viewer) const;
+
+	// Number of interactables in the index
+	int32 GetNumInteractables() const { return InteractableGrid.Num(); }
+
+	// Number of focus traces run since the world started, for profiling and tests
+	int32 GetNumFocusTraces() const { return NumFocusTraces; }
+
+private:
+	// A pawn we track focus for
+	struct FFocusViewer
+	{
+		TWeakObjectPtr<APawn> Pawn;
+		TWeakObjectPtr<USceneComponent> ViewComponent;
+		TWeakObjectPtr<AActor> FocusedActor;
+		FVector FocusLocation = FVector::ZeroVector;
+		FInteractionFocusGained OnFocusGained;
+		FInteractionFocusLost OnFocusLost;
+		FInteractionFocusMoved OnFocusMoved;
+	};
+
+	// Finds what a viewer is looking at and raises events if it changed
+	void UpdateViewerFocus(FFocusViewer& Viewer);
+
+	// Best scoring interactable around the view, or nullptr if none are in the view cone
+	AActor* FindBestCandidate(const FVector& ViewLocation, const FVector& ViewDirection) const;
+
+	// Can a viewer focus this actor
+	static bool IsFocusable(AActor* Actor);
+
+	// Keeps a registered interactable's grid cell up to date when its root moves
+	void OnInteractableMoved(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	// Removes an interactable from the index when it ends play, destroyed or streamed out
+	UFUNCTION()
+	void OnInteractableEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+
+	// Adds the actor to the index if it implements IInteractableInterface
+	void RegisterIfInteractable(AActor* Actor);
+
+	// Adds every interactable in a level that was just added to our world
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* InWorld);
+
+	// Changes a viewer's focus, raising lost for the old one and gained for the new one
+	static void SetFocus(FFocusViewer& Viewer, AActor* NewFocus, const FVector& FocusLocation);
+
+	// Side length of each grid cell, a couple of interact ranges so a lookup walks a handful of cells
+	static constexpr float CellSize = 400.0f;
+
+	// Grid holding every registered interactable
+	FActorSpatialGrid InteractableGrid{ CellSize };
+
+	// Every registered viewer
+	TArray<FFocusViewer> Viewers;
+
+	// How far away players can interact from, measured from the view to the surface of the interactable
+	float InteractRange = 200.0f;
+
+	// Interactables are indexed by their pivot, so look this much further out for big ones like the coffin
+	float MaxInteractableExtent = 150.0f;
+
+	// Interactables further off the center of the view than this aren't candidates
+	float MinFocusDot = 0.8f;
+
+	// How often focus is updated, in seconds
+	float FocusUpdateInterval = 0.1f;
+
+	// Time until the next focus update
+	float TimeUntilFocusUpdate = 0.0f;
+
+	// Focus traces run since the world started
+	int32 NumFocusTraces = 0;
+
+	// Hooks that add interactables to the index as they show up
+	FDelegateHandle ActorSpawnedHandle;
+	FDelegateHandle LevelAddedHandle;
+};
@@ -0,0 +1,196 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemPoolSubsystem.h"
+
+#include "NetworkingPrototype/Characters/Item.h"
+#include "NetworkingPrototype/Characters/Pickup.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogItemPool);
+
+void UItemPoolSubsystem::Deinitialize()
+{
+	// The actors belong to the world and get cleaned up with it, just drop our refs
+	PooledItems.Empty();
+	PooledPickups.Empty();
+
+	Super::Deinitialize();
+}
+
+AItem* UItemPoolSubsystem::AcquireItem(TSubclassOf<AItem> ItemClass, AActor* NewOwner, const FTransform& Transform)
+{
+	if (!ItemClass || GetWorld()->IsNetMode(NM_Client))
+	{
+		return nullptr;
+	}
+
+	AItem* Item = Cast<AItem>(TakeFromPool(PooledItems, ItemClass));
+	if (!Item)
+	{
+		// Nothing parked for this item, spawn it like we used to
+		return Cast<AItem>(SpawnPoolActor(ItemClass, Transform, NewOwner));
+	}
+
+	Item->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+	Item->SetOwner(NewOwner);
+	Item->SetPooled(false);
+
+	UE_LOG(LogItemPool, Verbose, TEXT("Reused pooled item %s."), *Item->GetName());
+
+	return Item;
+}
+
+void UItemPoolSubsystem::ReleaseItem(AItem* Item)
+{
+	if (!Item || !Item->HasAuthority() || Item->IsPooled())
+	{
+		return;
+	}
+
+	// Let the item clean up anything it spawned or started while it was held
+	Item->OnReturnedToPool();
+
+	Item->SetOwner(nullptr);
+	Item->SetPooled(true);
+
+	if (!AddToPool(PooledItems, Item))
+	{
+		Item->Destroy();
+	}
+}
+
+APickup* UItemPoolSubsystem::AcquirePickup(TSubclassOf<APickup> PickupClass, const FTransform& Transform)
+{
+	if (!PickupClass || GetWorld()->IsNetMode(NM_Client))
+	{
+		return nullptr;
+	}
+
+	APickup* Pickup = Cast<APickup>(TakeFromPool(PooledPickups, PickupClass));
+	if (!Pickup)
+	{
+		// Nothing parked for this pickup, spawn it like we used to
+		return Cast<APickup>(SpawnPoolActor(PickupClass, Transform, nullptr));
+	}
+
+	Pickup->SetActorTransform(Transform, false, nullptr, ETeleportType::TeleportPhysics);
+	Pickup->SetPooled(false);
+
+	UE_LOG(LogItemPool, Verbose, TEXT("Reused pooled pickup %s."), *Pickup->GetName());
+
+	return Pickup;
+}
+
+void UItemPoolSubsystem::ReleasePickup(APickup* Pickup)
+{
+	if (!Pickup || !Pickup->HasAuthority() || Pickup->IsPooled())
+	{
+		return;
+	}
+
+	Pickup->SetPooled(true);
+
+	if (!AddToPool(PooledPickups, Pickup))
+	{
+		Pickup->Destroy();
+	}
+}
+
+void UItemPoolSubsystem::PrewarmItems(TSubclassOf<AItem> ItemClass, int32 Count)
+{
+	if (!ItemClass || GetWorld()->IsNetMode(NM_Client))
+	{
+		return;
+	}
+
+	const int32 NumToSpawn = FMath::Min(Count, MaxPooledPerClass - GetNumPooledItems(ItemClass));
+	for (int32 SpawnIdx = 0; SpawnIdx < NumToSpawn; SpawnIdx++)
+	{
+		AItem* Item = Cast<AItem>(SpawnPoolActor(ItemClass, FTransform::Identity, nullptr));
+		if (!Item)
+		{
+			return;
+		}
+
+		// Start out parked until a pickup hands it out
+		Item->SetPooled(true);
+		AddToPool(PooledItems, Item);
+	}
+
+	if (NumToSpawn > 0)
+	{
+		UE_LOG(LogItemPool, Log, TEXT("Prewarmed %d %s items."), NumToSpawn, *ItemClass->GetName());
+	}
+}
+
+int32 UItemPoolSubsystem::GetNumPooledItems(TSubclassOf<AItem> ItemClass) const
+{
+	const FPooledActorList* PooledList = PooledItems.Find(ItemClass.Get());
+	return PooledList ? PooledList->Actors.Num() : 0;
+}
+
+int32 UItemPoolSubsystem::GetNumPooledPickups(TSubclassOf<APickup> PickupClass) const
+{
+	const FPooledActorList* PooledList = PooledPickups.Find(PickupClass.Get());
+	return PooledList ? PooledList->Actors.Num() : 0;
+}
+
+AActor* UItemPoolSubsystem::TakeFromPool(TMap<UClass*, FPooledActorList>& Pool, UClass* Class)
+{
+	FPooledActorList* PooledList = Pool.Find(Class);
+	if (!PooledList)
+	{
+		return nullptr;
+	}
+
+	// Skip anything that got destroyed while it was parked
+	while (PooledList->Actors.Num() > 0)
+	{
+		AActor* Actor = PooledList->Actors.Pop(false);
+		if (IsValid(Actor))
+		{
+			// Reopen its channels so the changes we're about to make reach clients
+			Actor->SetNetDormancy(DORM_Awake);
+			return Actor;
+		}
+	}
+
+	return nullptr;
+}
+
+bool UItemPoolSubsystem::AddToPool(TMap<UClass*, FPooledActorList>& Pool, AActor* Actor)
+{
+	FPooledActorList& PooledList = Pool.FindOrAdd(Actor->GetClass());
+	if (PooledList.Actors.Num() >= MaxPooledPerClass)
+	{
+		return false;
+	}
+
+	PooledList.Actors.Add(Actor);
+
+	// The parked state still goes out before the channels go dormant, then nothing is sent until it's woken up
+	Actor->SetNetDormancy(DORM_DormantAll);
+	return true;
+}
+
+AActor* UItemPoolSubsystem::SpawnPoolActor(UClass* Class, const FTransform& Transform, AActor* Owner) const
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.Owner = Owner;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	AActor* Actor = World->SpawnActor<AActor>(Class, Transform, SpawnParams);
+	if (!Actor)
+	{
+		UE_LOG(LogItemPool, Error, TEXT("Failed to spawn %s!"), *GetNameSafe(Class));
+	}
+
+	return Actor;
+}
@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ItemPoolSubsystem.generated.h"
+
+// Forward declare our item actors
+class AItem;
+class APickup;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogItemPool, Log, All);
+
+// Dormant actors of one class waiting to be reused
+USTRUCT()
+struct FPooledActorList
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<AActor*> Actors;
+};
+
+/**
+ * Per-world pool of held items and pickups, server only.
+ * Picking an item up and dropping it again used to spawn one replicated actor and destroy another every time.
+ * Now the actor that isn't needed anymore is hidden, parked and put to sleep with net dormancy,
+ * so its channel goes dormant instead of being torn down, and the next pickup or drop of that class wakes it back up.
+ * Only up to MaxPooledPerClass actors of each class are kept, any past that are destroyed like before.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UItemPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Wakes up a pooled item of ItemClass, or spawns one if there isn't any, and gives it to NewOwner
+	AItem* AcquireItem(TSubclassOf<AItem> ItemClass, AActor* NewOwner, const FTransform& Transform);
+
+	// Puts an item nobody is holding anymore back in the pool
+	void ReleaseItem(AItem* Item);
+
+	// Wakes up a pooled pickup of PickupClass, or spawns one if there isn't any, and places it at Transform
+	APickup* AcquirePickup(TSubclassOf<APickup> PickupClass, const FTransform& Transform);
+
+	// Puts a pickup that has been picked up back in the pool
+	void ReleasePickup(APickup* Pickup);
+
+	// Spawns Count more pooled items of ItemClass ahead of time so the first pickups don't hitch.
+	// Never goes past MaxPooledPerClass.
+	void PrewarmItems(TSubclassOf<AItem> ItemClass, int32 Count);
+
+	// Number of items of ItemClass waiting in the pool
+	int32 GetNumPooledItems(TSubclassOf<AItem> ItemClass) const;
+
+	// Number of pickups of PickupClass waiting in the pool
+	int32 GetNumPooledPickups(TSubclassOf<APickup> PickupClass) const;
+
+	// Max number of pooled actors kept per class
+	static constexpr int32 MaxPooledPerClass = 4;
+
+private:
+	// Takes the newest actor of Class out of Pool and wakes it up, nullptr if there are none
+	AActor* TakeFromPool(TMap<UClass*, FPooledActorList>& Pool, UClass* Class);
+
+	// Adds an actor that has already been parked to Pool and lets it go dormant.
+	// Returns false if the pool for its class is full.
+	bool AddToPool(TMap<UClass*, FPooledActorList>& Pool, AActor* Actor);
+
+	// Spawns a new actor of Class that isn't in any pool yet
+	AActor* SpawnPoolActor(UClass* Class, const FTransform& Transform, AActor* Owner) const;
+
+	// Parked items by class
+	UPROPERTY()
+	TMap<UClass*, FPooledActorList> PooledItems;
+
+	// Parked pickups by class
+	UPROPERTY()
+	TMap<UClass*, FPooledActorList> PooledPickups;
+};
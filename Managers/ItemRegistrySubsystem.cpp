@@ -0,0 +1,182 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ItemRegistrySubsystem.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StreamableManager.h"
+#include "NetworkingPrototype/Characters/Item.h"
+#include "NetworkingPrototype/Characters/Pickup.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogItemRegistry);
+
+void UItemRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (ItemTable.IsNull())
+	{
+		UE_LOG(LogItemRegistry, Warning, TEXT("No item table set, the item registry is empty."));
+		return;
+	}
+
+	// The table itself is small, only what it points at is worth loading asynchronously
+	const UDataTable* Table = ItemTable.LoadSynchronous();
+	if (!Table || Table->GetRowStruct() != FItemRegistryRow::StaticStruct())
+	{
+		UE_LOG(LogItemRegistry, Error, TEXT("Item table %s is missing or doesn't use FItemRegistryRow!"), *ItemTable.ToString());
+		return;
+	}
+
+	BuildRegistry(Table);
+	PreloadAssets();
+}
+
+void UItemRegistrySubsystem::Deinitialize()
+{
+	if (PreloadHandle.IsValid())
+	{
+		PreloadHandle->CancelHandle();
+		PreloadHandle.Reset();
+	}
+
+	Items.Empty();
+
+	Super::Deinitialize();
+}
+
+const FItemRegistryRow* UItemRegistrySubsystem::FindItem(int32 ID) const
+{
+	if (!Items.IsValidIndex(ID) || Items[ID].ID == INDEX_NONE)
+	{
+		return nullptr;
+	}
+
+	return &Items[ID];
+}
+
+TSubclassOf<AItem> UItemRegistrySubsystem::GetItemClass(int32 ID) const
+{
+	const FItemRegistryRow* Row = FindItem(ID);
+	if (!Row)
+	{
+		return nullptr;
+	}
+
+	// Only loads here if the preload hasn't gotten to it yet
+	if (!Row->ItemClass.IsValid() && !Row->ItemClass.IsNull())
+	{
+		UE_LOG(LogItemRegistry, Warning, TEXT("Item %d was used before it finished preloading."), ID);
+		return Row->ItemClass.LoadSynchronous();
+	}
+
+	return Row->ItemClass.Get();
+}
+
+TSubclassOf<APickup> UItemRegistrySubsystem::GetPickupClass(int32 ID) const
+{
+	const FItemRegistryRow* Row = FindItem(ID);
+	if (!Row)
+	{
+		return nullptr;
+	}
+
+	// Only loads here if the preload hasn't gotten to it yet
+	if (!Row->PickupClass.IsValid() && !Row->PickupClass.IsNull())
+	{
+		UE_LOG(LogItemRegistry, Warning, TEXT("Pickup for item %d was used before it finished preloading."), ID);
+		return Row->PickupClass.LoadSynchronous();
+	}
+
+	return Row->PickupClass.Get();
+}
+
+bool UItemRegistrySubsystem::IsPreloadComplete() const
+{
+	return !PreloadHandle.IsValid() || PreloadHandle->HasLoadCompleted();
+}
+
+void UItemRegistrySubsystem::BuildRegistry(const UDataTable* Table)
+{
+	Items.Reset();
+
+	Table->ForeachRow<FItemRegistryRow>(TEXT("BuildRegistry"), [this](const FName& RowName, const FItemRegistryRow& Row)
+	{
+		if (Row.ID < 0)
+		{
+			UE_LOG(LogItemRegistry, Error, TEXT("Item row %s has no ID, skipping it!"), *RowName.ToString());
+			return;
+		}
+
+		// Grow the array to fit the ID, the gaps are left as empty rows
+		if (Row.ID >= Items.Num())
+		{
+			Items.SetNum(Row.ID + 1);
+		}
+
+		if (Items[Row.ID].ID != INDEX_NONE)
+		{
+			UE_LOG(LogItemRegistry, Error, TEXT("Item row %s uses ID %d which is already taken, skipping it!"),
+				*RowName.ToString(), Row.ID);
+			return;
+		}
+
+		Items[Row.ID] = Row;
+	});
+
+	UE_LOG(LogItemRegistry, Log, TEXT("Item registry built with %d IDs."), Items.Num());
+}
+
+void UItemRegistrySubsystem::PreloadAssets()
+{
+	TArray<FSoftObjectPath> AssetsToLoad;
+	for (const FItemRegistryRow& Row : Items)
+	{
+		if (Row.ID == INDEX_NONE)
+		{
+			continue;
+		}
+
+		AssetsToLoad.AddUnique(Row.ItemClass.ToSoftObjectPath());
+		AssetsToLoad.AddUnique(Row.PickupClass.ToSoftObjectPath());
+		AssetsToLoad.AddUnique(Row.Mesh.ToSoftObjectPath());
+		for (const TSoftObjectPtr<UObject>& Asset : Row.PreloadAssets)
+		{
+			AssetsToLoad.AddUnique(Asset.ToSoftObjectPath());
+		}
+	}
+
+	AssetsToLoad.RemoveAll([](const FSoftObjectPath& Path) { return Path.IsNull(); });
+	if (AssetsToLoad.Num() == 0)
+	{
+		return;
+	}
+
+	PreloadHandle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetsToLoad,
+		FStreamableDelegate::CreateUObject(this, &UItemRegistrySubsystem::ValidateItemClasses),
+		FStreamableManager::AsyncLoadHighPriority, true);
+}
+
+void UItemRegistrySubsystem::ValidateItemClasses() const
+{
+	for (const FItemRegistryRow& Row : Items)
+	{
+		const UClass* ItemClass = Row.ItemClass.Get();
+		if (Row.ID == INDEX_NONE || !ItemClass)
+		{
+			continue;
+		}
+
+		// Item classes still set their ID in their constructor, make sure the table agrees
+		AItem* ItemCDO = ItemClass->GetDefaultObject<AItem>();
+		if (ItemCDO && ItemCDO->GetItemID() != Row.ID)
+		{
+			UE_LOG(LogItemRegistry, Error, TEXT("%s has ID %d but is registered under ID %d!"),
+				*ItemClass->GetName(), ItemCDO->GetItemID(), Row.ID);
+		}
+	}
+
+	UE_LOG(LogItemRegistry, Log, TEXT("Item registry finished preloading."));
+}
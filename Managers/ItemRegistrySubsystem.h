@@ -0,0 +1,92 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataTable.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ItemRegistrySubsystem.generated.h"
+
+// Forward declare our item actors
+class AItem;
+class APickup;
+class UStaticMesh;
+struct FStreamableHandle;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogItemRegistry, Log, All);
+
+// One row of the item table, everything that belongs to a single item ID
+USTRUCT(BlueprintType)
+struct FItemRegistryRow : public FTableRowBase
+{
+	GENERATED_BODY()
+
+	// Item ID, has to match the ID the item class sets and be unique in the table
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item", meta = (ClampMin = "0"))
+	int32 ID = INDEX_NONE;
+
+	// Item players hold once it's picked up
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+	TSoftClassPtr<AItem> ItemClass;
+
+	// Pickup placed in the world when the item is dropped
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+	TSoftClassPtr<APickup> PickupClass;
+
+	// Mesh used to show the item outside of its actors, EX: in menus
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+	TSoftObjectPtr<UStaticMesh> Mesh;
+
+	// Anything else the item needs loaded before it's first used, EX: sounds and materials it swaps to
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item")
+	TArray<TSoftObjectPtr<UObject>> PreloadAssets;
+};
+
+/**
+ * Registry of every item, built once from ItemTable when the game instance starts.
+ * Rows are stored in an array indexed by item ID so looking an item up is a single array access.
+ * Every class and asset the table references is loaded asynchronously right away and kept loaded,
+ * so the first pickup or drop of an item doesn't hitch on a synchronous load.
+ */
+UCLASS(Config = Game)
+class NETWORKINGPROTOTYPE_API UItemRegistrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Row for this item ID, nullptr if there isn't one
+	const FItemRegistryRow* FindItem(int32 ID) const;
+
+	// Item class for this item ID, nullptr if there isn't one
+	TSubclassOf<AItem> GetItemClass(int32 ID) const;
+
+	// Pickup class for this item ID, nullptr if there isn't one
+	TSubclassOf<APickup> GetPickupClass(int32 ID) const;
+
+	// Has everything the table references finished loading
+	bool IsPreloadComplete() const;
+
+private:
+	// Fills Items from the table, skipping rows with a bad or duplicate ID
+	void BuildRegistry(const UDataTable* Table);
+
+	// Starts loading every class and asset the registry references
+	void PreloadAssets();
+
+	// Checks every loaded item class sets the same ID as its row
+	void ValidateItemClasses() const;
+
+	// Table to build the registry from, set under [/Script/NetworkingPrototype.ItemRegistrySubsystem] in DefaultGame.ini
+	UPROPERTY(Config)
+	TSoftObjectPtr<UDataTable> ItemTable;
+
+	// Rows indexed by item ID, IDs without a row have an ID of INDEX_NONE
+	TArray<FItemRegistryRow> Items;
+
+	// Keeps the preloaded assets in memory for as long as the registry is around
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+};
@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PhoneAudioCacheSubsystem.h"
+
+#include "Engine/AssetManager.h"
+#include "NetworkingPrototype/Public/PlayerPhone.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogPhoneAudioCache);
+
+void UPhoneAudioCacheSubsystem::Deinitialize()
+{
+	for (TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>>& AssetHandle : AssetHandles)
+	{
+		if (AssetHandle.Value.IsValid())
+		{
+			AssetHandle.Value->ReleaseHandle();
+		}
+	}
+	AssetHandles.Empty();
+
+	Super::Deinitialize();
+}
+
+void UPhoneAudioCacheSubsystem::PreloadPhoneAudio(TSubclassOf<APlayerPhone> PhoneClass)
+{
+	if (!PhoneClass)
+	{
+		return;
+	}
+
+	TArray<FSoftObjectPath> PhoneAssets;
+	PhoneClass->GetDefaultObject<APlayerPhone>()->GetPhoneAudioAssets(PhoneAssets);
+	RequestAssets(PhoneAssets);
+}
+
+void UPhoneAudioCacheSubsystem::RequestAssets(const TArray<FSoftObjectPath>& Assets, FStreamableDelegate OnLoaded)
+{
+	TArray<FSoftObjectPath> AssetsToLoad;
+	bool bAllCached = true;
+	for (const FSoftObjectPath& Asset : Assets)
+	{
+		if (Asset.IsNull())
+		{
+			continue;
+		}
+
+		AssetsToLoad.AddUnique(Asset);
+		bAllCached &= AssetHandles.Contains(Asset) && Asset.ResolveObject() != nullptr;
+	}
+
+	// Everything is already in memory and held by us
+	if (bAllCached)
+	{
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	// Assets that are already loaded or loading get merged into this request by the streamable manager
+	const TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(AssetsToLoad, OnLoaded);
+
+	int32 NumNewAssets = 0;
+	for (const FSoftObjectPath& Asset : AssetsToLoad)
+	{
+		if (!AssetHandles.Contains(Asset))
+		{
+			AssetHandles.Add(Asset, Handle);
+			NumNewAssets++;
+		}
+	}
+
+	if (NumNewAssets > 0)
+	{
+		UE_LOG(LogPhoneAudioCache, Log, TEXT("Streaming in %d phone audio assets."), NumNewAssets);
+	}
+}
@@ -0,0 +1,44 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/StreamableManager.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "PhoneAudioCacheSubsystem.generated.h"
+
+// Forward declare our phone
+class APlayerPhone;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogPhoneAudioCache, Log, All);
+
+/**
+ * Shared cache for phone sounds and Wwise events.
+ * Phones only soft reference their audio, so nothing is loaded with the character.
+ * The first phone that needs a sound streams it in asynchronously through here,
+ * and it stays loaded for every other phone until the game instance shuts down.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UPhoneAudioCacheSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Starts loading every sound and Wwise event PhoneClass uses, EX: while a loading screen is up
+	UFUNCTION(BlueprintCallable, Category = "Audio")
+	void PreloadPhoneAudio(TSubclassOf<APlayerPhone> PhoneClass);
+
+	// Starts loading any of Assets that aren't loaded yet and keeps them loaded.
+	// OnLoaded runs once all of them are, right away if they already are.
+	void RequestAssets(const TArray<FSoftObjectPath>& Assets, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	// Number of assets the cache is keeping loaded or loading
+	int32 GetNumCachedAssets() const { return AssetHandles.Num(); }
+
+private:
+	// Load handle for every asset we've been asked for, keeps them in memory
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> AssetHandles;
+};
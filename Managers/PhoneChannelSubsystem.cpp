@@ -0,0 +1,132 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PhoneChannelSubsystem.h"
+
+#include "NetworkingPrototype/Public/PlayerPhone.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogPhoneChannels);
+
+void UPhoneChannelSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Hand out every channel except the reserved ones, lowest first
+	FreeChannels.Reserve(NumPhoneChannels);
+	for (int32 Channel = ProximityChannel + 1; FreeChannels.Num() < NumPhoneChannels; Channel++)
+	{
+		if (Channel != GhostChannel)
+		{
+			FreeChannels.Insert(Channel, 0);
+		}
+	}
+}
+
+void UPhoneChannelSubsystem::Deinitialize()
+{
+	FreeChannels.Empty();
+	ChannelPhones.Empty();
+	PhoneChannels.Empty();
+
+	Super::Deinitialize();
+}
+
+int32 UPhoneChannelSubsystem::AllocateChannel(APlayerPhone* CallerPhone, APlayerPhone* ReceiverPhone)
+{
+	if (!CallerPhone || !ReceiverPhone)
+	{
+		return INDEX_NONE;
+	}
+
+	// Phones that got destroyed mid call never release their channel, get those back before giving up
+	if (FreeChannels.Num() == 0)
+	{
+		ReclaimAbandonedChannels();
+	}
+
+	if (FreeChannels.Num() == 0)
+	{
+		UE_LOG(LogPhoneChannels, Warning, TEXT("Every phone channel is taken! Wait for one to be free."));
+		return INDEX_NONE;
+	}
+
+	// Neither phone should still be in an old channel
+	ReleasePhone(CallerPhone);
+	ReleasePhone(ReceiverPhone);
+
+	const int32 Channel = FreeChannels.Pop(EAllowShrinking::No);
+
+	TArray<TWeakObjectPtr<const APlayerPhone>, TInlineAllocator<2>>& Phones = ChannelPhones.Add(Channel);
+	Phones.Add(CallerPhone);
+	Phones.Add(ReceiverPhone);
+
+	PhoneChannels.Add(CallerPhone, Channel);
+	PhoneChannels.Add(ReceiverPhone, Channel);
+
+	UE_LOG(LogPhoneChannels, Log, TEXT("Phone channel %d allocated, %d channels left."), Channel, FreeChannels.Num());
+	return Channel;
+}
+
+void UPhoneChannelSubsystem::ReleasePhone(const APlayerPhone* Phone)
+{
+	int32 Channel = INDEX_NONE;
+	if (!PhoneChannels.RemoveAndCopyValue(Phone, Channel))
+	{
+		return;
+	}
+
+	TArray<TWeakObjectPtr<const APlayerPhone>, TInlineAllocator<2>>* Phones = ChannelPhones.Find(Channel);
+	if (!Phones)
+	{
+		return;
+	}
+
+	// Also drop anyone in the channel who was destroyed without leaving
+	Phones->RemoveAllSwap([Phone](const TWeakObjectPtr<const APlayerPhone>& ChannelPhone)
+	{
+		return !ChannelPhone.IsValid() || ChannelPhone == Phone;
+	});
+
+	// Last one out frees the channel
+	if (Phones->Num() == 0)
+	{
+		ChannelPhones.Remove(Channel);
+		FreeChannels.Push(Channel);
+
+		UE_LOG(LogPhoneChannels, Log, TEXT("Phone channel %d freed, %d channels left."), Channel, FreeChannels.Num());
+	}
+}
+
+int32 UPhoneChannelSubsystem::GetPhoneChannel(const APlayerPhone* Phone) const
+{
+	const int32* Channel = PhoneChannels.Find(Phone);
+	return Channel ? *Channel : INDEX_NONE;
+}
+
+void UPhoneChannelSubsystem::BroadcastLineBusy(APlayerPhone* CallerPhone, const E_PhoneLineBusyReason Reason)
+{
+	OnLineBusy.Broadcast(CallerPhone, Reason);
+}
+
+void UPhoneChannelSubsystem::ReclaimAbandonedChannels()
+{
+	for (auto It = ChannelPhones.CreateIterator(); It; ++It)
+	{
+		It->Value.RemoveAllSwap([](const TWeakObjectPtr<const APlayerPhone>& ChannelPhone) { return !ChannelPhone.IsValid(); });
+
+		if (It->Value.Num() == 0)
+		{
+			FreeChannels.Push(It->Key);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = PhoneChannels.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
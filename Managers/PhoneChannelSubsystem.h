@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PhoneChannelSubsystem.generated.h"
+
+class APlayerPhone;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogPhoneChannels, Log, All);
+
+// Why a call couldn't go through
+UENUM(BlueprintType)
+enum class E_PhoneLineBusyReason : uint8
+{
+	// The caller or the player being called is already in a call
+	InCall UMETA(DisplayName = "In Call"),
+	// Every phone channel is being used by another call
+	NoFreeChannel UMETA(DisplayName = "No Free Channel")
+};
+
+// Called on the server when a call can't go through
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnPhoneLineBusy, APlayerPhone* /*CallerPhone*/, E_PhoneLineBusyReason /*Reason*/);
+
+/**
+ * Server side allocator for the voice channels phone calls use.
+ * Free channels sit on a free list, so starting and ending a call never scans the voice chat talkers.
+ * Tracks which phones are in which channel, and a channel goes back on the free list once its last phone leaves.
+ * Channels used for proximity chat and the ghost channel are never handed out.
+ */
+UCLASS()
+class NETWORKINGPROTOTYPE_API UPhoneChannelSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Takes a free channel for a call between the two phones.
+	// Returns the channel, or INDEX_NONE if every channel is taken.
+	int32 AllocateChannel(APlayerPhone* CallerPhone, APlayerPhone* ReceiverPhone);
+
+	// Takes a phone out of its channel, freeing the channel if nobody is left in it
+	void ReleasePhone(const APlayerPhone* Phone);
+
+	// The channel a phone is in, or INDEX_NONE
+	int32 GetPhoneChannel(const APlayerPhone* Phone) const;
+
+	// Number of channels that aren't being used by a call
+	int32 GetNumFreeChannels() const { return FreeChannels.Num(); }
+
+	// Tells listeners a call couldn't go through
+	void BroadcastLineBusy(APlayerPhone* CallerPhone, const E_PhoneLineBusyReason Reason);
+
+	// Called on the server when a call can't go through
+	FOnPhoneLineBusy OnLineBusy;
+
+private:
+	// Puts channels whose phones have all been destroyed back on the free list
+	void ReclaimAbandonedChannels();
+
+	// Number of channels handed out to phone calls, so this many calls can happen at once
+	static constexpr int32 NumPhoneChannels = 8;
+
+	// Channels the voice chat uses for other things
+	static constexpr int32 ProximityChannel = 0;
+	static constexpr int32 GhostChannel = 3;
+
+	// Channels nobody is using, the last one is handed out next
+	TArray<int32> FreeChannels;
+
+	// Phones in each channel that's in use
+	TMap<int32, TArray<TWeakObjectPtr<const APlayerPhone>, TInlineAllocator<2>>> ChannelPhones;
+
+	// Channel each phone in a call is in
+	TMap<TWeakObjectPtr<const APlayerPhone>, int32> PhoneChannels;
+};
@@ -3,14 +3,19 @@
 
 #include "SoundManager.h"
 
-#include "Kismet/GameplayStatics.h"
-#include "NetworkingPrototype/Ghost/GhostAIController.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Character.h"
+
+// Define the log category
+DEFINE_LOG_CATEGORY(LogSoundManager);
 
 // Sets default values
 ASoundManager::ASoundManager()
 {
  	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
-	PrimaryActorTick.bCanEverTick = false;
+	// Only ticks on the server, to drain the sound event queue
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
 
 }
 
@@ -21,32 +26,246 @@ void ASoundManager::RegisterSoundEvent(const FSoundEvent& SoundEvent)
 		return;
 	}
 
-	// Store the sound event passed in
-	SoundEvents.Add(SoundEvent);
+	if (SoundEvents.Num() == 0)
+	{
+		UE_LOG(LogSoundManager, Warning, TEXT("Sound event from %s dropped, %s hasn't been initialized yet!"),
+			*GetNameSafe(SoundEvent.Character), *GetName());
+		return;
+	}
 
-	// Notify AI about the new sound
-	NotifyAI();
+	// If this character already has the same kind of sound queued, merge into it
+	// instead of queuing another one. Keep the loudest intensity and the latest location.
+	if (SoundEvent.Character)
+	{
+		for (int32 QueueIdx = 0; QueueIdx < NumQueuedSoundEvents; QueueIdx++)
+		{
+			FSoundEvent& QueuedEvent = SoundEvents[(SoundEventsHead + QueueIdx) % SoundEvents.Num()];
+			if (QueuedEvent.Character == SoundEvent.Character && QueuedEvent.SoundType == SoundEvent.SoundType)
+			{
+				QueuedEvent.Location = SoundEvent.Location;
+				QueuedEvent.Intensity = FMath::Max(QueuedEvent.Intensity, SoundEvent.Intensity);
+				return;
+			}
+		}
+	}
+
+	// Store the sound event passed in, it goes out next tick
+	EnqueueSoundEvent(SoundEvent);
+}
+
+void ASoundManager::RegisterSoundEventByName(ACharacter* Character, FVector Location, float Intensity,
+	const FString& SoundType)
+{
+	const int64 SoundTypeValue = StaticEnum<E_SoundEventType>()->GetValueByNameString(SoundType);
+	if (SoundTypeValue == INDEX_NONE || SoundTypeValue == static_cast<int64>(E_SoundEventType::Count))
+	{
+		UE_LOG(LogSoundManager, Warning, TEXT("RegisterSoundEventByName was passed unknown sound type \"%s\"!"), *SoundType);
+		return;
+	}
+
+	FSoundEvent SoundEvent;
+	SoundEvent.Character = Character;
+	SoundEvent.Location = Location;
+	SoundEvent.Intensity = Intensity;
+	SoundEvent.SoundType = static_cast<E_SoundEventType>(SoundTypeValue);
+	RegisterSoundEvent(SoundEvent);
 }
 
 void ASoundManager::NotifyAI()
 {
-	for (AActor* AIActor : RegisteredAIActors)
+	if (NumQueuedSoundEvents == 0)
 	{
-		if (AIActor)
+		return;
+	}
+
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+
+	// Only go through what was queued when we started, held events get pushed to the back
+	const int32 NumToProcess = NumQueuedSoundEvents;
+	for (int32 ProcessIdx = 0; ProcessIdx < NumToProcess; ProcessIdx++)
+	{
+		// Pop the oldest event
+		const FSoundEvent Event = SoundEvents[SoundEventsHead];
+		SoundEventsHead = (SoundEventsHead + 1) % SoundEvents.Num();
+		NumQueuedSoundEvents--;
+
+		// Leave repeats in the queue until their coalesce window is up
+		if (ShouldHoldSoundEvent(Event, CurrentTime))
 		{
-			AGhostAIController* GhostAIController = Cast<AGhostAIController>(AIActor);
-			if (GhostAIController)
-			{
-				for (const FSoundEvent& Event : SoundEvents)
-				{
-					GhostAIController->ProcessSoundEvent(Event);
-				}
-			}
+			EnqueueSoundEvent(Event);
+			continue;
 		}
+
+		NotifyAIOfSoundEvent(Event);
+		RecordNotifiedSoundEvent(Event, CurrentTime);
 	}
+}
 
-	// Clear sound events after processing
-	SoundEvents.Empty();
+void ASoundManager::RegisterSoundHandler(AController* Listener, const E_SoundEventType SoundType,
+	const FSoundEventHandler& Handler)
+{
+	if (!Listener || SoundType == E_SoundEventType::None || SoundType == E_SoundEventType::Count)
+	{
+		UE_LOG(LogSoundManager, Warning, TEXT("RegisterSoundHandler was passed an invalid listener or sound type!"));
+		return;
+	}
+
+	FSoundListener* FoundListener = SoundListeners.FindByPredicate([Listener](const FSoundListener& SoundListener)
+	{
+		return SoundListener.Controller == Listener;
+	});
+
+	if (!FoundListener)
+	{
+		FoundListener = &SoundListeners.AddDefaulted_GetRef();
+		FoundListener->Controller = Listener;
+	}
+
+	FoundListener->Handlers[static_cast<uint8>(SoundType)] = Handler;
+}
+
+void ASoundManager::UnregisterSoundHandlers(const AController* Listener)
+{
+	SoundListeners.RemoveAllSwap([Listener](const FSoundListener& SoundListener)
+	{
+		return SoundListener.Controller == Listener;
+	});
+}
+
+void ASoundManager::NotifyAIOfSoundEvent(const FSoundEvent& SoundEvent)
+{
+	const uint8 HandlerIdx = static_cast<uint8>(SoundEvent.SoundType);
+	if (HandlerIdx >= static_cast<uint8>(E_SoundEventType::Count))
+	{
+		return;
+	}
+
+	const float MaxHearingDistanceSquared = MaxHearingDistance * MaxHearingDistance;
+
+	for (const FSoundListener& SoundListener : SoundListeners)
+	{
+		// Skip listeners that don't care about this type of sound before doing any distance math
+		const FSoundEventHandler& Handler = SoundListener.Handlers[HandlerIdx];
+		if (!Handler.IsBound())
+		{
+			continue;
+		}
+
+		const AController* Controller = SoundListener.Controller.Get();
+		const APawn* ControlledPawn = Controller ? Controller->GetPawn() : nullptr;
+		if (!ControlledPawn)
+		{
+			continue;
+		}
+
+		// Cull AI that are too far away to hear anything
+		const float DistanceSquared = FVector::DistSquared(ControlledPawn->GetActorLocation(), SoundEvent.Location);
+		if (DistanceSquared > MaxHearingDistanceSquared)
+		{
+			continue;
+		}
+
+		// Fade the sound out linearly over the hearing distance, and cull it if it's too quiet by the time it arrives
+		const float Attenuation = 1.0f - FMath::Sqrt(DistanceSquared) / MaxHearingDistance;
+		const float HeardIntensity = SoundEvent.Intensity * Attenuation;
+		if (HeardIntensity < MinAudibleIntensity)
+		{
+			continue;
+		}
+
+		// Pass along the sound as this AI hears it
+		FSoundEvent HeardEvent = SoundEvent;
+		HeardEvent.Intensity = HeardIntensity;
+		Handler.Execute(HeardEvent);
+	}
+}
+
+void ASoundManager::EnqueueSoundEvent(const FSoundEvent& SoundEvent)
+{
+	const int32 Capacity = SoundEvents.Num();
+
+	// Drop the oldest event to make room
+	if (NumQueuedSoundEvents == Capacity)
+	{
+		SoundEventsHead = (SoundEventsHead + 1) % Capacity;
+		NumQueuedSoundEvents--;
+
+		UE_LOG(LogSoundManager, Verbose, TEXT("Sound event queue is full, dropping the oldest event."));
+	}
+
+	SoundEvents[(SoundEventsHead + NumQueuedSoundEvents) % Capacity] = SoundEvent;
+	NumQueuedSoundEvents++;
+}
+
+bool ASoundManager::ShouldHoldSoundEvent(const FSoundEvent& SoundEvent, const float CurrentTime) const
+{
+	// Sounds without a character can't be coalesced
+	if (!SoundEvent.Character)
+	{
+		return false;
+	}
+
+	for (const FSoundCoalesceState& State : CoalesceStates)
+	{
+		if (State.Character == SoundEvent.Character && State.SoundType == SoundEvent.SoundType)
+		{
+			// Hold quieter or equal repeats until the window is up, let louder ones through
+			return CurrentTime - State.LastNotifyTime < CoalesceWindow
+				&& SoundEvent.Intensity <= State.LastNotifyIntensity;
+		}
+	}
+
+	return false;
+}
+
+void ASoundManager::RecordNotifiedSoundEvent(const FSoundEvent& SoundEvent, const float CurrentTime)
+{
+	if (!SoundEvent.Character)
+	{
+		return;
+	}
+
+	FSoundCoalesceState* FoundState = nullptr;
+	for (int32 StateIdx = CoalesceStates.Num() - 1; StateIdx >= 0; StateIdx--)
+	{
+		FSoundCoalesceState& State = CoalesceStates[StateIdx];
+
+		// Drop states for characters that are gone
+		if (!State.Character.IsValid())
+		{
+			CoalesceStates.RemoveAtSwap(StateIdx, 1, false);
+			continue;
+		}
+
+		if (State.Character == SoundEvent.Character && State.SoundType == SoundEvent.SoundType)
+		{
+			FoundState = &State;
+		}
+	}
+
+	if (!FoundState)
+	{
+		FoundState = &CoalesceStates.AddDefaulted_GetRef();
+		FoundState->Character = SoundEvent.Character;
+		FoundState->SoundType = SoundEvent.SoundType;
+	}
+
+	FoundState->LastNotifyTime = CurrentTime;
+	FoundState->LastNotifyIntensity = SoundEvent.Intensity;
+}
+
+void ASoundManager::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// Server only
+	if (HasAuthority())
+	{
+		// Size the ring once so queuing events never allocates
+		SoundEvents.SetNum(FMath::Max(1, MaxQueuedSoundEvents));
+		SoundEventsHead = 0;
+		NumQueuedSoundEvents = 0;
+	}
 }
 
 // Called when the game starts or when spawned
@@ -54,10 +273,10 @@ void ASoundManager::BeginPlay()
 {
 	Super::BeginPlay();
 
-	// Server only
+	// Server only. Drain the sound event queue every tick, starting with anything queued before play began
 	if (HasAuthority())
 	{
-		RegisterAIActors();
+		SetActorTickEnabled(true);
 	}
 }
 
@@ -66,11 +285,5 @@ void ASoundManager::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
+	NotifyAI();
 }
-
-void ASoundManager::RegisterAIActors()
-{
-	// Find all Ghost AI actors in the world
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AGhostAIController::StaticClass(), RegisteredAIActors);
-}
-
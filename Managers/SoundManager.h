@@ -6,7 +6,24 @@
 #include "GameFramework/Actor.h"
 #include "SoundManager.generated.h"
 
+class AController;
+
+// Declare the log category
+DECLARE_LOG_CATEGORY_EXTERN(LogSoundManager, Log, All);
+
+// Kinds of sounds the AI can hear
+UENUM(BlueprintType)
+enum class E_SoundEventType : uint8
+{
+	None UMETA(DisplayName = "None"),
+	Voice UMETA(DisplayName = "Voice"),
+	Footstep UMETA(DisplayName = "Footstep"),
+	// Number of sound types, keep last
+	Count UMETA(Hidden)
+};
+
 // Struct to store sound data
+// Kept trivially copyable so queued events are a flat copy
 USTRUCT(BlueprintType)
 struct FSoundEvent
 {
@@ -23,13 +40,25 @@ struct FSoundEvent
 	float Intensity;
 
 	UPROPERTY(BlueprintReadWrite)
-	FString SoundType;
+	E_SoundEventType SoundType;
 
 	// Default constructor
 	FSoundEvent()
-		: Character(nullptr), Location(FVector::ZeroVector), Intensity(0.0f), SoundType(TEXT("None")) {}
+		: Character(nullptr), Location(FVector::ZeroVector), Intensity(0.0f), SoundType(E_SoundEventType::None) {}
 };
 
+static_assert(std::is_trivially_copyable_v<FSoundEvent>, "FSoundEvent is copied around the sound queue, keep it trivially copyable");
+
+// Called with a sound event as a listener hears it
+DECLARE_DELEGATE_OneParam(FSoundEventHandler, const FSoundEvent&);
+
+/**
+ * Server side queue of sound events the ghosts can hear.
+ * Events are queued as they come in and drained once per tick. Each queued event only
+ * reaches the ghosts close enough to hear it, with its intensity attenuated by distance.
+ * Repeated events of the same type from the same character are merged within CoalesceWindow.
+ * Listeners register a handler per sound type, and only hear the types they have a handler for.
+ */
 UCLASS()
 class NETWORKINGPROTOTYPE_API ASoundManager : public AActor
 {
@@ -39,14 +68,29 @@ public:
 	// Sets default values for this actor's properties
 	ASoundManager();
 
-	// Add a sound event to be processed
+	// Queue a sound event to be processed next tick
 	UFUNCTION(BlueprintCallable, Category = "Sound")
 	void RegisterSoundEvent(const FSoundEvent& SoundEvent);
 
-	// Notify AI of sound events
+	// Queue a sound event by the name of its type, EX: "Voice" or "Footstep", for blueprints that
+	// still pass the sound type as a string. Unknown names are logged and dropped.
+	UFUNCTION(BlueprintCallable, Category = "Sound")
+	void RegisterSoundEventByName(ACharacter* Character, FVector Location, float Intensity, const FString& SoundType);
+
+	// Notify AI of queued sound events, called once per tick on the server
 	void NotifyAI();
 
+	// Register a handler for a type of sound. The listener hears sounds from its pawn's location.
+	// Registering the same type again replaces the old handler.
+	void RegisterSoundHandler(AController* Listener, const E_SoundEventType SoundType, const FSoundEventHandler& Handler);
+
+	// Remove every handler a listener registered
+	void UnregisterSoundHandlers(const AController* Listener);
+
 protected:
+	// Sizes the sound event queue, before any actor's BeginPlay so events registered from there aren't lost
+	virtual void PostInitializeComponents() override;
+
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
@@ -55,13 +99,64 @@ public:
 	virtual void Tick(float DeltaTime) override;
 
 private:
+	// A registered listener and its handler for each sound type
+	struct FSoundListener
+	{
+		TWeakObjectPtr<AController> Controller;
+		FSoundEventHandler Handlers[static_cast<uint8>(E_SoundEventType::Count)];
+	};
+
+	// Last time a character's sound of a certain type was sent out to the AI
+	struct FSoundCoalesceState
+	{
+		TWeakObjectPtr<ACharacter> Character;
+		E_SoundEventType SoundType = E_SoundEventType::None;
+		float LastNotifyTime = 0.0f;
+		float LastNotifyIntensity = 0.0f;
+	};
+
+	// Sends a single sound event to every listener close enough to hear it
+	void NotifyAIOfSoundEvent(const FSoundEvent& SoundEvent);
+
+	// Adds an event to the back of the queue, dropping the oldest one if the queue is full
+	void EnqueueSoundEvent(const FSoundEvent& SoundEvent);
+
+	// Should this queued event wait for its coalesce window to pass before going out
+	bool ShouldHoldSoundEvent(const FSoundEvent& SoundEvent, const float CurrentTime) const;
+
+	// Remembers that this event went out so repeats of it get coalesced
+	void RecordNotifiedSoundEvent(const FSoundEvent& SoundEvent, const float CurrentTime);
+
 	// List of AI to notify
-	TArray<AActor*> RegisteredAIActors;
+	TArray<FSoundListener> SoundListeners;
 
-	// Array to store sound events
+	// Ring buffer of queued sound events, sized once in PostInitializeComponents
 	TArray<FSoundEvent> SoundEvents;
 
-	// Register AI actors
-	void RegisterAIActors();
+	// Index of the oldest queued event in the ring
+	int32 SoundEventsHead = 0;
+
+	// Number of queued events in the ring
+	int32 NumQueuedSoundEvents = 0;
+
+	// When each character's sounds last went out, one entry per character and sound type
+	TArray<FSoundCoalesceState> CoalesceStates;
+
+	// Max number of sound events queued at once, the oldest is dropped when full
+	UPROPERTY(EditAnywhere, Category = "Sound", meta = (ClampMin = "1"))
+	int32 MaxQueuedSoundEvents = 256;
+
+	// Sounds further than this from an AI are never heard by it
+	UPROPERTY(EditAnywhere, Category = "Sound")
+	float MaxHearingDistance = 3000.0f;
+
+	// Sounds that attenuate below this intensity by the time they reach an AI aren't heard by it
+	UPROPERTY(EditAnywhere, Category = "Sound")
+	float MinAudibleIntensity = 0.01f;
+
+	// Repeats of the same sound type from the same character within this many seconds get merged.
+	// A louder repeat still goes out right away.
+	UPROPERTY(EditAnywhere, Category = "Sound")
+	float CoalesceWindow = 0.25f;
 
 };
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "RPCStats.h"
+
+#if QU_WITH_RPC_STATS
+
+namespace RPCStats
+{
+	// Tally per RPC name
+	static TMap<FName, FRPCStats::FTally> Tallies;
+}
+
+void FRPCStats::Record(const UObject* Object, const FName FunctionName)
+{
+	check(IsInGameThread());
+
+	const UFunction* Function = Object ? Object->FindFunction(FunctionName) : nullptr;
+
+	FTally& Tally = RPCStats::Tallies.FindOrAdd(FunctionName);
+	Tally.Count++;
+	Tally.Bytes += Function ? Function->ParmsSize : 0;
+}
+
+FRPCStats::FTally FRPCStats::Get(const FName FunctionName)
+{
+	const FTally* Tally = RPCStats::Tallies.Find(FunctionName);
+	return Tally ? *Tally : FTally();
+}
+
+FRPCStats::FTally FRPCStats::GetTotal()
+{
+	FTally Total;
+	for (const TPair<FName, FTally>& Tally : RPCStats::Tallies)
+	{
+		Total.Count += Tally.Value.Count;
+		Total.Bytes += Tally.Value.Bytes;
+	}
+	return Total;
+}
+
+void FRPCStats::Reset()
+{
+	RPCStats::Tallies.Reset();
+}
+
+#endif
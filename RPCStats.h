@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// RPC counting for benchmarks and automation tests.
+// Each RPC is counted where it runs, in its _Implementation, so it gets counted the same way in a test world
+// with no net driver as on a real server. A multicast counts once on every machine it runs on.
+// Bytes are the RPC's parameter size in memory. The net driver quantizes parameters before sending them,
+// so this is an upper bound rather than the wire size, but it doesn't change from run to run and can be diffed.
+// Compiled out of Shipping and Test builds.
+#if !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#define QU_WITH_RPC_STATS 1
+#else
+#define QU_WITH_RPC_STATS 0
+#endif
+
+#if QU_WITH_RPC_STATS
+
+struct NETWORKINGPROTOTYPE_API FRPCStats
+{
+	// How many times an RPC ran and how many parameter bytes it carried in total
+	struct FTally
+	{
+		int32 Count = 0;
+		int64 Bytes = 0;
+	};
+
+	// Counts one call of the RPC named FunctionName on Object, game thread only
+	static void Record(const UObject* Object, const FName FunctionName);
+
+	// Tally for one RPC, zero if it never ran since the last reset
+	static FTally Get(const FName FunctionName);
+
+	// Tally of every RPC since the last reset
+	static FTally GetTotal();
+
+	// Forgets everything counted so far
+	static void Reset();
+};
+
+// Counts a call of one of this class' RPCs, use at the top of its _Implementation
+#define QU_COUNT_RPC(FunctionName) FRPCStats::Record(this, GET_FUNCTION_NAME_CHECKED(ThisClass, FunctionName))
+
+#else
+
+#define QU_COUNT_RPC(FunctionName) do { } while (0)
+
+#endif
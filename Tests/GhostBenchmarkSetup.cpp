@@ -0,0 +1,154 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetworkingPrototype/Tests/GhostBenchmarkSetup.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Ghost/Ghost.h"
+#include "NetworkingPrototype/Ghost/GhostAIController.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "NavigationSystem.h"
+
+static TAutoConsoleVariable<FString> CVarGhostBenchmarkMap(
+	TEXT("QU.GhostBenchmark.Map"),
+	TEXT(""),
+	TEXT("Map the ghost benchmarks run in, EX: /Game/Maps/GhostBenchmark. It needs a nav mesh and room around its first\n")
+	TEXT("player start for a grid of every bot and ghost, the 96 bot haunt benchmark takes about 4000 by 5000 units."));
+
+static TAutoConsoleVariable<FString> CVarGhostBenchmarkGhostClass(
+	TEXT("QU.GhostBenchmark.GhostClass"),
+	TEXT(""),
+	TEXT("Ghost class the ghost benchmarks spawn, EX: /Game/Ghost/BP_Ghost.BP_Ghost_C.\n")
+	TEXT("Its AI controller class needs a behavior tree, the benchmarks measure the real one."));
+
+namespace GhostBenchmarkSetup
+{
+	FString GetMap(FAutomationTestBase& Test)
+	{
+		const FString Map = CVarGhostBenchmarkMap.GetValueOnGameThread();
+		if (Map.IsEmpty())
+		{
+			Test.AddError(TEXT("QU.GhostBenchmark.Map isn't set, the ghosts need a map with a nav mesh to chase through."));
+		}
+		return Map;
+	}
+
+	TSubclassOf<AGhost> LoadGhostClass(FAutomationTestBase& Test)
+	{
+		const FString GhostClassPath = CVarGhostBenchmarkGhostClass.GetValueOnGameThread();
+		if (GhostClassPath.IsEmpty())
+		{
+			Test.AddError(TEXT("QU.GhostBenchmark.GhostClass isn't set, the C++ ghost has no behavior tree to benchmark."));
+			return nullptr;
+		}
+
+		UClass* GhostClass = LoadClass<AGhost>(nullptr, *GhostClassPath);
+		if (!GhostClass)
+		{
+			Test.AddError(FString::Printf(TEXT("Couldn't load ghost class %s."), *GhostClassPath));
+			return nullptr;
+		}
+
+		const AGhost* GhostDefaults = GetDefault<AGhost>(GhostClass);
+		if (!GhostDefaults->AIControllerClass || !GhostDefaults->AIControllerClass->IsChildOf<AGhostAIController>())
+		{
+			Test.AddError(FString::Printf(TEXT("%s's AI controller class isn't a ghost AI controller."), *GhostClass->GetName()));
+			return nullptr;
+		}
+
+		const AGhostAIController* ControllerDefaults = GetDefault<AGhostAIController>(GhostDefaults->AIControllerClass);
+		if (!ControllerDefaults->GetBehaviorTree())
+		{
+			Test.AddError(FString::Printf(TEXT("%s has no behavior tree assigned, there's nothing to benchmark."),
+				*GhostDefaults->AIControllerClass->GetName()));
+			return nullptr;
+		}
+
+		return GhostClass;
+	}
+
+	bool FindNavGrid(FAutomationTestBase& Test, UWorld* World, const int32 Count, const float Spacing, const FVector& Offset,
+		TArray<FVector>& OutLocations)
+	{
+		const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+		if (!NavSys || !NavSys->GetDefaultNavDataInstance())
+		{
+			Test.AddError(FString::Printf(TEXT("%s has no nav mesh."), *World->GetMapName()));
+			return false;
+		}
+
+		FVector Origin = FVector::ZeroVector;
+		for (TActorIterator<APlayerStart> It(World); It; ++It)
+		{
+			Origin = It->GetActorLocation();
+			break;
+		}
+		Origin += Offset;
+
+		const int32 NumColumns = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(Count)));
+		const FVector QueryExtent(Spacing * 0.5f, Spacing * 0.5f, 500.0f);
+		for (int32 PointIdx = 0; PointIdx < Count; PointIdx++)
+		{
+			const FVector Point = Origin + FVector((PointIdx / NumColumns) * Spacing, (PointIdx % NumColumns) * Spacing, 0.0f);
+
+			FNavLocation NavLocation;
+			if (!NavSys->ProjectPointToNavigation(Point, NavLocation, QueryExtent))
+			{
+				Test.AddError(FString::Printf(TEXT("%s isn't near the nav mesh, the map needs more room around its player start."),
+					*Point.ToString()));
+				return false;
+			}
+			OutLocations.Add(NavLocation.Location);
+		}
+		return true;
+	}
+
+	AGhostAIController* SpawnGhost(FQUTestWorld& TestWorld, TSubclassOf<AGhost> GhostClass, const FVector& Location,
+		TFunction<void(AGhostAIController*)> InitController)
+	{
+		UWorld* World = TestWorld.GetWorld();
+
+		// We possess it ourselves so the controller can be set up first
+		const FTransform GhostTransform(Location);
+		AGhost* Ghost = World->SpawnActorDeferred<AGhost>(GhostClass, GhostTransform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Ghost)
+		{
+			return nullptr;
+		}
+		Ghost->AutoPossessAI = EAutoPossessAI::Disabled;
+
+		// Nothing renders headless, keep the pose ticking like a listen server would so the kill montage blends out
+		Ghost->GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+
+		// Stand on the nav mesh rather than in it
+		Ghost->FinishSpawning(FTransform(Location + FVector(0.0f, 0.0f, Ghost->GetCapsuleComponent()->GetScaledCapsuleHalfHeight())));
+
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Instigator = Ghost;
+		SpawnParams.bDeferConstruction = true;
+		AGhostAIController* GhostController = World->SpawnActor<AGhostAIController>(Ghost->AIControllerClass,
+			Ghost->GetActorTransform(), SpawnParams);
+		if (!GhostController)
+		{
+			return nullptr;
+		}
+		if (InitController)
+		{
+			InitController(GhostController);
+		}
+		GhostController->FinishSpawning(Ghost->GetActorTransform());
+		GhostController->Possess(Ghost);
+
+		return GhostController;
+	}
+}
+
+#endif
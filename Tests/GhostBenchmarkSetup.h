@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Templates/Function.h"
+#include "Templates/SubclassOf.h"
+
+class FAutomationTestBase;
+class FQUTestWorld;
+class AGhost;
+class AGhostAIController;
+
+/**
+ * Setup shared by the ghost benchmarks. They run the ghost's own controller, behavior tree and follow task,
+ * so they need a map with a nav mesh and a ghost class whose controller has a behavior tree. Both are set with
+ * QU.GhostBenchmark.Map and QU.GhostBenchmark.GhostClass, on the command line or under [ConsoleVariables] in DefaultEngine.ini.
+ */
+namespace GhostBenchmarkSetup
+{
+	// Map the benchmarks run in, adds an error to Test and returns an empty string if it isn't set
+	FString GetMap(FAutomationTestBase& Test);
+
+	// Ghost class the benchmarks spawn, adds an error to Test and returns nullptr if it can't be loaded
+	// or its controller isn't a ghost AI controller with a behavior tree
+	TSubclassOf<AGhost> LoadGhostClass(FAutomationTestBase& Test);
+
+	// Count points Spacing apart on a square grid, starting Offset from the map's first player start, moved onto the nav mesh.
+	// Adds an error to Test and returns false if the map has no nav mesh or a point isn't near it.
+	bool FindNavGrid(FAutomationTestBase& Test, UWorld* World, int32 Count, float Spacing, const FVector& Offset,
+		TArray<FVector>& OutLocations);
+
+	// Spawns a ghost possessed by a controller of its AI controller class, like a ghost placed in the level.
+	// InitController runs on the controller before it begins play and possesses the ghost, for setting its tunables.
+	AGhostAIController* SpawnGhost(FQUTestWorld& TestWorld, TSubclassOf<AGhost> GhostClass, const FVector& Location,
+		TFunction<void(AGhostAIController*)> InitController = nullptr);
+}
+
+#endif
@@ -0,0 +1,212 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Tests/GhostBenchmarkSetup.h"
+#include "NetworkingPrototype/Ghost/Ghost.h"
+#include "NetworkingPrototype/Ghost/GhostAIController.h"
+#include "NetworkingPrototype/Ghost/GhostDirectorSubsystem.h"
+#include "NetworkingPrototype/Ghost/GhostStats.h"
+#include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+namespace GhostDirectorBenchmark
+{
+	// Every frame is the same length so runs can be compared
+	constexpr float FrameSeconds = 1.0f / 30.0f;
+
+	// Frames to let every tree, sense and LOD settle before measuring, then frames measured
+	constexpr int32 WarmUpFrames = 60;
+	constexpr int32 MeasuredFrames = 600;
+
+	// The same players for every ghost count, so only the ghosts change between setups
+	constexpr int32 NumBots = 8;
+	constexpr float BotSpacing = 500.0f;
+
+	// Ghosts start on their own grid past the bots
+	constexpr float GhostSpacing = 300.0f;
+	const FVector GhostGridOffset(2000.0f, 0.0f, 0.0f);
+
+	// Costs of one frame
+	struct FFrameResult
+	{
+		double ServerTickSeconds = 0.0;
+		FGhostLoopTimings Timings;
+	};
+
+	// Value Fraction of the way through the sorted values
+	double Percentile(TArray<double> Values, const double Fraction)
+	{
+		Values.Sort();
+		return Values[FMath::Min(FMath::FloorToInt32(Fraction * Values.Num()), Values.Num() - 1)];
+	}
+}
+
+/**
+ * Headless benchmark of the Ghost Director's server cost, run with
+ * UnrealEditor-Cmd <project> -nullrhi -ExecCmds="Automation RunTests QueriesUnlimited.Ghost.DirectorBenchmark; Quit"
+ * Loads QU.GhostBenchmark.Map, spawns 8 bot players and 1, 8, 32 or 64 ghosts of QU.GhostBenchmark.GhostClass,
+ * and lets their controllers, behavior trees and sight run as they would in a match for 600 frames.
+ * Reports the mean, 95th percentile and worst server tick, and the director, behavior tree, perception LOD and sight
+ * time per frame. Every frame goes to Saved/Automation/GhostDirectorBenchmark/<M>Ghosts.csv so two builds can be diffed.
+ * Fails if the map or ghost class isn't set, or if a ghost's behavior tree isn't running.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FGhostDirectorBenchmarkTest, "QueriesUnlimited.Ghost.DirectorBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FGhostDirectorBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const int32 GhostCounts[] = { 1, 8, 32, 64 };
+	for (const int32 GhostCount : GhostCounts)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dGhosts"), GhostCount));
+		OutTestCommands.Add(FString::FromInt(GhostCount));
+	}
+}
+
+bool FGhostDirectorBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace GhostDirectorBenchmark;
+
+	const int32 NumGhosts = FCString::Atoi(*Parameters);
+	if (NumGhosts <= 0)
+	{
+		AddError(FString::Printf(TEXT("Expected a ghost count, got \"%s\"."), *Parameters));
+		return false;
+	}
+
+	const FString Map = GhostBenchmarkSetup::GetMap(*this);
+	const TSubclassOf<AGhost> GhostClass = GhostBenchmarkSetup::LoadGhostClass(*this);
+	if (Map.IsEmpty() || !GhostClass)
+	{
+		return false;
+	}
+
+	FQUTestWorld TestWorld(Map);
+	if (!TestWorld.IsValid())
+	{
+		AddError(FString::Printf(TEXT("Couldn't load %s."), *Map));
+		return false;
+	}
+	UWorld* World = TestWorld.GetWorld();
+
+	TArray<FVector> BotLocations;
+	TArray<FVector> GhostLocations;
+	if (!GhostBenchmarkSetup::FindNavGrid(*this, World, NumBots, BotSpacing, FVector::ZeroVector, BotLocations)
+		|| !GhostBenchmarkSetup::FindNavGrid(*this, World, NumGhosts, GhostSpacing, GhostGridOffset, GhostLocations))
+	{
+		return false;
+	}
+
+	for (const FVector& Location : BotLocations)
+	{
+		if (!TestWorld.SpawnBotPlayer<ANetworkingPrototypeCharacter>(ANetworkingPrototypeCharacter::StaticClass(),
+			Location + FVector(0.0f, 0.0f, 100.0f)))
+		{
+			AddError(TEXT("Couldn't spawn a bot player."));
+			return false;
+		}
+	}
+
+	TArray<AGhostAIController*> GhostControllers;
+	for (const FVector& Location : GhostLocations)
+	{
+		AGhostAIController* GhostController = GhostBenchmarkSetup::SpawnGhost(TestWorld, GhostClass, Location);
+		if (!GhostController)
+		{
+			AddError(TEXT("Couldn't spawn a ghost with its controller."));
+			return false;
+		}
+		GhostController->ActivateGhost();
+		GhostControllers.Add(GhostController);
+	}
+
+	const UGhostDirectorSubsystem* GhostDirector = World->GetSubsystem<UGhostDirectorSubsystem>();
+	if (!GhostDirector)
+	{
+		AddError(TEXT("No Ghost Director."));
+		return false;
+	}
+
+	TestWorld.Tick(FrameSeconds, WarmUpFrames);
+
+	// Make sure the trees being measured are really running
+	for (const AGhostAIController* GhostController : GhostControllers)
+	{
+		const UBehaviorTreeComponent* BehaviorTreeComponent = GhostController->GetBehaviorTreeComponent();
+		if (!BehaviorTreeComponent || !BehaviorTreeComponent->IsRunning())
+		{
+			AddError(FString::Printf(TEXT("%s's behavior tree isn't running."), *GhostController->GetName()));
+			return false;
+		}
+	}
+
+	TArray<FFrameResult> Results;
+	Results.Reserve(MeasuredFrames);
+	for (int32 Frame = 0; Frame < MeasuredFrames; Frame++)
+	{
+		FFrameResult& Result = Results.AddDefaulted_GetRef();
+		FGhostLoopTimings::Get().Reset();
+		{
+			FScopedDurationTimer ServerTickTimer(Result.ServerTickSeconds);
+			TestWorld.Tick(FrameSeconds);
+		}
+		Result.Timings = FGhostLoopTimings::Get();
+	}
+
+	// Write out every frame
+	TArray<double> ServerTickMs;
+	FGhostLoopTimings Totals;
+	FString Csv = TEXT("Frame,Ghosts,ServerTickMs,DirectorMs,BehaviorTreeMs,PerceptionLODMs,SightMs,HauntLoopMs\n");
+	for (int32 Frame = 0; Frame < Results.Num(); Frame++)
+	{
+		const FFrameResult& Result = Results[Frame];
+		Csv += FString::Printf(TEXT("%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+			Frame, NumGhosts, Result.ServerTickSeconds * 1000.0, Result.Timings.DirectorSeconds * 1000.0,
+			Result.Timings.BehaviorTreeSeconds * 1000.0, Result.Timings.PerceptionLODSeconds * 1000.0,
+			Result.Timings.SightSeconds * 1000.0, Result.Timings.HauntLoopSeconds * 1000.0);
+
+		ServerTickMs.Add(Result.ServerTickSeconds * 1000.0);
+		Totals.DirectorSeconds += Result.Timings.DirectorSeconds;
+		Totals.BehaviorTreeSeconds += Result.Timings.BehaviorTreeSeconds;
+		Totals.PerceptionLODSeconds += Result.Timings.PerceptionLODSeconds;
+		Totals.SightSeconds += Result.Timings.SightSeconds;
+	}
+
+	const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Automation/GhostDirectorBenchmark")
+		/ FString::Printf(TEXT("%dGhosts.csv"), NumGhosts);
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		AddInfo(FString::Printf(TEXT("Wrote %s"), *CsvPath));
+	}
+	else
+	{
+		AddError(FString::Printf(TEXT("Couldn't write %s."), *CsvPath));
+	}
+
+	double MeanServerTickMs = 0.0;
+	for (const double TickMs : ServerTickMs)
+	{
+		MeanServerTickMs += TickMs;
+	}
+	MeanServerTickMs /= ServerTickMs.Num();
+
+	const double MsPerFrame = 1000.0 / Results.Num();
+	AddInfo(FString::Printf(TEXT("%d ghosts: server tick %.3f ms mean, %.3f ms p95, %.3f ms worst"),
+		NumGhosts, MeanServerTickMs, Percentile(ServerTickMs, 0.95), Percentile(ServerTickMs, 1.0)));
+	AddInfo(FString::Printf(TEXT("%d ghosts per frame: director %.3f ms, behavior trees %.3f ms, perception LOD %.3f ms, sight %.3f ms"),
+		NumGhosts, Totals.DirectorSeconds * MsPerFrame, Totals.BehaviorTreeSeconds * MsPerFrame,
+		Totals.PerceptionLODSeconds * MsPerFrame, Totals.SightSeconds * MsPerFrame));
+
+	return !HasAnyErrors();
+}
+
+#endif
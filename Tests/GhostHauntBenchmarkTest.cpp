@@ -0,0 +1,262 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Tests/GhostBenchmarkSetup.h"
+#include "NetworkingPrototype/Ghost/Ghost.h"
+#include "NetworkingPrototype/Ghost/GhostAIController.h"
+#include "NetworkingPrototype/Ghost/GhostStats.h"
+#include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
+#include "NetworkingPrototype/RPCStats.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/ScopedTimers.h"
+
+namespace GhostHauntBenchmark
+{
+	// Every frame is the same length so runs can be compared
+	constexpr float FrameSeconds = 1.0f / 30.0f;
+
+	// Ghosts go from calm to haunting in this long instead of the half minute a match gives them,
+	// the aggro meter still fills through their behavior tree
+	constexpr float AggroSeconds = 3.0f;
+
+	// Long enough that no haunt times out before the follow task catches its player
+	constexpr float HauntSeconds = 60.0f;
+
+	// A cycle that hasn't had every ghost kill once by now has stalled
+	constexpr int32 MaxCycleFrames = 90 * 30;
+
+	constexpr int32 NumCycles = 5;
+
+	// Players stand on a grid in front of the ghosts
+	constexpr float BotSpacing = 400.0f;
+	constexpr float GhostSpacing = 300.0f;
+	const FVector GhostGridOffset(1000.0f, 0.0f, 0.0f);
+
+	// Costs of one haunt cycle
+	struct FCycleResult
+	{
+		int32 Frames = 0;
+		double ServerTickSeconds = 0.0;
+		FGhostLoopTimings Timings;
+		FRPCStats::FTally RPCs;
+		int32 HauntsStarted = 0;
+		int32 HauntsEnded = 0;
+		int32 Kills = 0;
+	};
+}
+
+/**
+ * Headless benchmark of the ghost haunt and kill loop, run with
+ * UnrealEditor-Cmd <project> -nullrhi -ExecCmds="Automation RunTests QueriesUnlimited.Ghost.HauntBenchmark; Quit"
+ * Loads QU.GhostBenchmark.Map, spawns N players and M ghosts of QU.GhostBenchmark.GhostClass and leaves the rest
+ * to the ghosts' own controllers, behavior trees and follow task: aggro builds, haunts start, ghosts chase their
+ * player over the nav mesh and kill them, and haunts end. The test only revives the dead between cycles.
+ * Each cycle's server tick, Ghost Director, behavior tree, perception and haunt loop time, the RPCs it ran,
+ * and its haunts and kills are written to Saved/Automation/GhostHauntBenchmark/<N>Bots<M>Ghosts.csv so two builds can be diffed.
+ * Fails if the map or ghost class isn't set, the ghost has no behavior tree, or a cycle goes 90 seconds
+ * without every ghost killing once.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FGhostHauntBenchmarkTest, "QueriesUnlimited.Ghost.HauntBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FGhostHauntBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	// Bots and ghosts
+	const FIntPoint Setups[] = { { 4, 1 }, { 8, 2 }, { 16, 4 }, { 32, 8 }, { 64, 32 }, { 96, 64 } };
+	for (const FIntPoint& Setup : Setups)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dBots%dGhosts"), Setup.X, Setup.Y));
+		OutTestCommands.Add(FString::Printf(TEXT("%d %d"), Setup.X, Setup.Y));
+	}
+}
+
+bool FGhostHauntBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace GhostHauntBenchmark;
+
+	FString BotsParameter;
+	FString GhostsParameter;
+	if (!Parameters.Split(TEXT(" "), &BotsParameter, &GhostsParameter))
+	{
+		AddError(FString::Printf(TEXT("Expected \"<Bots> <Ghosts>\", got \"%s\"."), *Parameters));
+		return false;
+	}
+	const int32 NumBots = FCString::Atoi(*BotsParameter);
+	const int32 NumGhosts = FCString::Atoi(*GhostsParameter);
+	if (NumBots < NumGhosts || NumGhosts <= 0)
+	{
+		AddError(TEXT("Every ghost needs its own bot to haunt."));
+		return false;
+	}
+
+	const FString Map = GhostBenchmarkSetup::GetMap(*this);
+	const TSubclassOf<AGhost> GhostClass = GhostBenchmarkSetup::LoadGhostClass(*this);
+	if (Map.IsEmpty() || !GhostClass)
+	{
+		return false;
+	}
+
+	FQUTestWorld TestWorld(Map);
+	if (!TestWorld.IsValid())
+	{
+		AddError(FString::Printf(TEXT("Couldn't load %s."), *Map));
+		return false;
+	}
+	UWorld* World = TestWorld.GetWorld();
+
+	TArray<FVector> BotLocations;
+	TArray<FVector> GhostLocations;
+	if (!GhostBenchmarkSetup::FindNavGrid(*this, World, NumBots, BotSpacing, FVector::ZeroVector, BotLocations)
+		|| !GhostBenchmarkSetup::FindNavGrid(*this, World, NumGhosts, GhostSpacing, GhostGridOffset, GhostLocations))
+	{
+		return false;
+	}
+
+	// The follow task only kills players a player controller owns
+	TArray<ANetworkingPrototypeCharacter*> Bots;
+	for (FVector& Location : BotLocations)
+	{
+		Location.Z += 100.0f;
+		ANetworkingPrototypeCharacter* Bot = TestWorld.SpawnPlayer<ANetworkingPrototypeCharacter>(
+			ANetworkingPrototypeCharacter::StaticClass(), Location);
+		if (!Bot)
+		{
+			AddError(TEXT("Couldn't spawn a bot player."));
+			return false;
+		}
+		Bots.Add(Bot);
+	}
+
+	auto ShortenAggro = [](AGhostAIController* GhostController)
+	{
+		GhostController->AggroTimer = AggroSeconds;
+		GhostController->HauntDuration = HauntSeconds;
+	};
+
+	TArray<AGhostAIController*> GhostControllers;
+	for (const FVector& Location : GhostLocations)
+	{
+		AGhostAIController* GhostController = GhostBenchmarkSetup::SpawnGhost(TestWorld, GhostClass, Location, ShortenAggro);
+		if (!GhostController)
+		{
+			AddError(TEXT("Couldn't spawn a ghost with its controller."));
+			return false;
+		}
+
+		const UBehaviorTreeComponent* BehaviorTreeComponent = GhostController->GetBehaviorTreeComponent();
+		if (!BehaviorTreeComponent || !BehaviorTreeComponent->IsRunning())
+		{
+			AddError(FString::Printf(TEXT("%s's behavior tree isn't running."), *GhostController->GetName()));
+			return false;
+		}
+
+		GhostController->ActivateGhost();
+		GhostControllers.Add(GhostController);
+	}
+
+	// Let everything finish starting up before measuring
+	TestWorld.Tick(FrameSeconds, 2);
+
+	TArray<bool> WasHaunting;
+	WasHaunting.Init(false, NumGhosts);
+	TArray<bool> WasAlive;
+	WasAlive.Init(true, NumBots);
+
+	TArray<FCycleResult> Results;
+	for (int32 Cycle = 0; Cycle < NumCycles; Cycle++)
+	{
+		FCycleResult& Result = Results.AddDefaulted_GetRef();
+		FGhostLoopTimings::Get().Reset();
+		FRPCStats::Reset();
+
+		// Run until every ghost has killed once and calmed down again
+		bool bAnyHaunting = true;
+		while (Result.Kills < NumGhosts || bAnyHaunting)
+		{
+			if (Result.Frames >= MaxCycleFrames)
+			{
+				AddError(FString::Printf(TEXT("Cycle %d stalled after %d frames: %d haunts started, %d ended, %d of %d kills."),
+					Cycle, Result.Frames, Result.HauntsStarted, Result.HauntsEnded, Result.Kills, NumGhosts));
+				break;
+			}
+
+			{
+				FScopedDurationTimer ServerTickTimer(Result.ServerTickSeconds);
+				TestWorld.Tick(FrameSeconds);
+			}
+			Result.Frames++;
+
+			bAnyHaunting = false;
+			for (int32 GhostIdx = 0; GhostIdx < NumGhosts; GhostIdx++)
+			{
+				const bool bHaunting = GhostControllers[GhostIdx]->GetGhostBlackboard().GetBool(E_GhostBlackboardKey::IsHaunting);
+				Result.HauntsStarted += bHaunting && !WasHaunting[GhostIdx] ? 1 : 0;
+				Result.HauntsEnded += !bHaunting && WasHaunting[GhostIdx] ? 1 : 0;
+				WasHaunting[GhostIdx] = bHaunting;
+				bAnyHaunting |= bHaunting;
+			}
+
+			for (int32 BotIdx = 0; BotIdx < NumBots; BotIdx++)
+			{
+				const bool bAlive = Bots[BotIdx]->GetIsAlive();
+				Result.Kills += !bAlive && WasAlive[BotIdx] ? 1 : 0;
+				WasAlive[BotIdx] = bAlive;
+			}
+		}
+
+		Result.Timings = FGhostLoopTimings::Get();
+		Result.RPCs = FRPCStats::GetTotal();
+
+		if (HasAnyErrors())
+		{
+			break;
+		}
+
+		// Revive the dead where they stood at the start, there's no game mode to do it
+		for (int32 BotIdx = 0; BotIdx < NumBots; BotIdx++)
+		{
+			if (!Bots[BotIdx]->GetIsAlive())
+			{
+				Bots[BotIdx]->RevivePlayer(BotLocations[BotIdx]);
+				Bots[BotIdx]->SetActorLocation(BotLocations[BotIdx]);
+				WasAlive[BotIdx] = true;
+			}
+		}
+	}
+
+	// Write out every cycle
+	FString Csv = TEXT("Cycle,Bots,Ghosts,Frames,ServerTickMs,DirectorMs,BehaviorTreeMs,PerceptionLODMs,SightMs,HauntLoopMs,RPCs,RPCBytes,HauntsStarted,HauntsEnded,Kills\n");
+	for (int32 Cycle = 0; Cycle < Results.Num(); Cycle++)
+	{
+		const FCycleResult& Result = Results[Cycle];
+		Csv += FString::Printf(TEXT("%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%d,%lld,%d,%d,%d\n"),
+			Cycle, NumBots, NumGhosts, Result.Frames,
+			Result.ServerTickSeconds * 1000.0, Result.Timings.DirectorSeconds * 1000.0,
+			Result.Timings.BehaviorTreeSeconds * 1000.0, Result.Timings.PerceptionLODSeconds * 1000.0,
+			Result.Timings.SightSeconds * 1000.0, Result.Timings.HauntLoopSeconds * 1000.0,
+			Result.RPCs.Count, Result.RPCs.Bytes, Result.HauntsStarted, Result.HauntsEnded, Result.Kills);
+	}
+
+	const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Automation/GhostHauntBenchmark")
+		/ FString::Printf(TEXT("%dBots%dGhosts.csv"), NumBots, NumGhosts);
+	if (FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		AddInfo(FString::Printf(TEXT("Wrote %s"), *CsvPath));
+	}
+	else
+	{
+		AddError(FString::Printf(TEXT("Couldn't write %s."), *CsvPath));
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
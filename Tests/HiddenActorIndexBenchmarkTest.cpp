@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Managers/HiddenActorIndexSubsystem.h"
+#include "HiddenActor.h"
+#include "Components/SphereComponent.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+namespace HiddenActorIndexBenchmark
+{
+	// Same reveal as AMagnifyingGlass::RevealHiddenObjects, a 50 by 200 capsule swept 1000 units
+	constexpr float CapsuleRadius = 50.0f;
+	constexpr float CapsuleHalfHeight = 200.0f;
+	constexpr float TraceLength = 1000.0f;
+	constexpr float RevealLength = TraceLength + CapsuleHalfHeight - CapsuleRadius;
+
+	// Hidden actors are scattered over a floor this big, about the size of a generated dungeon
+	constexpr float FloorSize = 20000.0f;
+	constexpr float FloorHeight = 200.0f;
+
+	// Reveals timed per path
+	constexpr int32 NumReveals = 1000;
+
+	// Same seed every run so both paths and every build see the same scene
+	constexpr int32 RandomSeed = 1234;
+}
+
+/**
+ * Micro-benchmark of the two ways the magnifying glass can find hidden actors, run with
+ * UnrealEditor-Cmd <project> -nullrhi -ExecCmds="Automation RunTests QueriesUnlimited.MagnifyingGlass.HiddenActorIndexBenchmark; Quit"
+ * Scatters 1k, 10k or 100k hidden actors with small query-only spheres, then times the same reveals
+ * through the UHiddenActorIndexSubsystem grid and through the capsule SweepMultiByChannel plus casts.
+ * Results go to Saved/Automation/HiddenActorIndexBenchmark/<N>HiddenActors.csv.
+ * Fails if the index misses any actor the sweep found inside the reveal.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(FHiddenActorIndexBenchmarkTest, "QueriesUnlimited.MagnifyingGlass.HiddenActorIndexBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+void FHiddenActorIndexBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	const int32 ActorCounts[] = { 1000, 10000, 100000 };
+	for (const int32 ActorCount : ActorCounts)
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%dHiddenActors"), ActorCount));
+		OutTestCommands.Add(FString::FromInt(ActorCount));
+	}
+}
+
+bool FHiddenActorIndexBenchmarkTest::RunTest(const FString& Parameters)
+{
+	using namespace HiddenActorIndexBenchmark;
+
+	const int32 NumHiddenActors = FCString::Atoi(*Parameters);
+	if (NumHiddenActors <= 0)
+	{
+		AddError(FString::Printf(TEXT("Expected a hidden actor count, got \"%s\"."), *Parameters));
+		return false;
+	}
+
+	FQUTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+	FRandomStream Random(RandomSeed);
+
+	// Hidden actors get a small sphere so the sweep can hit them, it overlaps instead of blocking
+	// so the multi sweep returns all of them instead of stopping at the first
+	for (int32 ActorIdx = 0; ActorIdx < NumHiddenActors; ActorIdx++)
+	{
+		const FTransform Transform(FVector(Random.FRandRange(0.0f, FloorSize), Random.FRandRange(0.0f, FloorSize),
+			Random.FRandRange(0.0f, FloorHeight)));
+
+		AHiddenActor* HiddenActor = World->SpawnActorDeferred<AHiddenActor>(AHiddenActor::StaticClass(), Transform,
+			nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+		USphereComponent* Sphere = NewObject<USphereComponent>(HiddenActor, TEXT("Sphere"));
+		Sphere->InitSphereRadius(10.0f);
+		Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Sphere->SetCollisionResponseToAllChannels(ECR_Overlap);
+		HiddenActor->SetRootComponent(Sphere);
+		HiddenActor->AddInstanceComponent(Sphere);
+		HiddenActor->SetActorTickEnabled(false);
+
+		// Registers the sphere and adds the actor to the index at its spawn location
+		HiddenActor->FinishSpawning(Transform);
+	}
+
+	UHiddenActorIndexSubsystem* HiddenActorIndex = World->GetSubsystem<UHiddenActorIndexSubsystem>();
+	if (!HiddenActorIndex || HiddenActorIndex->GetNumHiddenActors() != NumHiddenActors)
+	{
+		AddError(TEXT("Not every hidden actor made it into the index."));
+		return false;
+	}
+
+	// Let physics pick up the new bodies before sweeping
+	TestWorld.Tick(1.0f / 30.0f, 2);
+
+	// Every reveal is level with the floor, like a player holding up the glass
+	TArray<FVector> RevealStarts;
+	TArray<FVector> RevealDirections;
+	for (int32 RevealIdx = 0; RevealIdx < NumReveals; RevealIdx++)
+	{
+		RevealStarts.Add(FVector(Random.FRandRange(0.0f, FloorSize), Random.FRandRange(0.0f, FloorSize), FloorHeight * 0.5f));
+		const float Yaw = Random.FRandRange(0.0f, 2.0f * PI);
+		RevealDirections.Add(FVector(FMath::Cos(Yaw), FMath::Sin(Yaw), 0.0f));
+	}
+
+	// Both paths do one reveal the way the glass does, reusing their arrays, and hand back the hidden actors found
+	TArray<AHiddenActor*> IndexedHiddenActors;
+	auto RevealThroughIndex = [&](const int32 RevealIdx)
+	{
+		HiddenActorIndex->QueryCone(RevealStarts[RevealIdx], RevealDirections[RevealIdx], RevealLength, CapsuleRadius,
+			0.0f, IndexedHiddenActors);
+		return IndexedHiddenActors.Num();
+	};
+
+	TArray<FHitResult> SweepHitResults;
+	const FCollisionQueryParams TraceParams(FName(TEXT("CapsuleTrace")), true);
+	TArray<AHiddenActor*> SweptHiddenActors;
+	auto RevealThroughSweep = [&](const int32 RevealIdx)
+	{
+		const FVector& Start = RevealStarts[RevealIdx];
+		const FVector& Direction = RevealDirections[RevealIdx];
+		World->SweepMultiByChannel(SweepHitResults, Start, Start + Direction * TraceLength,
+			FRotationMatrix::MakeFromZ(Direction).ToQuat(), ECC_Camera,
+			FCollisionShape::MakeCapsule(CapsuleRadius, CapsuleHalfHeight), TraceParams);
+
+		SweptHiddenActors.Reset();
+		for (const FHitResult& HitResult : SweepHitResults)
+		{
+			if (AHiddenActor* HiddenActor = Cast<AHiddenActor>(HitResult.GetActor()))
+			{
+				SweptHiddenActors.Add(HiddenActor);
+			}
+		}
+		return SweptHiddenActors.Num();
+	};
+
+	// Warm both paths up so neither pays for its first allocations while being timed
+	RevealThroughIndex(0);
+	RevealThroughSweep(0);
+
+	int64 NumIndexFound = 0;
+	const double IndexStartTime = FPlatformTime::Seconds();
+	for (int32 RevealIdx = 0; RevealIdx < NumReveals; RevealIdx++)
+	{
+		NumIndexFound += RevealThroughIndex(RevealIdx);
+	}
+	const double IndexSeconds = FPlatformTime::Seconds() - IndexStartTime;
+
+	int64 NumSweepFound = 0;
+	const double SweepStartTime = FPlatformTime::Seconds();
+	for (int32 RevealIdx = 0; RevealIdx < NumReveals; RevealIdx++)
+	{
+		NumSweepFound += RevealThroughSweep(RevealIdx);
+	}
+	const double SweepSeconds = FPlatformTime::Seconds() - SweepStartTime;
+
+	// The sweep also reaches behind the lens and picks up spheres that only graze it,
+	// but anything whose center it found in front of the lens the index has to find too
+	int32 NumMissed = 0;
+	for (int32 RevealIdx = 0; RevealIdx < NumReveals; RevealIdx++)
+	{
+		RevealThroughIndex(RevealIdx);
+		RevealThroughSweep(RevealIdx);
+
+		for (const AHiddenActor* HiddenActor : SweptHiddenActors)
+		{
+			const FVector ToActor = HiddenActor->GetActorLocation() - RevealStarts[RevealIdx];
+			const float AxisDist = FVector::DotProduct(ToActor, RevealDirections[RevealIdx]);
+			const float AxisDistSquared = ToActor.SizeSquared() - AxisDist * AxisDist;
+			const bool bInsideReveal = AxisDist >= 0.0f && AxisDist <= RevealLength && AxisDistSquared <= CapsuleRadius * CapsuleRadius;
+
+			if (bInsideReveal && !IndexedHiddenActors.Contains(HiddenActor))
+			{
+				NumMissed++;
+			}
+		}
+	}
+	TestEqual(TEXT("Hidden actors inside the reveal the index missed"), NumMissed, 0);
+
+	const double IndexMicroseconds = IndexSeconds * 1.0e6 / NumReveals;
+	const double SweepMicroseconds = SweepSeconds * 1.0e6 / NumReveals;
+	AddInfo(FString::Printf(TEXT("%d hidden actors: index %.2f us per reveal (%.1f found), sweep %.2f us per reveal (%.1f found)"),
+		NumHiddenActors, IndexMicroseconds, static_cast<double>(NumIndexFound) / NumReveals,
+		SweepMicroseconds, static_cast<double>(NumSweepFound) / NumReveals));
+
+	const FString Csv = FString::Printf(TEXT("HiddenActors,Reveals,IndexUs,IndexFound,SweepUs,SweepFound\n%d,%d,%.3f,%lld,%.3f,%lld\n"),
+		NumHiddenActors, NumReveals, IndexMicroseconds, NumIndexFound, SweepMicroseconds, NumSweepFound);
+	const FString CsvPath = FPaths::ProjectSavedDir() / TEXT("Automation/HiddenActorIndexBenchmark")
+		/ FString::Printf(TEXT("%dHiddenActors.csv"), NumHiddenActors);
+	if (!FFileHelper::SaveStringToFile(Csv, *CsvPath))
+	{
+		AddError(FString::Printf(TEXT("Couldn't write %s."), *CsvPath));
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Managers/InteractionFocusSubsystem.h"
+
+namespace InteractionFocusTrace
+{
+	// A couple of seconds of focus updates
+	constexpr float FrameSeconds = 1.0f / 30.0f;
+	constexpr int32 NumFrames = 60;
+}
+
+/**
+ * Checks that a viewer with nothing interactable around it costs no focus traces.
+ * Runs a locally controlled viewer first with an empty index, then with an indexed actor right in front
+ * of it that can't be interacted with, and expects no traces and no focus either way.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FInteractionFocusTraceTest, "QueriesUnlimited.InteractionFocus.NoTracesWhenNothingNearby",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FInteractionFocusTraceTest::RunTest(const FString& Parameters)
+{
+	using namespace InteractionFocusTrace;
+
+	FQUTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+
+	UInteractionFocusSubsystem* InteractionFocus = World->GetSubsystem<UInteractionFocusSubsystem>();
+	if (!InteractionFocus)
+	{
+		AddError(TEXT("No Interaction Focus Subsystem."));
+		return false;
+	}
+
+	// The bot's AI controller is local, so the viewer gets updated like a player's camera would
+	auto GiveViewComponent = [](APawn* Pawn)
+	{
+		USceneComponent* View = NewObject<USceneComponent>(Pawn, TEXT("View"));
+		Pawn->SetRootComponent(View);
+		Pawn->AddInstanceComponent(View);
+	};
+	APawn* Viewer = TestWorld.SpawnBotPlayer<APawn>(APawn::StaticClass(), FVector(0.0f, 0.0f, 100.0f),
+		FRotator::ZeroRotator, APlayerState::StaticClass(), GiveViewComponent);
+	if (!Viewer || !Viewer->IsLocallyControlled())
+	{
+		AddError(TEXT("Couldn't spawn a locally controlled viewer."));
+		return false;
+	}
+	InteractionFocus->RegisterViewer(Viewer, Viewer->GetRootComponent(), FInteractionFocusGained(), FInteractionFocusLost());
+
+	// Nothing in the index at all
+	const int32 NumTracesBefore = InteractionFocus->GetNumFocusTraces();
+	TestWorld.Tick(FrameSeconds, NumFrames);
+	TestEqual(TEXT("Focus traces with an empty index"), InteractionFocus->GetNumFocusTraces(), NumTracesBefore);
+	TestNull(TEXT("Focused actor with an empty index"), InteractionFocus->GetFocusedActor(Viewer));
+
+	// Something indexed right in front of the viewer that isn't interactable
+	AActor* NotInteractable = TestWorld.Spawn<AActor>(AActor::StaticClass(), FVector(100.0f, 0.0f, 100.0f));
+	InteractionFocus->RegisterInteractable(NotInteractable);
+	TestWorld.Tick(FrameSeconds, NumFrames);
+	TestEqual(TEXT("Focus traces with only a non interactable nearby"), InteractionFocus->GetNumFocusTraces(), NumTracesBefore);
+	TestNull(TEXT("Focused actor with only a non interactable nearby"), InteractionFocus->GetFocusedActor(Viewer));
+
+	InteractionFocus->UnregisterViewer(Viewer);
+	return !HasAnyErrors();
+}
+
+#endif
@@ -0,0 +1,200 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Characters/MagnifyingGlass.h"
+#include "HiddenActor.h"
+#include "HAL/MemoryBase.h"
+
+namespace MagnifyingGlassRevealAllocation
+{
+	// Hidden actors sit on rings around the glass, NumAngles evenly spaced spokes of one actor per ring
+	constexpr int32 NumAngles = 64;
+	const float RingRadii[] = { 300.0f, 600.0f, 900.0f };
+
+	// The glass turns to one of these many directions every update, each lined up with a spoke of hidden actors,
+	// so every update reveals some actors and hides the ones from the last direction
+	constexpr int32 NumDirections = 16;
+
+	constexpr int32 NumUpdates = 1000;
+
+	// Passes everything through to the real allocator, counting the game thread's allocations while bCounting is set
+	class FCountingMalloc final : public FMalloc
+	{
+	public:
+		explicit FCountingMalloc(FMalloc* InInnerMalloc) : InnerMalloc(InInnerMalloc) {}
+
+		bool bCounting = false;
+		int64 NumAllocations = 0;
+
+		virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->Malloc(Count, Alignment);
+		}
+
+		virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+		{
+			CountAllocation();
+			return InnerMalloc->TryMalloc(Count, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			// Shrinking to nothing is a free
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return InnerMalloc->Realloc(Original, Count, Alignment);
+		}
+
+		virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+		{
+			if (Count > 0)
+			{
+				CountAllocation();
+			}
+			return InnerMalloc->TryRealloc(Original, Count, Alignment);
+		}
+
+		virtual void Free(void* Original) override { InnerMalloc->Free(Original); }
+		virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return InnerMalloc->QuantizeSize(Count, Alignment); }
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return InnerMalloc->GetAllocationSize(Original, SizeOut); }
+		virtual void Trim(bool bTrimThreadCaches) override { InnerMalloc->Trim(bTrimThreadCaches); }
+		virtual void SetupTLSCachesOnCurrentThread() override { InnerMalloc->SetupTLSCachesOnCurrentThread(); }
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override { InnerMalloc->ClearAndDisableTLSCachesOnCurrentThread(); }
+		virtual bool IsInternallyThreadSafe() const override { return InnerMalloc->IsInternallyThreadSafe(); }
+		virtual bool ValidateHeap() override { return InnerMalloc->ValidateHeap(); }
+		virtual const TCHAR* GetDescriptiveName() override { return TEXT("CountingMalloc"); }
+
+	private:
+		void CountAllocation()
+		{
+			if (bCounting && IsInGameThread())
+			{
+				NumAllocations++;
+			}
+		}
+
+		FMalloc* InnerMalloc;
+	};
+
+	// Swaps GMalloc for a counting one for as long as it's in scope
+	class FScopedCountingMalloc
+	{
+	public:
+		FScopedCountingMalloc()
+			: RealMalloc(GMalloc)
+			, CountingMalloc(RealMalloc)
+		{
+			GMalloc = &CountingMalloc;
+		}
+
+		~FScopedCountingMalloc()
+		{
+			GMalloc = RealMalloc;
+		}
+
+		FCountingMalloc* operator->() { return &CountingMalloc; }
+
+	private:
+		FMalloc* RealMalloc;
+		FCountingMalloc CountingMalloc;
+	};
+}
+
+/**
+ * Checks that the magnifying glass' continuous reveal doesn't allocate once it's warmed up.
+ * Turns the glass between directions lined up with spokes of hidden actors so every update reveals
+ * and hides actors, and counts the game thread's heap allocations inside 1000 RevealHiddenObjects calls.
+ * The world is ticked between updates like it is between reveal timer fires, outside of the count.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMagnifyingGlassRevealAllocationTest, "QueriesUnlimited.MagnifyingGlass.RevealAllocations",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FMagnifyingGlassRevealAllocationTest::RunTest(const FString& Parameters)
+{
+	using namespace MagnifyingGlassRevealAllocation;
+
+	FQUTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+
+	// Hidden actors only need a location for the index to find them
+	TArray<AHiddenActor*> HiddenActors;
+	for (int32 AngleIdx = 0; AngleIdx < NumAngles; AngleIdx++)
+	{
+		const float Yaw = 360.0f * AngleIdx / NumAngles;
+		for (const float RingRadius : RingRadii)
+		{
+			const FTransform Transform(FRotator(0.0f, Yaw, 0.0f).Vector() * RingRadius);
+			AHiddenActor* HiddenActor = World->SpawnActorDeferred<AHiddenActor>(AHiddenActor::StaticClass(), Transform,
+				nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+
+			USceneComponent* Root = NewObject<USceneComponent>(HiddenActor, TEXT("Root"));
+			HiddenActor->SetRootComponent(Root);
+			HiddenActor->AddInstanceComponent(Root);
+
+			HiddenActor->FinishSpawning(Transform);
+			HiddenActors.Add(HiddenActor);
+		}
+	}
+
+	AMagnifyingGlass* MagnifyingGlass = TestWorld.Spawn<AMagnifyingGlass>();
+	if (!MagnifyingGlass)
+	{
+		AddError(TEXT("Couldn't spawn a magnifying glass."));
+		return false;
+	}
+
+	auto TurnGlass = [MagnifyingGlass](const int32 Update)
+	{
+		MagnifyingGlass->SetActorRotation(FRotator(0.0f, 360.0f * (Update % NumDirections) / NumDirections, 0.0f));
+	};
+
+	// Go round every direction a couple of times so every set and array has grown to what it needs
+	for (int32 Update = 0; Update < NumDirections * 2; Update++)
+	{
+		TurnGlass(Update);
+		MagnifyingGlass->RevealHiddenObjects();
+		TestWorld.Tick(1.0f / 20.0f);
+	}
+
+	int64 NumAllocations = 0;
+	{
+		FScopedCountingMalloc CountingMalloc;
+		for (int32 Update = 0; Update < NumUpdates; Update++)
+		{
+			TurnGlass(Update);
+
+			CountingMalloc->bCounting = true;
+			MagnifyingGlass->RevealHiddenObjects();
+			CountingMalloc->bCounting = false;
+
+			TestWorld.Tick(1.0f / 20.0f);
+		}
+		NumAllocations = CountingMalloc->NumAllocations;
+	}
+
+	TestEqual(TEXT("Allocations across 1000 reveal updates"), NumAllocations, static_cast<int64>(0));
+
+	// Make sure the reveal was actually doing something, the last direction's spoke has to be showing
+	const int32 LastDirection = (NumUpdates - 1) % NumDirections;
+	const int32 LastAngleIdx = LastDirection * NumAngles / NumDirections;
+	int32 NumShownOnLastSpoke = 0;
+	for (int32 RingIdx = 0; RingIdx < UE_ARRAY_COUNT(RingRadii); RingIdx++)
+	{
+		const AHiddenActor* HiddenActor = HiddenActors[LastAngleIdx * UE_ARRAY_COUNT(RingRadii) + RingIdx];
+		NumShownOnLastSpoke += HiddenActor->GetIsBeingLookedAt() && !HiddenActor->IsHidden() ? 1 : 0;
+	}
+	TestEqual(TEXT("Hidden actors shown on the spoke the glass ended on"), NumShownOnLastSpoke, static_cast<int32>(UE_ARRAY_COUNT(RingRadii)));
+
+	return !HasAnyErrors();
+}
+
+#endif
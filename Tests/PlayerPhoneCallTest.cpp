@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Public/PlayerPhone.h"
+#include "NetworkingPrototype/Characters/QUPlayerState.h"
+#include "NetworkingPrototype/Managers/PhoneChannelSubsystem.h"
+#include "NetworkingPrototype/NetworkingPrototypeCharacter.h"
+#include "NetworkingPrototype/RPCStats.h"
+#include "OnsetVoip/Public/OnsetVoipWorldSubsystem.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<FString> CVarPlayerPhoneCallTestCharacterClass(
+	TEXT("QU.PlayerPhoneCallTest.CharacterClass"),
+	TEXT(""),
+	TEXT("Player character class the phone call test spawns, EX: /Game/Characters/BP_Player.BP_Player_C so its phone class is used.\n")
+	TEXT("Empty spawns the C++ character holding the C++ phone."));
+
+namespace PlayerPhoneCallTest
+{
+	// Calls made back to back, every one has to cost the same RPCs
+	constexpr int32 NumCalls = 3;
+
+	constexpr float FrameSeconds = 1.0f / 30.0f;
+
+	// Every RPC a call can run
+	const FName PhoneRPCs[] = {
+		GET_FUNCTION_NAME_CHECKED(APlayerPhone, Server_CallPlayerByState),
+		GET_FUNCTION_NAME_CHECKED(APlayerPhone, Server_AcceptCall),
+		GET_FUNCTION_NAME_CHECKED(APlayerPhone, Server_LeaveCurrentPhoneChannel),
+		TEXT("Server_PlayPhoneAudio"),
+		TEXT("Client_PlayPhoneAudio"),
+		TEXT("Multicast_PlayPhoneAudio"),
+		TEXT("Server_StopPhoneAudio"),
+		TEXT("Multicast_StopPhoneAudio"),
+		TEXT("Client_NotifyLineBusy"),
+		TEXT("Server_ReceivePhoneCall")
+	};
+
+	// RPCs one step of a call should run, every other phone RPC should run zero times
+	struct FExpectedRPCs
+	{
+		const TCHAR* Step;
+		TArray<TPair<FName, int32>> Counts;
+	};
+}
+
+/**
+ * Runs whole phone calls between two bot players on the server and checks the RPCs each step costs:
+ * dialing is the call RPC plus the ringtone multicast, answering is the accept RPC plus the multicast
+ * stopping the ringtone, and hanging up is just the leave RPC since both phones' call state replicates.
+ * Also checks both phones go through Dialing/Ringing, Connected and Ending, and the channel is given back.
+ * Needs OnsetVoip to give every bot player state a talker.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPlayerPhoneCallTest, "QueriesUnlimited.PlayerPhone.CallRPCs",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FPlayerPhoneCallTest::RunTest(const FString& Parameters)
+{
+	using namespace PlayerPhoneCallTest;
+
+	UClass* CharacterClass = ANetworkingPrototypeCharacter::StaticClass();
+	const FString CharacterClassPath = CVarPlayerPhoneCallTestCharacterClass.GetValueOnGameThread();
+	if (!CharacterClassPath.IsEmpty())
+	{
+		CharacterClass = LoadClass<ANetworkingPrototypeCharacter>(nullptr, *CharacterClassPath);
+		if (!CharacterClass)
+		{
+			AddError(FString::Printf(TEXT("Couldn't load character class %s."), *CharacterClassPath));
+			return false;
+		}
+	}
+
+	FQUTestWorld TestWorld;
+	UWorld* World = TestWorld.GetWorld();
+
+	// Both players spawn their own phone on BeginPlay, the C++ character just doesn't have a class for it
+	auto GivePhoneClass = [](ANetworkingPrototypeCharacter* Character)
+	{
+		if (!Character->PlayerPhoneClass)
+		{
+			Character->PlayerPhoneClass = APlayerPhone::StaticClass();
+		}
+	};
+	ANetworkingPrototypeCharacter* Caller = TestWorld.SpawnBotPlayer<ANetworkingPrototypeCharacter>(CharacterClass,
+		FVector(0.0f, 0.0f, 100.0f), FRotator::ZeroRotator, AQUPlayerState::StaticClass(), GivePhoneClass);
+	ANetworkingPrototypeCharacter* Receiver = TestWorld.SpawnBotPlayer<ANetworkingPrototypeCharacter>(CharacterClass,
+		FVector(0.0f, 500.0f, 100.0f), FRotator::ZeroRotator, AQUPlayerState::StaticClass(), GivePhoneClass);
+	if (!Caller || !Receiver)
+	{
+		AddError(TEXT("Couldn't spawn both players."));
+		return false;
+	}
+
+	APlayerState* CallerState = Caller->GetPlayerState();
+	APlayerState* ReceiverState = Receiver->GetPlayerState();
+	APlayerPhone* CallerPhone = Caller->GetPlayerPhone();
+	APlayerPhone* ReceiverPhone = Receiver->GetPlayerPhone();
+	if (!CallerState || !ReceiverState || !CallerPhone || !ReceiverPhone)
+	{
+		AddError(TEXT("Both players need a player state and a phone."));
+		return false;
+	}
+
+	// Calls can't go through without both players' talkers
+	const UOnsetVoipWorldSubsystem* OnsetVoipWorldSubsystem = World->GetSubsystem<UOnsetVoipWorldSubsystem>();
+	if (!OnsetVoipWorldSubsystem || !OnsetVoipWorldSubsystem->GetVoipTalker(CallerState)
+		|| !OnsetVoipWorldSubsystem->GetVoipTalker(ReceiverState))
+	{
+		AddError(TEXT("OnsetVoip has no talker for one of the players, no call can go through."));
+		return false;
+	}
+
+	UPhoneChannelSubsystem* PhoneChannels = World->GetSubsystem<UPhoneChannelSubsystem>();
+	if (!PhoneChannels)
+	{
+		AddError(TEXT("No Phone Channel Subsystem."));
+		return false;
+	}
+	const int32 NumFreeChannels = PhoneChannels->GetNumFreeChannels();
+
+	// Runs one step of a call and checks it ran exactly the RPCs it should have
+	auto RunStep = [this, &TestWorld](const FExpectedRPCs& Expected, TFunctionRef<void()> Step)
+	{
+		FRPCStats::Reset();
+		Step();
+		TestWorld.Tick(FrameSeconds);
+
+		for (const FName& RPC : PhoneRPCs)
+		{
+			const TPair<FName, int32>* ExpectedCount = Expected.Counts.FindByPredicate(
+				[&RPC](const TPair<FName, int32>& Count) { return Count.Key == RPC; });
+
+			TestEqual(FString::Printf(TEXT("%s: %s calls"), Expected.Step, *RPC.ToString()),
+				FRPCStats::Get(RPC).Count, ExpectedCount ? ExpectedCount->Value : 0);
+		}
+	};
+
+	const FExpectedRPCs Dial = { TEXT("Dial"), {
+		{ GET_FUNCTION_NAME_CHECKED(APlayerPhone, Server_CallPlayerByState), 1 },
+		{ TEXT("Multicast_PlayPhoneAudio"), 1 } } };
+	const FExpectedRPCs Answer = { TEXT("Answer"), {
+		{ GET_FUNCTION_NAME_CHECKED(APlayerPhone, Server_AcceptCall), 1 },
+		{ TEXT("Multicast_StopPhoneAudio"), 1 } } };
+	const FExpectedRPCs HangUp = { TEXT("Hang up"), {
+		{ GET_FUNCTION_NAME_CHECKED(APlayerPhone, Server_LeaveCurrentPhoneChannel), 1 } } };
+
+	for (int32 CallIdx = 0; CallIdx < NumCalls; CallIdx++)
+	{
+		RunStep(Dial, [&]() { CallerPhone->Server_CallPlayerByState(ReceiverState, CallerState); });
+		TestTrue(TEXT("Caller phone after dialing"), CallerPhone->GetCallPhase() == E_CallPhase::Dialing);
+		TestTrue(TEXT("Receiver phone after dialing"), ReceiverPhone->GetCallPhase() == E_CallPhase::Ringing);
+		TestEqual(TEXT("Both phones share a channel"), CallerPhone->GetCurrentChannel(), ReceiverPhone->GetCurrentChannel());
+		TestEqual(TEXT("Free channels during the call"), PhoneChannels->GetNumFreeChannels(), NumFreeChannels - 1);
+
+		RunStep(Answer, [&]() { ReceiverPhone->Server_AcceptCall(); });
+		TestTrue(TEXT("Caller phone after answering"), CallerPhone->GetCallPhase() == E_CallPhase::Connected);
+		TestTrue(TEXT("Receiver phone after answering"), ReceiverPhone->GetCallPhase() == E_CallPhase::Connected);
+
+		RunStep(HangUp, [&]() { CallerPhone->Server_LeaveCurrentPhoneChannel(CallerState); });
+		TestTrue(TEXT("Caller phone after hanging up"), CallerPhone->GetCallPhase() == E_CallPhase::Ending);
+		TestTrue(TEXT("Receiver phone after hanging up"), ReceiverPhone->GetCallPhase() == E_CallPhase::Ending);
+		TestEqual(TEXT("Free channels after the call"), PhoneChannels->GetNumFreeChannels(), NumFreeChannels);
+
+		if (HasAnyErrors())
+		{
+			AddError(FString::Printf(TEXT("Call %d didn't go as expected."), CallIdx + 1));
+			break;
+		}
+	}
+
+	FRPCStats::Reset();
+	return !HasAnyErrors();
+}
+
+#endif
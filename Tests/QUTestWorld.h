@@ -0,0 +1,165 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "AIController.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "Templates/Function.h"
+#include "UObject/Package.h"
+
+/**
+ * Throwaway game world for automation tests, created by the constructor and destroyed by the destructor.
+ * It has its world subsystems, an AI system and a game state, and has begun play, but there is no game mode
+ * and no net driver. Everything runs with authority and RPCs run in place.
+ * Nothing moves until the test ticks it.
+ * It's empty unless it's given a map, EX: /Game/Maps/GhostBenchmark, then it's that map with everything saved in it,
+ * its nav mesh included.
+ */
+class FQUTestWorld
+{
+public:
+	explicit FQUTestWorld(const FString& MapPackageName = FString())
+	{
+		if (MapPackageName.IsEmpty())
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("QUTestWorld"));
+		}
+		else
+		{
+			UPackage* MapPackage = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+			World = MapPackage ? UWorld::FindWorldInPackage(MapPackage) : nullptr;
+			if (!World)
+			{
+				return;
+			}
+
+			// Same as a created world, kept around until the destructor destroys it
+			World->WorldType = EWorldType::Game;
+			World->AddToRoot();
+			if (!World->bIsWorldInitialized)
+			{
+				World->InitWorld();
+			}
+		}
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+
+		World->InitializeActorsForPlay(FURL());
+
+		// There's no game mode to spawn a game state and start play, do both ourselves
+		GameState = World->SpawnActor<AGameStateBase>();
+		World->SetGameState(GameState);
+		World->BeginPlay();
+		GameState->HandleBeginPlay();
+	}
+
+	~FQUTestWorld()
+	{
+		if (!World)
+		{
+			return;
+		}
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	FQUTestWorld(const FQUTestWorld&) = delete;
+	FQUTestWorld& operator=(const FQUTestWorld&) = delete;
+
+	// False if the map couldn't be loaded, nothing else can be used then
+	bool IsValid() const { return World != nullptr; }
+
+	UWorld* GetWorld() const { return World; }
+	AGameStateBase* GetGameState() const { return GameState; }
+
+	// Spawns an actor wherever it's asked for, even if it overlaps something
+	template <typename ActorType>
+	ActorType* Spawn(UClass* Class = ActorType::StaticClass(), const FVector& Location = FVector::ZeroVector,
+		const FRotator& Rotation = FRotator::ZeroRotator)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		return World->SpawnActor<ActorType>(Class, Location, Rotation, SpawnParams);
+	}
+
+	// Spawns a pawn for a bot player. It's possessed by an AI controller with a bot player state of PlayerStateClass,
+	// so it shows up in the game state's player array like a real player would.
+	// InitPawn runs on the pawn before it begins play, for setting what its BeginPlay needs.
+	template <typename PawnType>
+	PawnType* SpawnBotPlayer(UClass* Class = PawnType::StaticClass(), const FVector& Location = FVector::ZeroVector,
+		const FRotator& Rotation = FRotator::ZeroRotator, TSubclassOf<APlayerState> PlayerStateClass = APlayerState::StaticClass(),
+		TFunction<void(PawnType*)> InitPawn = nullptr)
+	{
+		return SpawnPossessedPawn<PawnType>(AAIController::StaticClass(), true, Class, Location, Rotation, PlayerStateClass, InitPawn);
+	}
+
+	// Same as SpawnBotPlayer, but possessed by a player controller with no player behind it,
+	// for anything that only reacts to pawns a player controller owns
+	template <typename PawnType>
+	PawnType* SpawnPlayer(UClass* Class = PawnType::StaticClass(), const FVector& Location = FVector::ZeroVector,
+		const FRotator& Rotation = FRotator::ZeroRotator, TSubclassOf<APlayerState> PlayerStateClass = APlayerState::StaticClass(),
+		TFunction<void(PawnType*)> InitPawn = nullptr)
+	{
+		return SpawnPossessedPawn<PawnType>(APlayerController::StaticClass(), false, Class, Location, Rotation, PlayerStateClass, InitPawn);
+	}
+
+	// Moves the world forward NumTicks frames of DeltaSeconds each, timers and tickable subsystems included
+	void Tick(const float DeltaSeconds, const int32 NumTicks = 1)
+	{
+		for (int32 TickIdx = 0; TickIdx < NumTicks; TickIdx++)
+		{
+			GFrameCounter++;
+			World->Tick(LEVELTICK_All, DeltaSeconds);
+		}
+	}
+
+private:
+	// Spawns a pawn possessed by a new controller of ControllerClass with its own player state
+	template <typename PawnType>
+	PawnType* SpawnPossessedPawn(UClass* ControllerClass, const bool bIsBot, UClass* Class, const FVector& Location,
+		const FRotator& Rotation, TSubclassOf<APlayerState> PlayerStateClass, TFunction<void(PawnType*)> InitPawn)
+	{
+		const FTransform Transform(Rotation, Location);
+		PawnType* Pawn = World->SpawnActorDeferred<PawnType>(Class, Transform, nullptr, nullptr,
+			ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+		if (Pawn)
+		{
+			if (InitPawn)
+			{
+				InitPawn(Pawn);
+			}
+			Pawn->FinishSpawning(Transform);
+		}
+
+		AController* Controller = Spawn<AController>(ControllerClass);
+		if (!Pawn || !Controller)
+		{
+			return Pawn;
+		}
+
+		// The pawn picks up the controller's player state when it gets possessed
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.Owner = Controller;
+		APlayerState* PlayerState = World->SpawnActor<APlayerState>(PlayerStateClass, SpawnParams);
+		PlayerState->SetIsABot(bIsBot);
+		Controller->PlayerState = PlayerState;
+		Controller->Possess(Pawn);
+
+		return Pawn;
+	}
+
+	UWorld* World = nullptr;
+	AGameStateBase* GameState = nullptr;
+};
+
+#endif
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "NetworkingPrototype/Tests/QUTestWorld.h"
+#include "NetworkingPrototype/Components/VoiceIntensityComponent.h"
+#include "Math/RandomStream.h"
+
+namespace VoiceIntensityCalibration
+{
+	// 50 ms frames of 16 bit PCM, the same the voice capture hands out
+	constexpr int32 SampleRate = 16000;
+	constexpr int32 FrameSamples = 800;
+
+	// Whole cycles of the tone fit in a frame so every frame of it is exactly as loud
+	constexpr float ToneHz = 220.0f;
+
+	// Background hiss, and the peaks of quiet, normal and loud speech, at a gain of 1
+	constexpr float NoiseAmplitude = 0.005f;
+	constexpr float QuietAmplitude = 0.05f;
+	constexpr float NormalAmplitude = 0.12f;
+	constexpr float LoudAmplitude = 0.3f;
+
+	// A loud mic and one 18 dB quieter
+	const float Gains[] = { 1.0f, 0.125f };
+
+	// Calibrated intensities can be this far apart between gains
+	constexpr float Tolerance = 0.05f;
+
+	// Same noise for every gain so the only difference is the gain
+	constexpr int32 RandomSeed = 1234;
+
+	// Intensities of one frame of each level once calibrated
+	struct FCalibratedIntensities
+	{
+		float Noise = 0.0f;
+		float Quiet = 0.0f;
+		float Normal = 0.0f;
+		float Loud = 0.0f;
+	};
+
+	// Feeds frames of a tone over background noise, all at Gain
+	class FSyntheticMic
+	{
+	public:
+		FSyntheticMic(UVoiceIntensityComponent* InComponent, const float InGain)
+			: Component(InComponent)
+			, Gain(InGain)
+			, Random(RandomSeed)
+		{
+			Samples.SetNumUninitialized(FrameSamples);
+		}
+
+		// Feeds NumFrames of noise plus a tone of ToneAmplitude, 0 for just the noise, and returns the last frame's intensity
+		float Feed(const float ToneAmplitude, const int32 NumFrames = 1)
+		{
+			for (int32 FrameIdx = 0; FrameIdx < NumFrames; FrameIdx++)
+			{
+				for (int32 SampleIdx = 0; SampleIdx < FrameSamples; SampleIdx++)
+				{
+					const float Tone = ToneAmplitude * FMath::Sin(UE_TWO_PI * ToneHz * SampleIdx / SampleRate);
+					const float Noise = Random.FRandRange(-NoiseAmplitude, NoiseAmplitude);
+					Samples[SampleIdx] = static_cast<int16>(FMath::Clamp((Tone + Noise) * Gain * 32767.0f, -32768.0f, 32767.0f));
+				}
+				Component->AnalyzeVoiceFrame(TArrayView<const int16>(Samples), SampleRate);
+			}
+			return Component->GetVoiceIntensity();
+		}
+
+	private:
+		UVoiceIntensityComponent* Component;
+		float Gain;
+		FRandomStream Random;
+		TArray<int16> Samples;
+	};
+}
+
+/**
+ * Checks that the voice intensity calibration gives the same intensity no matter the mic's gain.
+ * Feeds the same synthetic conversation, a tone over background noise, once at full gain and once 18 dB quieter:
+ * a few seconds of silence, then quiet, normal and loud speech with pauses in between.
+ * Then expects noise to be 0, quiet speech under normal under loud, and each level the same at both gains.
+ */
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FVoiceIntensityCalibrationTest, "QueriesUnlimited.VoiceIntensity.CalibrationMatchesAcrossGains",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FVoiceIntensityCalibrationTest::RunTest(const FString& Parameters)
+{
+	using namespace VoiceIntensityCalibration;
+
+	FQUTestWorld TestWorld;
+
+	TArray<FCalibratedIntensities> Results;
+	for (const float Gain : Gains)
+	{
+		// Nothing owns the component, so it never reports to the server
+		AActor* Owner = TestWorld.Spawn<AActor>();
+		UVoiceIntensityComponent* VoiceIntensity = NewObject<UVoiceIntensityComponent>(Owner);
+		VoiceIntensity->RegisterComponent();
+
+		FSyntheticMic Mic(VoiceIntensity, Gain);
+
+		// Six seconds of silence, then a conversation with pauses long enough to learn from
+		Mic.Feed(0.0f, 120);
+		for (int32 Sentence = 0; Sentence < 4; Sentence++)
+		{
+			Mic.Feed(LoudAmplitude, 20);
+			Mic.Feed(0.0f, 10);
+			Mic.Feed(NormalAmplitude, 20);
+			Mic.Feed(0.0f, 10);
+			Mic.Feed(QuietAmplitude, 20);
+			Mic.Feed(0.0f, 10);
+		}
+
+		FCalibratedIntensities& Result = Results.AddDefaulted_GetRef();
+		Result.Noise = Mic.Feed(0.0f);
+		Result.Quiet = Mic.Feed(QuietAmplitude);
+		Result.Normal = Mic.Feed(NormalAmplitude);
+		Result.Loud = Mic.Feed(LoudAmplitude);
+
+		AddInfo(FString::Printf(TEXT("Gain %.3f: noise %.3f, quiet %.3f, normal %.3f, loud %.3f"),
+			Gain, Result.Noise, Result.Quiet, Result.Normal, Result.Loud));
+
+		TestEqual(FString::Printf(TEXT("Gain %.3f noise"), Gain), Result.Noise, 0.0f);
+		TestTrue(FString::Printf(TEXT("Gain %.3f quiet speech is speech"), Gain), Result.Quiet > 0.0f);
+		TestTrue(FString::Printf(TEXT("Gain %.3f normal speech is louder than quiet"), Gain), Result.Normal > Result.Quiet);
+		TestTrue(FString::Printf(TEXT("Gain %.3f loud speech is louder than normal"), Gain), Result.Loud > Result.Normal);
+	}
+
+	// Every gain has to come out the same
+	for (int32 GainIdx = 1; GainIdx < Results.Num(); GainIdx++)
+	{
+		TestEqual(TEXT("Quiet speech across gains"), Results[GainIdx].Quiet, Results[0].Quiet, Tolerance);
+		TestEqual(TEXT("Normal speech across gains"), Results[GainIdx].Normal, Results[0].Normal, Tolerance);
+		TestEqual(TEXT("Loud speech across gains"), Results[GainIdx].Loud, Results[0].Loud, Tolerance);
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -5,42 +5,57 @@
 
 #include "Components/ProgressBar.h"
 #include "Components/TextBlock.h"
+#include "NetworkingPrototype/Components/HoldInteractionComponent.h"
 
 
 void UHoldToInteractWidget::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
 {
 	Super::NativeTick(MyGeometry, InDeltaTime);
 
-	if (InteractableActor && ProgressBar && CurrentNumInteractorsText)
+	if (!InteractableActor || !bIsActorInteractable || !ProgressBar)
 	{
-		// Ensure the InteractableActor implements IInteractableInterface
-		if (bIsActorInteractable)
+		return;
+	}
+
+	// Interactables without a state change event get read again every so often instead of every frame
+	if (!bHasStateChangedEvent)
+	{
+		TimeUntilResync -= InDeltaTime;
+		if (TimeUntilResync <= 0.0f)
 		{
-			// Use the Execute_ functions to call the interface methods
-			float CurrentHeldTime = IInteractableInterface::Execute_GetCurrentHeldTime(InteractableActor);
-			float TotalHoldTime = IInteractableInterface::Execute_GetTotalHoldTime(InteractableActor);
-			float NumCurrentInteractingActors =  IInteractableInterface::Execute_GetCurrentNumInteractors(InteractableActor);
-
-			if (TotalHoldTime > 0) // Avoid division by zero
-			{
-				ProgressBar->SetPercent(CurrentHeldTime / TotalHoldTime);
-			}
-
-			// Convert the NumCurrentInteractingActors float into an int, then into an FString
-			FString InteractorsString = FString::Printf(TEXT("%d"), static_cast<int32>(NumCurrentInteractingActors));
-			
-			// Prepend "x" before the number
-			FString DisplayText = "x" + InteractorsString;
-			
-			// Then into an FText, to then set as the text
-			CurrentNumInteractorsText->SetText(FText::FromString(DisplayText));
+			RefreshHoldState();
 		}
 	}
+
+	// Progress moves at a constant rate between state changes, so move it along ourselves
+	CachedProgress = FMath::Clamp(CachedProgress + CachedProgressRate * InDeltaTime, 0.0f, 1.0f);
+
+	if (CachedProgress != DisplayedPercent)
+	{
+		DisplayedPercent = CachedProgress;
+		ProgressBar->SetPercent(DisplayedPercent);
+	}
+}
+
+void UHoldToInteractWidget::NativeDestruct()
+{
+	UnbindFromInteractable();
+
+	Super::NativeDestruct();
 }
 
 void UHoldToInteractWidget::UpdateInteractableActor(AActor* NewActor)
 {
+	if (NewActor == InteractableActor)
+	{
+		return;
+	}
+
+	UnbindFromInteractable();
+
 	InteractableActor = NewActor;
+	bIsActorInteractable = false;
+	bHasStateChangedEvent = false;
 
 	if (NewActor)
 	{
@@ -48,10 +63,15 @@ void UHoldToInteractWidget::UpdateInteractableActor(AActor* NewActor)
 		{
 			bIsActorInteractable = true;
 		}
-		else
+
+		// Listen for state changes so we only read the interactable when something actually changed
+		if (UHoldInteractionComponent* HoldInteraction = NewActor->FindComponentByClass<UHoldInteractionComponent>())
 		{
-			bIsActorInteractable = false;
+			HoldStateChangedHandle = HoldInteraction->OnHoldStateChanged.AddUObject(this, &UHoldToInteractWidget::RefreshHoldState);
+			bHasStateChangedEvent = true;
 		}
+
+		RefreshHoldState();
 	}
 }
 
@@ -59,3 +79,58 @@ AActor* UHoldToInteractWidget::GetInteractableActor()
 {
 	return InteractableActor;
 }
+
+void UHoldToInteractWidget::RefreshHoldState()
+{
+	TimeUntilResync = ResyncInterval;
+
+	if (!InteractableActor || !bIsActorInteractable)
+	{
+		return;
+	}
+
+	// Use the Execute_ functions to call the interface methods
+	const float CurrentHeldTime = IInteractableInterface::Execute_GetCurrentHeldTime(InteractableActor);
+	const float TotalHoldTime = IInteractableInterface::Execute_GetTotalHoldTime(InteractableActor);
+	const int32 NumCurrentInteractingActors = static_cast<int32>(IInteractableInterface::Execute_GetCurrentNumInteractors(InteractableActor));
+
+	if (TotalHoldTime > 0) // Avoid division by zero
+	{
+		CachedProgress = FMath::Clamp(CurrentHeldTime / TotalHoldTime, 0.0f, 1.0f);
+
+		// Total hold time already accounts for how many players are holding
+		CachedProgressRate = NumCurrentInteractingActors > 0 ? 1.0f / TotalHoldTime : 0.0f;
+	}
+	else
+	{
+		CachedProgress = 0.0f;
+		CachedProgressRate = 0.0f;
+	}
+
+	UpdateNumInteractorsText(NumCurrentInteractingActors);
+}
+
+void UHoldToInteractWidget::UpdateNumInteractorsText(const int32 NewNumInteractors)
+{
+	if (!CurrentNumInteractorsText || NewNumInteractors == CachedNumInteractors)
+	{
+		return;
+	}
+
+	CachedNumInteractors = NewNumInteractors;
+
+	// Prepend "x" before the number
+	CurrentNumInteractorsText->SetText(FText::FromString(FString::Printf(TEXT("x%d"), CachedNumInteractors)));
+}
+
+void UHoldToInteractWidget::UnbindFromInteractable()
+{
+	if (HoldStateChangedHandle.IsValid())
+	{
+		if (UHoldInteractionComponent* HoldInteraction = InteractableActor ? InteractableActor->FindComponentByClass<UHoldInteractionComponent>() : nullptr)
+		{
+			HoldInteraction->OnHoldStateChanged.Remove(HoldStateChangedHandle);
+		}
+		HoldStateChangedHandle.Reset();
+	}
+}
@@ -19,6 +19,9 @@ public:
 	// Called every frame (Tick equivalent for widgets)
 	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
 
+	// Stops listening to the interactable when the widget goes away
+	virtual void NativeDestruct() override;
+
 	// Helper function to update the InteractableActor reference
 	UFUNCTION()
 	void UpdateInteractableActor(AActor* NewActor);
@@ -36,6 +39,14 @@ public:
 	class UTextBlock* CurrentNumInteractorsText;
 	
 private:
+	// Reads the interactable's hold state once and caches it, called whenever the interactable says it changed
+	void RefreshHoldState();
+
+	// Pushes the cached interactor count to the text, only when it changed
+	void UpdateNumInteractorsText(const int32 NewNumInteractors);
+
+	// Stops listening to the current interactable's state changes
+	void UnbindFromInteractable();
 
 	// Reference of the Interactable Actor passed in
 	UPROPERTY()
@@ -43,4 +54,22 @@ private:
 
 	// If the Actor passed in implements IInteractableInterface
 	bool bIsActorInteractable = false;
+
+	// Does the interactable tell us when its hold state changes, otherwise we resync every so often
+	bool bHasStateChangedEvent = false;
+
+	// Handle for our binding to the interactable's state change event
+	FDelegateHandle HoldStateChangedHandle;
+
+	// Cached hold state, progress is extrapolated locally between refreshes
+	float CachedProgress = 0.0f;
+	float CachedProgressRate = 0.0f;
+	int32 CachedNumInteractors = INDEX_NONE;
+
+	// Last percent pushed to the progress bar
+	float DisplayedPercent = -1.0f;
+
+	// How often to resync interactables that don't have a state change event, in seconds
+	float ResyncInterval = 0.25f;
+	float TimeUntilResync = 0.0f;
 };